@@ -0,0 +1,229 @@
+#include "benchharness.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace bench
+{
+    Options Options::parse(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg{ argv[i] };
+            const bool hasNext = i + 1 < argc;
+
+            if (arg == "-h" || arg == "--help")
+            {
+                options.showHelp = true;
+            }
+            else if (arg == "--filter" && hasNext)
+            {
+                options.filter = argv[++i];
+            }
+            else if ((arg == "--out" || arg == "-o") && hasNext)
+            {
+                options.outPath = argv[++i];
+            }
+            else if (arg == "--samples" && hasNext)
+            {
+                options.samples = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (arg == "--min-sample-ms" && hasNext)
+            {
+                options.minSampleTime = std::chrono::milliseconds{ std::max(1, std::atoi(argv[++i])) };
+            }
+            else
+            {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                options.valid = false;
+            }
+        }
+        return options;
+    }
+
+    void Options::printUsage(const char* program, const char* extra)
+    {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --filter <text>       Only run cases whose name contains <text>\n"
+                  << "  -o, --out <file>      Write JSON to <file> instead of stdout\n"
+                  << "  --samples <n>         Timed samples per case (default 15)\n"
+                  << "  --min-sample-ms <n>   Minimum duration of one sample (default 10)\n"
+                  << "  -h, --help            Show this help\n";
+        if (extra != nullptr)
+        {
+            std::cout << extra;
+        }
+    }
+
+    bool Runner::wants(const std::string& name) const
+    {
+        return mOptions.filter.empty() || name.find(mOptions.filter) != std::string::npos;
+    }
+
+    void Runner::run(const std::string& name, const std::function<void()>& op)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        if (!wants(name))
+        {
+            return;
+        }
+
+        auto timeBatch = [&](uint64_t iterations) {
+            const auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                op();
+            }
+            return Clock::now() - start;
+        };
+
+        // Warm up, then double the batch until one sample is long enough for
+        // the clock resolution not to matter
+        op();
+        uint64_t iterations = 1;
+        while (timeBatch(iterations) < mOptions.minSampleTime && iterations < (1ull << 32))
+        {
+            iterations *= 2;
+        }
+
+        std::vector<double> perOp;
+        perOp.reserve(static_cast<size_t>(mOptions.samples));
+        for (int s = 0; s < mOptions.samples; ++s)
+        {
+            const auto elapsed = std::chrono::duration<double, std::nano>(timeBatch(iterations)).count();
+            perOp.push_back(elapsed / static_cast<double>(iterations));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.samples = mOptions.samples;
+        result.minNs = perOp.front();
+        result.maxNs = perOp.back();
+        result.medianNs = perOp[perOp.size() / 2];
+        result.meanNs = std::accumulate(perOp.begin(), perOp.end(), 0.0) / static_cast<double>(perOp.size());
+        mResults.push_back(result);
+
+        // Progress goes to stderr so stdout stays valid JSON
+        std::fprintf(stderr, "%-56s %12.1f ns/op (min %.1f)\n", name.c_str(), result.medianNs, result.minNs);
+    }
+
+    void Runner::skip(const std::string& name, const std::string& reason)
+    {
+        if (wants(name))
+        {
+            mSkipped.emplace_back(name, reason);
+            std::fprintf(stderr, "%-56s skipped: %s\n", name.c_str(), reason.c_str());
+        }
+    }
+
+    void Runner::addContext(const std::string& key, const std::string& value)
+    {
+        mContext.emplace_back(key, value);
+    }
+
+    void Runner::writeJson(std::ostream& out) const
+    {
+        out << "{\n  \"context\": {";
+        for (size_t i = 0; i < mContext.size(); ++i)
+        {
+            out << (i ? ",\n" : "\n") << "    " << quote(mContext[i].first) << ": " << quote(mContext[i].second);
+        }
+        out << "\n  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < mResults.size(); ++i)
+        {
+            const Result& r = mResults[i];
+            out << (i ? ",\n" : "\n")
+                << "    { \"name\": " << quote(r.name)
+                << ", \"iterations\": " << r.iterations
+                << ", \"samples\": " << r.samples
+                << ", \"min_ns\": " << r.minNs
+                << ", \"median_ns\": " << r.medianNs
+                << ", \"mean_ns\": " << r.meanNs
+                << ", \"max_ns\": " << r.maxNs << " }";
+        }
+        out << "\n  ],\n  \"skipped\": [";
+        for (size_t i = 0; i < mSkipped.size(); ++i)
+        {
+            out << (i ? ",\n" : "\n")
+                << "    { \"name\": " << quote(mSkipped[i].first) << ", \"reason\": " << quote(mSkipped[i].second) << " }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    bool Runner::writeJson() const
+    {
+        if (mOptions.outPath.empty())
+        {
+            writeJson(std::cout);
+            return true;
+        }
+
+        std::ofstream file{ mOptions.outPath };
+        if (!file)
+        {
+            std::cerr << "Cannot write " << mOptions.outPath << std::endl;
+            return false;
+        }
+        writeJson(file);
+        return static_cast<bool>(file);
+    }
+
+    std::string quote(const std::string& text)
+    {
+        std::string out{ "\"" };
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+        return out;
+    }
+
+    ScratchConfig::ScratchConfig(const std::string& suite, const std::filesystem::path& defaultConfig)
+    {
+        namespace fs = std::filesystem;
+        const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+        std::error_code error;
+        mDirectory = fs::temp_directory_path(error) / (suite + "_" + std::to_string(ticks));
+        fs::create_directories(mDirectory, error);
+        mPath = (mDirectory / "config.ini").string();
+
+        // Without the copy Config writes its built-in defaults here instead
+        if (!fs::copy_file(defaultConfig, mPath, fs::copy_options::overwrite_existing, error))
+        {
+            std::cerr << "Can't copy " << defaultConfig.string() << " (" << error.message()
+                      << "), benchmarking Config's built-in defaults" << std::endl;
+        }
+    }
+
+    ScratchConfig::~ScratchConfig()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(mDirectory, error);
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef PADCAST_BENCHHARNESS_H
+#define PADCAST_BENCHHARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark runner for the padcast_bench targets. Each case is
+// calibrated until one sample takes at least mMinSampleTime, then timed for
+// mSamples samples; per-op min/median/mean/max are reported so a noisy
+// machine shows up as a spread rather than a wrong number.
+//
+//     bench::Runner runner{ options };
+//     runner.run("Config::getValue (hit)", [&] {
+//         bench::doNotOptimize(config.getValue("Window", "TARGET_FPS"));
+//     });
+//     runner.writeJson(std::cout);
+namespace bench
+{
+	// Keeps the compiler from deleting work whose result is otherwise unused
+	template <typename T>
+	inline void doNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	struct Options
+	{
+		std::string filter{};     // only run cases whose name contains this
+		std::string outPath{};    // empty = stdout
+		int samples{ 15 };
+		std::chrono::milliseconds minSampleTime{ 10 };
+		bool valid{ true };
+		bool showHelp{ false };
+
+		static Options parse(int argc, char** argv);
+		static void printUsage(const char* program, const char* extra = nullptr);
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations{};    // per sample
+		int samples{};
+		double minNs{};
+		double medianNs{};
+		double meanNs{};
+		double maxNs{};
+	};
+
+	class Runner
+	{
+	public:
+		explicit Runner(const Options& options) : mOptions(options) {}
+
+		bool wants(const std::string& name) const;
+		// Runs op repeatedly; op should do exactly one unit of the thing being measured
+		void run(const std::string& name, const std::function<void()>& op);
+		// For cases that can't run in this environment; shows up in the JSON with a reason
+		void skip(const std::string& name, const std::string& reason);
+
+		// Free-form key/values written under "context"
+		void addContext(const std::string& key, const std::string& value);
+
+		void writeJson(std::ostream& out) const;
+		// Writes to Options::outPath, or stdout if none was given
+		bool writeJson() const;
+
+		const std::vector<Result>& getResults() const { return mResults; }
+
+	private:
+		Options mOptions;
+		std::vector<Result> mResults;
+		std::vector<std::pair<std::string, std::string>> mSkipped;
+		std::vector<std::pair<std::string, std::string>> mContext;
+	};
+
+	// JSON string literal, quotes included
+	std::string quote(const std::string& text);
+
+	// Copy of the shipped default config.ini in a fresh temporary directory, so a
+	// benchmark's Config neither depends on nor rewrites the user's own. The
+	// directory is removed on destruction, so declare this before the Config
+	// that uses it (Config saves when it's destroyed).
+	class ScratchConfig
+	{
+	public:
+		ScratchConfig(const std::string& suite, const std::filesystem::path& defaultConfig);
+		~ScratchConfig();
+
+		ScratchConfig(const ScratchConfig&) = delete;
+		ScratchConfig& operator=(const ScratchConfig&) = delete;
+
+		const std::string& getPath() const { return mPath; }
+
+	private:
+		std::filesystem::path mDirectory;
+		std::string mPath;
+	};
+}
+
+#endif
@@ -0,0 +1,172 @@
+// padcast_bench: microbenchmarks for the config and per-frame CPU paths.
+//
+// Writes JSON to stdout (or --out <file>); progress lines go to stderr.
+// The PadCast cases need a GL context for the button textures, so a hidden
+// window is opened for them. On a headless machine they're reported under
+// "skipped" instead -- run under Xvfb to get them.
+
+#ifdef _WIN32
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+    #undef NOGDI
+    #undef NOUSER
+#endif
+
+#include "benchharness.h"
+#include "PadCast.h"
+#include "config.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace
+{
+    void benchConfig(bench::Runner& runner, Config& config)
+    {
+        runner.run("Config::getValue (hit)", [&] {
+            bench::doNotOptimize(config.getValue("Window", "TARGET_FPS"));
+        });
+        runner.run("Config::hasValue (hit)", [&] {
+            bench::doNotOptimize(config.hasValue("Window", "TARGET_FPS"));
+        });
+        runner.run("Config::hasValue (missing key)", [&] {
+            bench::doNotOptimize(config.hasValue("Window", "NO_SUCH_KEY"));
+        });
+        runner.run("Config::hasValue (missing section)", [&] {
+            bench::doNotOptimize(config.hasValue("NoSuchSection", "TARGET_FPS"));
+        });
+        // Every key is present and in range, so this never saves
+        runner.run("Config::validateConfig", [&] {
+            config.validateConfig();
+        });
+    }
+
+    // Done on a scratch copy so the benchmark never rewrites the real config.ini
+    void benchINI(bench::Runner& runner, const Config& config)
+    {
+        const auto scratch = std::filesystem::temp_directory_path() / "padcast_bench.ini";
+        mINI::INIFile file{ scratch.string() };
+        mINI::INIStructure ini = config.getIni();
+        if (!file.generate(ini))
+        {
+            runner.skip("mINI read", "cannot write " + scratch.string());
+            runner.skip("mINI write", "cannot write " + scratch.string());
+            return;
+        }
+
+        runner.run("mINI read", [&] {
+            mINI::INIStructure loaded;
+            bench::doNotOptimize(file.read(loaded));
+        });
+        // write() re-reads the file to preserve its layout, same as Config::saveConfig
+        runner.run("mINI write", [&] {
+            bench::doNotOptimize(file.write(ini));
+        });
+
+        std::error_code ec;
+        std::filesystem::remove(scratch, ec);
+    }
+
+    void benchButtons(bench::Runner& runner)
+    {
+        ButtonMap map;
+        map.buttonIndex = map.defaultSNESIndex;
+        CachedButtons cache;
+        runner.run("CachedButtons::refreshCache", [&] {
+            cache.refreshCache(map);
+            bench::doNotOptimize(cache);
+        });
+    }
+
+    void benchScaling(bench::Runner& runner, const Config& config)
+    {
+        const int canvasW = config.getImgCanvasWidth();
+        const int canvasH = config.getImgCanvasHeight();
+        int width = 960;
+        runner.run("ScalingInfo construction", [&] {
+            // Vary the input a little so the division isn't hoisted out of the loop
+            width = width == 960 ? 1921 : 960;
+            ScalingInfo scaling{ width, 540, canvasW, canvasH };
+            bench::doNotOptimize(scaling);
+        });
+    }
+
+    void benchPadCast(bench::Runner& runner, Config& config)
+    {
+        const char* names[] = {
+            "PadCast::loadButtonsFromConfig",
+            "PadCast::getBGColor (cache valid)",
+            "PadCast::getBGColor (cache invalid)",
+        };
+
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(config.getInitWinWidth(), config.getInitWinHeight(), "padcast_bench");
+        if (!IsWindowReady())
+        {
+            for (const char* name : names)
+            {
+                runner.skip(name, "no window/GL context available");
+            }
+            return;
+        }
+
+        {
+            auto padCast = std::make_unique<PadCast>(config);
+
+            runner.run(names[0], [&] {
+                padCast->loadButtonsFromConfig();
+            });
+            runner.run(names[1], [&] {
+                bench::doNotOptimize(padCast->getBGColor());
+            });
+            // What the first frame after a menu change pays: four config lookups plus the palette check
+            runner.run(names[2], [&] {
+                padCast->invalidateBGCache();
+                bench::doNotOptimize(padCast->getBGColor());
+            });
+        }
+
+        CloseWindow();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bench::Options options = bench::Options::parse(argc, argv);
+    if (options.showHelp || !options.valid)
+    {
+        bench::Options::printUsage(argv[0]);
+        return options.valid ? 0 : 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    bench::Runner runner{ options };
+    runner.addContext("suite", "padcast_bench");
+#ifdef NDEBUG
+    runner.addContext("build", "release");
+#else
+    runner.addContext("build", "debug");
+#endif
+
+    // Every case runs against a copy of the shipped config, not the user's
+    bench::ScratchConfig scratchConfig{ "padcast_bench", PADCAST_DEFAULT_CONFIG };
+    Config config{ scratchConfig.getPath() };
+    runner.addContext("config_path", config.getConfigFilePath());
+
+    benchConfig(runner, config);
+    benchINI(runner, config);
+    benchButtons(runner);
+    benchScaling(runner, config);
+    benchPadCast(runner, config);
+
+    return runner.writeJson() ? 0 : 1;
+}
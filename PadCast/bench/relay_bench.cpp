@@ -0,0 +1,239 @@
+// padcast_relay_bench: cost of the UDP pad relay (padrelay.h) over loopback
+// -- encoding and decoding a packet, and the full path from Sender::publish()
+// to the Receiver having applied the state, which is the relay's share of
+// the latency on a LAN minus the wire time.
+//
+// Also checks the redundancy: a forwarder between sender and receiver drops
+// packets (every other one, and bursts of three), and the number of quick
+// taps that didn't show on their frame goes into the JSON context (it should
+// be 0).
+//
+//     ./padcast_relay_bench --out relay.json
+
+#include "benchharness.h"
+#include "padrelay.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    const char* const kUsageExtra =
+        "\nSends UDP over 127.0.0.1 (ports 18766-18767); Linux only.\n";
+
+    constexpr int kReceiverPort{ 18766 };
+    constexpr int kForwarderPort{ 18767 };
+
+#ifdef __linux__
+    // Passes packets from kForwarderPort to kReceiverPort, dropping the ones
+    // dropPacket(n) says to
+    template <typename DropPacket>
+    class LossyForwarder
+    {
+    public:
+        explicit LossyForwarder(DropPacket dropPacket)
+            : mDropPacket{ dropPacket }
+        {
+            mIn = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            mOut = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(kForwarderPort);
+            mReady = bind(mIn, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+            address.sin_port = htons(kReceiverPort);
+            mReady = mReady && connect(mOut, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+            timeval timeout{ 0, 20000 };
+            setsockopt(mIn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            mThread = std::thread{ [this] { forward(); } };
+        }
+
+        ~LossyForwarder()
+        {
+            mStop.store(true);
+            mThread.join();
+            close(mIn);
+            close(mOut);
+        }
+
+        bool isReady() const { return mReady; }
+
+    private:
+        void forward()
+        {
+            uint8_t buffer[padrelay::kMaxPacketBytes];
+            uint64_t count = 0;
+            while (!mStop.load())
+            {
+                const ssize_t size = recv(mIn, buffer, sizeof(buffer), 0);
+                if (size > 0 && !mDropPacket(count++))
+                {
+                    send(mOut, buffer, static_cast<size_t>(size), 0);
+                }
+            }
+        }
+
+        DropPacket mDropPacket;
+        int mIn{ -1 };
+        int mOut{ -1 };
+        bool mReady{ false };
+        std::atomic<bool> mStop{ false };
+        std::thread mThread;
+    };
+
+    // Taps a button presses times through a lossy path, each press and release
+    // between two frames, and counts the taps that didn't show on their frame
+    template <typename DropPacket>
+    uint64_t missedPresses(DropPacket dropPacket, int presses, padrelay::ReceiverStats& stats)
+    {
+        LossyForwarder<DropPacket> forwarder{ dropPacket };
+        padrelay::Sender sender;
+        padrelay::Receiver receiver;
+        std::string error;
+        if (!forwarder.isReady() || !sender.open("127.0.0.1:" + std::to_string(kForwarderPort), error)
+            || !receiver.open("127.0.0.1:" + std::to_string(kReceiverPort), error))
+        {
+            return static_cast<uint64_t>(presses);
+        }
+
+        PadState pad;
+        pad.gamepad = 0;
+        uint64_t missed = 0;
+        // The daemon's loop: the pad is read (and given to the sender) about
+        // every millisecond, here every 300 us, then the frame samples
+        const auto settle = [&] {
+            for (int poll = 0; poll < padrelay::kRepeats + 1; ++poll)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(300));
+                sender.publish(true, pad, "Bench Pad");
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+            receiver.update();
+        };
+        sender.publish(true, pad, "Bench Pad");
+        settle();
+        for (int i = 0; i < presses; ++i)
+        {
+            // Press and release both land before the frame samples
+            pad.buttons = 1u << 7;
+            sender.publish(true, pad, "Bench Pad");
+            pad.buttons = 0;
+            sender.publish(true, pad, "Bench Pad");
+            settle();
+            if ((receiver.sample(0).buttons & (1u << 7)) == 0)
+            {
+                ++missed;
+            }
+        }
+        stats = receiver.getStats();
+        return missed;
+    }
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    const bench::Options options = bench::Options::parse(argc, argv);
+    if (options.showHelp || !options.valid)
+    {
+        bench::Options::printUsage(argv[0], kUsageExtra);
+        return options.valid ? 0 : 1;
+    }
+
+    bench::Runner runner{ options };
+    runner.addContext("suite", "padcast_relay_bench");
+#ifdef NDEBUG
+    runner.addContext("build", "release");
+#else
+    runner.addContext("build", "debug");
+#endif
+
+    // Wire format alone
+    {
+        padrelay::Packet packet;
+        packet.session = 0x12345678;
+        packet.name = "Bench Pad";
+        packet.stateCount = padrelay::kRedundancy;
+        for (size_t i = 0; i < padrelay::kRedundancy; ++i)
+        {
+            packet.states[i].sequence = static_cast<uint32_t>(100 - i);
+            packet.states[i].connected = true;
+            packet.states[i].buttons = 1u << i;
+            packet.states[i].axes = { 0.5f, -0.25f, 0.0f, 0.0f, -1.0f, -1.0f };
+        }
+        uint8_t buffer[padrelay::kMaxPacketBytes];
+        const size_t size = padrelay::encode(packet, buffer);
+        runner.addContext("packet_bytes", std::to_string(size));
+        runner.run("encode packet", [&] {
+            bench::doNotOptimize(padrelay::encode(packet, buffer));
+        });
+        padrelay::Packet decoded;
+        runner.run("decode packet", [&] {
+            bench::doNotOptimize(padrelay::decode(buffer, size, decoded));
+        });
+    }
+
+#ifdef __linux__
+    // Publish a change, then spin until the receiver has applied it
+    {
+        padrelay::Sender sender;
+        padrelay::Receiver receiver;
+        std::string error;
+        if (receiver.open("127.0.0.1:" + std::to_string(kReceiverPort), error)
+            && sender.open("127.0.0.1:" + std::to_string(kReceiverPort), error))
+        {
+            PadState pad;
+            pad.gamepad = 0;
+            runner.run("loopback publish to applied", [&] {
+                pad.buttons ^= 1u << 6;
+                sender.publish(true, pad, "Bench Pad");
+                const uint64_t before = receiver.getStats().states;
+                while (receiver.getStats().states == before)
+                {
+                    receiver.receive();
+                }
+            });
+            runner.run("receiver poll, nothing new", [&] {
+                receiver.receive();
+            });
+            runner.run("sender publish, unchanged", [&] {
+                sender.publish(true, pad, "Bench Pad");
+            });
+            runner.addContext("last_transit_us", std::to_string(receiver.getStats().lastTransitUs));
+        }
+        else
+        {
+            runner.skip("loopback", error);
+        }
+    }
+
+    // Redundancy: taps that both press and release between two frames, over a lossy path
+    {
+        constexpr int kPresses{ 200 };
+        padrelay::ReceiverStats stats;
+        const uint64_t everyOther = missedPresses([](uint64_t n) { return n % 2 == 1; }, kPresses, stats);
+        runner.addContext("loss_every_other_missed_presses", std::to_string(everyOther) + "/" + std::to_string(kPresses));
+        runner.addContext("loss_every_other_recovered_states", std::to_string(stats.recovered));
+        const uint64_t bursts = missedPresses([](uint64_t n) { return n % 8 >= 5; }, kPresses, stats);
+        runner.addContext("loss_bursts_of_3_missed_presses", std::to_string(bursts) + "/" + std::to_string(kPresses));
+        runner.addContext("loss_bursts_of_3_recovered_states", std::to_string(stats.recovered));
+        std::fprintf(stderr, "Missed presses with packet loss: every other %llu/%d, bursts of 3 %llu/%d\n",
+                     static_cast<unsigned long long>(everyOther), kPresses,
+                     static_cast<unsigned long long>(bursts), kPresses);
+    }
+#else
+    runner.skip("loopback", "Linux only");
+#endif
+
+    return runner.writeJson() ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+// padcast_render_bench: frame cost of the real draw path at several output
+// sizes, with no display or gamepad needed.
+//
+// Each case renders one full frame -- clear, drawGamepadButtons, and
+// optionally the open menu -- into an offscreen render texture of the given
+// size, then waits on glFinish so the GPU (or llvmpipe) side is included.
+// The "No Gamepad" text and a menu panel re-render are timed separately.
+// Button states are synthetic, so the numbers are repeatable.
+//
+// On a GPU-less box:
+//     LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./padcast_render_bench --out render.json
+
+#ifdef _WIN32
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+    #undef NOGDI
+    #undef NOUSER
+#endif
+
+#include "benchharness.h"
+#include "glfwbridge.h"
+#include "menus.h"
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+    #define PADCAST_GLAPI __stdcall
+#else
+    #define PADCAST_GLAPI
+#endif
+
+namespace
+{
+    constexpr unsigned int GL_RENDERER_ID{ 0x1F01 };
+
+    using FinishFn = void (PADCAST_GLAPI*)();
+    using GetStringFn = const unsigned char* (PADCAST_GLAPI*)(unsigned int);
+
+    struct Resolution
+    {
+        const char* name;
+        int width;
+        int height;
+    };
+
+    constexpr std::array<Resolution, 4> kResolutions{ {
+        { "480x270", 480, 270 },
+        { "960x540", 960, 540 },
+        { "1920x1080", 1920, 1080 },
+        { "3840x2160", 3840, 2160 },
+    } };
+
+    constexpr std::array<int, 4> kHeldCounts{ 0, 1, 4, 12 };
+
+    // Every button the default SNES map draws, A first so "1 held" is the common case
+    constexpr std::array<int, 12> kHoldOrder{
+        GAMEPAD_BUTTON_RIGHT_FACE_RIGHT, GAMEPAD_BUTTON_RIGHT_FACE_DOWN,
+        GAMEPAD_BUTTON_RIGHT_FACE_UP, GAMEPAD_BUTTON_RIGHT_FACE_LEFT,
+        GAMEPAD_BUTTON_LEFT_FACE_UP, GAMEPAD_BUTTON_LEFT_FACE_RIGHT,
+        GAMEPAD_BUTTON_LEFT_FACE_DOWN, GAMEPAD_BUTTON_LEFT_FACE_LEFT,
+        GAMEPAD_BUTTON_LEFT_TRIGGER_1, GAMEPAD_BUTTON_RIGHT_TRIGGER_1,
+        GAMEPAD_BUTTON_MIDDLE_LEFT, GAMEPAD_BUTTON_MIDDLE_RIGHT,
+    };
+
+    PadState makePad(int held)
+    {
+        PadState pad;
+        pad.gamepad = 0;
+        for (int i = 0; i < held; ++i)
+        {
+            pad.buttons |= 1u << kHoldOrder[i];
+        }
+        return pad;
+    }
+
+    const char* const kUsageExtra =
+        "\nRenders into offscreen targets; needs a GL 3.3 context (Xvfb + Mesa llvmpipe is fine).\n";
+}
+
+int main(int argc, char** argv)
+{
+    const bench::Options options = bench::Options::parse(argc, argv);
+    if (options.showHelp || !options.valid)
+    {
+        bench::Options::printUsage(argv[0], kUsageExtra);
+        return options.valid ? 0 : 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    bench::Runner runner{ options };
+    runner.addContext("suite", "padcast_render_bench");
+#ifdef NDEBUG
+    runner.addContext("build", "release");
+#else
+    runner.addContext("build", "debug");
+#endif
+
+    // A copy of the shipped config, so the user's settings don't skew the
+    // numbers and the benchmark never rewrites them
+    bench::ScratchConfig scratchConfig{ "padcast_render_bench", PADCAST_DEFAULT_CONFIG };
+    Config config{ scratchConfig.getPath() };
+    runner.addContext("config_path", config.getConfigFilePath());
+
+    // The window only provides the context; nothing is drawn to it
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(320, 180, "padcast_render_bench");
+    if (!IsWindowReady())
+    {
+        std::fprintf(stderr, "No GL context available (try xvfb-run)\n");
+        runner.skip("render", "no window/GL context available");
+        runner.writeJson();
+        return 1;
+    }
+
+    const auto glFinishPtr = reinterpret_cast<FinishFn>(glfwGetProcAddress("glFinish"));
+    const auto glGetStringPtr = reinterpret_cast<GetStringFn>(glfwGetProcAddress("glGetString"));
+    if (glGetStringPtr != nullptr)
+    {
+        const unsigned char* renderer = glGetStringPtr(GL_RENDERER_ID);
+        runner.addContext("gl_renderer", renderer ? reinterpret_cast<const char*>(renderer) : "unknown");
+    }
+
+    {
+        auto padCast = std::make_unique<PadCast>(config);
+        // Synthetic states assume the stock mapping; doesn't touch config.ini
+        padCast->resetButtonsToDefault();
+
+        MenuContext menu;
+        const int canvasW = config.getImgCanvasWidth();
+        const int canvasH = config.getImgCanvasHeight();
+
+        for (const Resolution& res : kResolutions)
+        {
+            RenderTexture2D target = LoadRenderTexture(res.width, res.height);
+            const ScalingInfo scaling{ res.width, res.height, canvasW, canvasH };
+            padCast->invalidateTextCache();
+
+            auto finish = [&] {
+                if (glFinishPtr != nullptr)
+                {
+                    glFinishPtr();
+                }
+            };
+
+            for (const bool menuOpen : { false, true })
+            {
+                menu.active = menuOpen ? Menu::Main : Menu::None;
+                menu.invalidateLayout();
+                // DrawMenu re-renders its cached panel with its own texture mode when the
+                // layout changes; do that here so the timed frames measure the steady state
+                if (menuOpen)
+                {
+                    DrawMenu(menu, scaling, config, padCast->getTextCache());
+                }
+
+                for (const int held : kHeldCounts)
+                {
+                    char name[96];
+                    std::snprintf(name, sizeof(name), "frame %s, %d held%s",
+                        res.name, held, menuOpen ? ", menu open" : "");
+
+                    const PadState pad = makePad(held);
+                    runner.run(name, [&] {
+                        BeginTextureMode(target);
+                        ClearBackground(padCast->getBGColor());
+                        padCast->drawGamepadButtons(pad, scaling);
+                        DrawMenu(menu, scaling, config, padCast->getTextCache());
+                        EndTextureMode();
+                        finish();
+                    });
+                }
+            }
+
+            runner.run(std::string{ "frame " } + res.name + ", no gamepad message", [&] {
+                BeginTextureMode(target);
+                ClearBackground(padCast->getBGColor());
+                padCast->drawNoGamepadMessage(scaling);
+                EndTextureMode();
+                finish();
+            });
+
+            // What a selection change costs: the menu's text is re-rendered into its panel.
+            // DrawMenu manages its own texture mode for this, so it's timed on its own.
+            menu.active = Menu::Main;
+            runner.run(std::string{ "menu panel redraw " } + res.name, [&] {
+                menu.panel.dirty = true;
+                DrawMenu(menu, scaling, config, padCast->getTextCache());
+                finish();
+            });
+
+            UnloadRenderTexture(target);
+        }
+    }
+
+    CloseWindow();
+    return runner.writeJson() ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+// padcast_shm_bench: cost of the shared-memory frame ring (shmframes.h)
+// without a GPU -- how long publishing a frame takes at several sizes, what
+// a reader pays to pick one up in place, and the publish-to-wake latency of a
+// reader sleeping in FUTEX_WAIT on another thread. Also the per-frame cost of
+// the shared pad state (padshm.h) on both sides.
+//
+// Publishing includes the one copy PadCast makes (mapped pixel buffer into
+// the slot, flipped), so it's the per-frame cost the render loop sees.
+//
+//     ./padcast_shm_bench --out shm.json
+
+#include "benchharness.h"
+#include "padshm.h"
+#include "shmframes.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    struct Resolution
+    {
+        const char* name;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    constexpr std::array<Resolution, 3> kResolutions{ {
+        { "480x270", 480, 270 },
+        { "1920x1080", 1920, 1080 },
+        { "3840x2160", 3840, 2160 },
+    } };
+
+    const char* const kUsageExtra =
+        "\nCreates shared-memory rings named padcast-shm-bench-<pid>; Linux only.\n";
+
+    // What VideoOutput::publishFrame does with a mapped bottom-up readback
+    void publishFlipped(shmframes::Writer& writer, const std::vector<uint8_t>& source)
+    {
+        const size_t stride = writer.getStride();
+        const uint32_t height = writer.getHeight();
+        const uint8_t* lastRow = source.data() + stride * (height - 1);
+        uint8_t* out = writer.beginFrame();
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            std::memcpy(out + stride * y, lastRow - stride * y, stride);
+        }
+        writer.endFrame();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bench::Options options = bench::Options::parse(argc, argv);
+    if (options.showHelp || !options.valid)
+    {
+        bench::Options::printUsage(argv[0], kUsageExtra);
+        return options.valid ? 0 : 1;
+    }
+
+    bench::Runner runner{ options };
+    runner.addContext("suite", "padcast_shm_bench");
+#ifdef NDEBUG
+    runner.addContext("build", "release");
+#else
+    runner.addContext("build", "debug");
+#endif
+
+#ifdef __linux__
+    const std::string name{ "padcast-shm-bench-" + std::to_string(getpid()) };
+
+    for (const Resolution& res : kResolutions)
+    {
+        shmframes::Writer writer;
+        std::string createError;
+        if (!writer.create(name, res.width, res.height, 60, 1, createError))
+        {
+            runner.skip(std::string{ "publish " } + res.name, createError);
+            continue;
+        }
+        std::vector<uint8_t> source(static_cast<size_t>(res.width) * res.height * 4, 0x5a);
+        runner.addContext(std::string{ "frame_bytes_" } + res.name, std::to_string(source.size()));
+
+        runner.run(std::string{ "publish " } + res.name, [&] {
+            publishFlipped(writer, source);
+        });
+
+        // In place: no copy, just locate the newest frame, touch it and recheck
+        shmframes::Reader reader;
+        std::string error;
+        if (!reader.open(name, error))
+        {
+            runner.skip(std::string{ "read in place " } + res.name, error);
+            continue;
+        }
+        runner.run(std::string{ "read in place " } + res.name, [&] {
+            shmframes::Reader::Frame frame;
+            if (reader.latest(frame))
+            {
+                bench::doNotOptimize(frame.pixels[0]);
+                bench::doNotOptimize(reader.stillValid(frame));
+            }
+        });
+    }
+
+    // Publish, then wait until a reader thread blocked in FUTEX_WAIT has
+    // woken and seen it: the handoff latency a capture client gets
+    {
+        shmframes::Writer writer;
+        shmframes::Reader reader;
+        std::string error;
+        if (writer.create(name, 480, 270, 60, 1, error) && reader.open(name, error))
+        {
+            std::vector<uint8_t> source(static_cast<size_t>(480) * 270 * 4, 0x5a);
+            std::atomic<uint64_t> seen{ 0 };
+            std::thread consumer{ [&] {
+                uint64_t after = 0;
+                while (reader.waitForFrame(after, -1))
+                {
+                    shmframes::Reader::Frame frame;
+                    if (reader.latest(frame))
+                    {
+                        after = frame.frame + 1;
+                        seen.store(after, std::memory_order_release);
+                    }
+                }
+            } };
+
+            uint64_t published = 0;
+            runner.run("publish to reader wake 480x270", [&] {
+                publishFlipped(writer, source);
+                ++published;
+                while (seen.load(std::memory_order_acquire) < published)
+                {
+                }
+            });
+
+            // Closing wakes the consumer with waitForFrame() == false
+            writer.close();
+            consumer.join();
+        }
+        else
+        {
+            runner.skip("publish to reader wake 480x270", "can't create shared memory");
+        }
+    }
+
+    // Pad state: what the render loop pays per frame, and what each reader pays per poll
+    {
+        padshm::Writer writer;
+        padshm::Reader reader;
+        std::string error;
+        if (writer.create(name + "-pad", error) && reader.open(name + "-pad", error))
+        {
+            const std::array<float, padshm::kAxisCount> axes{ 0.5f, -0.25f, 0.0f, 0.0f, -1.0f, -1.0f };
+            uint32_t buttons = 0;
+            runner.run("pad state publish", [&] {
+                buttons ^= 1u << 6;
+                writer.publish(true, 0, buttons, buttons, axes, "Bench Pad");
+            });
+            runner.run("pad state read", [&] {
+                padshm::Snapshot pad;
+                bench::doNotOptimize(reader.read(pad));
+                bench::doNotOptimize(pad.logicalButtons);
+            });
+
+            // Reads racing a writer that publishes flat out on another thread
+            std::atomic<bool> stop{ false };
+            std::thread publisher{ [&] {
+                uint32_t held = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    ++held;
+                    writer.publish(true, 0, held, held, axes, "Bench Pad");
+                }
+            } };
+            runner.run("pad state read, contended", [&] {
+                padshm::Snapshot pad;
+                bench::doNotOptimize(reader.read(pad));
+                bench::doNotOptimize(pad.logicalButtons);
+            });
+            stop.store(true);
+            publisher.join();
+        }
+        else
+        {
+            runner.skip("pad state", "can't create shared memory");
+        }
+    }
+#else
+    runner.skip("shared-memory frames", "Linux only");
+    std::fprintf(stderr, "Shared-memory frames are Linux only\n");
+#endif
+
+    return runner.writeJson() ? 0 : 1;
+}
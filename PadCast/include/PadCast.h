@@ -17,7 +17,11 @@
 
 #include <raylib-cpp.hpp>
 #include "config.h"
-#include <unordered_map>
+#include "textcache.h"
+#include "padstate.h"
+#include "padmapper.h"
+
+#include <array>
 
 struct GamepadTextures
 {
@@ -35,7 +39,27 @@ struct GamepadTextures
 	raylib::Texture2D pressedLBump;
 	raylib::Texture2D pressedRBump;
 
+	static constexpr size_t kCount{ 13 };
+	// Under resources/, in at() order
+	static constexpr std::array<const char*, kCount> kFiles{
+		"images/controller.png", "images/pressed/A.png", "images/pressed/B.png", "images/pressed/X.png",
+		"images/pressed/Y.png", "images/pressed/up.png", "images/pressed/left.png", "images/pressed/down.png",
+		"images/pressed/right.png", "images/pressed/start.png", "images/pressed/select.png",
+		"images/pressed/L-bumper.png", "images/pressed/R-bumper.png"
+	};
+
 	GamepadTextures();
+
+	// The textures above by index, for reloading them one at a time
+	raylib::Texture2D& at(size_t index);
+	const raylib::Texture2D& at(size_t index) const;
+
+	// GPU memory held by all of the above
+	size_t memoryBytes() const;
+
+private:
+	// Delegated to so the 13 PNG decodes in the init list show up as one trace span
+	explicit GamepadTextures(uint64_t traceStart);
 };
 
 struct ScalingInfo
@@ -56,61 +80,6 @@ enum class BackgroundColor
 	Blue
 };
 
-struct ButtonMap
-{
-	std::unordered_map<int, int> buttonIndex;
-	std::unordered_map<int, int> defaultSNESIndex {
-		{GAMEPAD_BUTTON_LEFT_FACE_UP, 1},    // D-pad UP
-		{GAMEPAD_BUTTON_LEFT_FACE_RIGHT, 2}, // D-pad RIGHT
-		{GAMEPAD_BUTTON_LEFT_FACE_DOWN, 3},  // D-pad DOWN
-		{GAMEPAD_BUTTON_LEFT_FACE_LEFT, 4},  // D-pad LEFT
-		{GAMEPAD_BUTTON_RIGHT_FACE_UP, 5},   // X
-		{GAMEPAD_BUTTON_RIGHT_FACE_RIGHT, 6},// A
-		{GAMEPAD_BUTTON_RIGHT_FACE_DOWN, 7}, // B
-		{GAMEPAD_BUTTON_RIGHT_FACE_LEFT, 8}, // Y
-		{GAMEPAD_BUTTON_LEFT_TRIGGER_1, 9},  // Left shoulder
-		{GAMEPAD_BUTTON_RIGHT_TRIGGER_1, 11},// Right shoulder
-		{GAMEPAD_BUTTON_MIDDLE_LEFT, 13},    // Select
-		{GAMEPAD_BUTTON_MIDDLE_RIGHT, 15}    // Start
-	};
-
-	ButtonMap()
-	{
-		// std::println("DEBUG: ButtonMap constructor - buttonIndex starts empty");
-	}
-
-	void remapButton(int raylibButton, int newIndex)
-	{
-		buttonIndex[raylibButton] = newIndex;
-	}
-};
-
-struct CachedButtons
-{
-	// Cache all frequently used button indices
-	int dpadUp{};
-	int dpadRight{};
-	int dpadDown{};
-	int dpadLeft{};
-	int xButton{};        // RIGHT_FACE_UP
-	int aButton{};        // RIGHT_FACE_RIGHT
-	int bButton{};        // RIGHT_FACE_DOWN
-	int yButton{};        // RIGHT_FACE_LEFT
-	int leftTrigger{};
-	int rightTrigger{};
-	int selectButton{};   // MIDDLE_LEFT
-	int startButton{};    // MIDDLE_RIGHT
-
-	CachedButtons() {}; // empty default
-
-	CachedButtons(const ButtonMap& buttonMap)
-	{
-		refreshCache(buttonMap);
-	}
-
-	void refreshCache(const ButtonMap& buttonMap);
-};
-
 class PadCast
 {
 public:
@@ -119,12 +88,17 @@ public:
 
 	const GamepadTextures& getTextures() const { return mTextures; }
 	Config& getConfig() { return mConfig; }
+	TextCache& getTextCache() { return mTextCache; }
+	size_t getTextureMemory() const { return mTextures.memoryBytes() + mTextCache.memoryBytes(); }
 	bool isDebugOn() const { return mDebugMode; }
 
 public:
 	// Gamepad functions
-	bool updateGamepadConnection(bool currentlyAvailable);
-	void drawGamepadButtons(const raylib::Gamepad& gamepad, const ScalingInfo& scaling);
+	bool updateGamepadConnection(bool currentlyAvailable) { return mMapper.updateGamepadConnection(currentlyAvailable); }
+	void drawGamepadButtons(const PadState& pad, const ScalingInfo& scaling);
+	// pad's held buttons as the overlay sees them, through the button map (padshm::Button bits)
+	uint32_t getLogicalButtons(const PadState& pad) const { return mMapper.getLogicalButtons(pad); }
+	PadMapper& getMapper() { return mMapper; }
 	void drawNoGamepadMessage(const ScalingInfo& scaling);
 	// USB gamepads seem to be 0 by default on Windows, might require finding on Linux
 	void findGamepadIndex();
@@ -147,28 +121,29 @@ public:
 	// Tint
 	void invalidateTintCache() { mTintCacheValid = false; }
 
-	// Button Map Functions
-	void loadButtonsFromConfig();
-	void resetButtonsToDefault()
-	{
-		mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
-		mButtonCache.refreshCache(mButtonMap);
-	}
-	void refreshButtonCache() { mButtonCache.refreshCache(mButtonMap); }
-	void setButtonMap(int raylibButton, int newIndex)
+	// Text -- cached text sizes/positions are only valid for one window size
+	void invalidateTextCache()
 	{
-		mButtonMap.remapButton(raylibButton, newIndex);
-		mButtonCache.refreshCache(mButtonMap);
+		mTextCache.clear();
+		mMessageLayoutValid = false;
 	}
 
+	// Button Map Functions
+	// Uploads image in place of texture index (GamepadTextures::at); false
+	// leaves the old texture in place
+	bool replaceTexture(size_t index, const Image& image);
+
+	void loadButtonsFromConfig() { mMapper.loadButtonsFromConfig(); }
+	void resetButtonsToDefault() { mMapper.resetButtonsToDefault(); }
+	void refreshButtonCache() { mMapper.refreshButtonCache(); }
+	void setButtonMap(int raylibButton, int newIndex) { mMapper.setButtonMap(raylibButton, newIndex); }
+
 private:
 	GamepadTextures mTextures;
 	Config& mConfig;
-	ButtonMap mButtonMap;
-	CachedButtons mButtonCache;
+	PadMapper mMapper;
+	TextCache mTextCache;
 
-	bool mGamepadWasConnected{ false };
-	int mStabilityCounter{ 0 };
 	int gamepadIndex{ 0 };
 
 	// Cache values for optimization
@@ -178,7 +153,6 @@ private:
 	mutable int mLastCustomRed{ -1 };
 	mutable int mLastCustomGreen{ -1 };
 	mutable int mLastCustomBlue{ -1 };
-	mutable int mCachedStabilityThreshold{ -1 };
 	// Custom BG Color cache
 	mutable int mCachedUseCustomBG{ -1 };
 	mutable int mCachedCustomRed{ -1 };
@@ -193,6 +167,11 @@ private:
 	mutable int mCachedTintG{ -1 };
 	mutable int mCachedTintB{ -1 };
 	mutable Color mCachedPressedTint{ WHITE };
+	// "No Gamepad" message layout
+	bool mMessageLayoutValid{ false };
+	int mMessageFontSize{ 0 };
+	int mMessageX{ 0 };
+	int mMessageY{ 0 };
 
 	bool mDebugMode{ false };
 };
@@ -0,0 +1,73 @@
+#ifndef PADCAST_CMDLINE_H
+#define PADCAST_CMDLINE_H
+
+#include <string>
+
+// Command line options. Everything PadCast normally needs lives in config.ini;
+// these are for one-off runs (profiling, tooling).
+struct CommandLine
+{
+	enum class CacheState
+	{
+		Warm,	// whatever the OS already has cached
+		Cold	// assets dropped from the page cache first
+	};
+
+	enum class VideoFormat
+	{
+		Y4m,
+		Rgba,
+		Shm		// videoOutPath names a shared-memory frame ring
+	};
+
+	bool profileStartup{ false };
+	CacheState cacheState{ CacheState::Warm };
+
+	// Script for a VirtualGamepad to use instead of real gamepads (empty = hardware)
+	std::string virtualPadScript{};
+	// Record input to this file, regardless of [Recording] RECORD_INPUT
+	std::string recordPath{};
+
+	// Play this .pcrec back instead of reading gamepads (empty = off)
+	std::string replayPath{};
+	double replaySpeed{ 1.0 };
+	double replayStart{ 0.0 };		// seconds
+	double replayLoopStart{ 0.0 };	// seconds; loop is off unless end > start
+	double replayLoopEnd{ 0.0 };
+
+	// Render the replay offline to this .y4m file or PNG directory and exit (empty = off)
+	std::string renderPath{};
+	double renderFps{ 60.0 };
+	int renderWidth{ 0 };			// 0 = image canvas size
+	int renderHeight{ 0 };
+	unsigned int renderThreads{ 0 };	// 0 = all cores
+
+	// Stream the overlay as raw video to this file or pipe ("-" = stdout; empty = off)
+	std::string videoOutPath{};
+	VideoFormat videoFormat{ VideoFormat::Y4m };
+	int videoWidth{ 0 };	// 0 = image canvas size
+	int videoHeight{ 0 };
+
+	// Publish live pad state to this shared-memory name ("-" = padshm::kDefaultName; empty = off)
+	std::string sharePadName{};
+
+	// UDP pad relay between two PCs (padrelay.h): send to host:port / read from [address:]port (empty = off)
+	std::string relaySend{};
+	std::string relayListen{};
+
+	// Headless: serve pad state over a local WebSocket instead of opening a window
+	bool daemon{ false };
+	int daemonPort{ 8765 };
+	std::string daemonBind{ "127.0.0.1" };
+
+	// Headless: draw the pad in the terminal (padtui.h) instead of opening a window
+	bool tui{ false };
+
+	bool showHelp{ false };
+	bool valid{ true };
+
+	static CommandLine parse(int argc, char** argv);
+	static void printUsage(const char* program);
+};
+
+#endif
@@ -4,10 +4,14 @@
 
 #include "mini/ini.h"
 #include "pathmanager.h"
+#include "trace.h"
 
+#include <array>
 #include <filesystem>
 #include <string>
 #include <iostream>
+#include <mutex>
+#include <utility>
 
 class Config
 {
@@ -15,6 +19,7 @@ private:
 	std::string mConfigPath{};
 	mINI::INIFile mConfigFile{ mConfigPath };
 	mINI::INIStructure config_ini;
+	mutable std::mutex mWriteMutex;	// saves in flight write one at a time
 
 	struct DefaultValues
 	{
@@ -23,6 +28,7 @@ private:
 		static constexpr int INITIAL_WINDOW_HEIGHT{ 540 };
 		static constexpr int TARGET_FPS{ 60 };
 		static constexpr int USE_VSYNC{ 0 };
+		static constexpr int VRR_MODE{ 0 };
 		// Background color defaults
 		static constexpr int BACKGROUND_COLOR{ 0 };
 		static constexpr int CUSTOM_BG_RED{ 0 };
@@ -44,8 +50,15 @@ private:
 		static constexpr int MIN_FONT_SIZE{ 10 };
 		static constexpr int DEFAULT_FONT_SIZE{ 35 };
 		static constexpr int TEXT_OFFSET{ 50 };
+		// Performance defaults
+		static constexpr int IDLE_MODE{ 0 };
+		static constexpr int IDLE_HEARTBEAT_MS{ 250 };
+		static constexpr int LATCH_MARGIN_MS{ 4 };
+		// Recording defaults
+		static constexpr int RECORD_INPUT{ 0 };
 		// Debug defaults
 		static constexpr int DEBUG_MODE{ 0 };
+		static constexpr int TRACE{ 0 };
 	};
 
 	struct SNESMapDefaults
@@ -68,63 +81,156 @@ private:
 		static constexpr int START{ 15 };
 	};
 
+	static bool hasValue(const mINI::INIStructure& ini, const std::string& section, const std::string& key)
+	{
+		if (!ini.has(section))
+		{
+			return false;
+		}
+		auto sectionData{ ini.get(section) };
+		return sectionData.has(key);
+	}
+
+	int getValue(const mINI::INIStructure& ini, const std::string& section, const std::string& key) const
+	{
+		if (!hasValue(ini, section, key))
+		{
+			std::cout << section << " or " << key << " doesn't exist, setting with default value." << std::endl;
+			return getDefault(section, key);
+		}
+		try
+		{
+			return std::stoi(ini.get(section).get(key));
+		}
+		catch (const std::invalid_argument&)
+		{
+			std::cerr << "Wrong value type " << key << " for " << section << ", using default" << std::endl;
+			return getDefault(section, key);
+		}
+	}
+
+	// One per kSections entry
+	void validateWindow(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateImage(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateGamepad(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateFont(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateButtonMap(mINI::INIStructure& ini, bool& needsSave) const;
+	void validatePerformance(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateRecording(mINI::INIStructure& ini, bool& needsSave) const;
+	void validateDebug(mINI::INIStructure& ini, bool& needsSave) const;
+
 public:
 	Config() { loadConfig(); }
+	// Loads (and saves back to) configPath instead of the user's config.ini
+	explicit Config(std::string configPath) : mConfigPath{ std::move(configPath) } { loadConfig(); }
 	~Config() { saveConfig(); }
 
 	//$ ----- config.ini functions (load, save, etc.) ----- //
 	// this assumes that the executable is in the root directory
 	std::string getConfigFilePath() const
 	{
-		return PathManager::getConfigFilePath();
+		return mConfigPath.empty() ? PathManager::getConfigFilePath() : mConfigPath;
 	}
 
 	void loadConfig();
 
 	void validateConfig();
 
+	// config.ini's sections, in the order validateSection() takes them
+	static constexpr std::array<const char*, 8> kSections{
+		"Window", "Image", "Gamepad", "Font", "ButtonMap", "Performance", "Recording", "Debug"
+	};
+
+	// Validates one section of ini (an index into kSections), fixing missing
+	// or invalid values; returns whether anything was fixed
+	bool validateSection(mINI::INIStructure& ini, size_t section) const;
+
 	bool hasValue(const std::string& section, const std::string& key) const
 	{
-		if (!config_ini.has(section))
-		{
-			return false;
-		}
-		auto sectionData{ config_ini.get(section) };
-		return sectionData.has(key);
+		return hasValue(config_ini, section, key);
 	}
 
 	bool saveConfig()
 	{
+		PADCAST_TRACE_SCOPE("Config::saveConfig");
+		std::lock_guard lock{ mWriteMutex };
 		return mConfigFile.write(config_ini);
 	}
 
-	void reloadConfig()
+	// saveConfig() in two parts, so the write can run off the main thread
+	// (menus.cpp's SaveConfigTask): copy the values, then write the copy
+	mINI::INIStructure snapshot() const { return config_ini; }
+	bool writeSnapshot(mINI::INIStructure& ini) const
 	{
-		mConfigFile.read(config_ini);
-		validateConfig();
+		PADCAST_TRACE_SCOPE("Config::writeSnapshot");
+		std::lock_guard lock{ mWriteMutex };
+		return mConfigFile.write(ini);
 	}
 
-	//$ ----- getters ----- //
-	// so far all the values are ints, so we'll just keep this function
-	// but it would be fun to write a template at a later time :)
-	auto& getIni() const { return config_ini; }
+	// A reload in steps, so it can be spread over frames (menus.cpp's
+	// ReloadConfigTask): readStaged() reads the file into a copy, which is
+	// validated a section at a time, then applySection() makes each section
+	// live. Nothing changes until a section is applied.
+	struct Staged
+	{
+		mINI::INIStructure ini;
+		bool needsSave{ false };
+	};
 
-	int getValue(const std::string& section, const std::string& key) const
+	bool readStaged(Staged& staged)
 	{
-		if (!hasValue(section, key))
+		PADCAST_TRACE_SCOPE("Config::readStaged");
+		staged.needsSave = false;
+		return mConfigFile.read(staged.ini);
+	}
+
+	void validateStaged(Staged& staged, size_t section) const
+	{
+		staged.needsSave = validateSection(staged.ini, section) || staged.needsSave;
+	}
+
+	void applySection(const Staged& staged, size_t section)
+	{
+		const char* name = kSections[section];
+		auto& live{ config_ini[name] };
+		live.clear();
+		if (staged.ini.has(name))
 		{
-			std::cout << section << " or " << key << " doesn't exist, setting with default value." << std::endl;
-			return getDefault(section, key);
+			for (const auto& [key, value] : staged.ini.get(name))
+			{
+				live[key] = value;
+			}
 		}
-		try
+	}
+
+	// All of the steps above at once
+	void reloadConfig()
+	{
+		PADCAST_TRACE_SCOPE("Config::reloadConfig");
+		Staged staged;
+		if (!readStaged(staged))
 		{
-			return std::stoi(config_ini.get(section).get(key));
+			return;
 		}
-		catch (const std::invalid_argument&)
+		for (size_t section = 0; section < kSections.size(); ++section)
 		{
-			std::cerr << "Wrong value type " << key << " for " << section << ", using default" << std::endl;
-			return getDefault(section, key);
+			validateStaged(staged, section);
+			applySection(staged, section);
 		}
+		if (staged.needsSave)
+		{
+			saveConfig();
+		}
+	}
+
+	//$ ----- getters ----- //
+	// so far all the values are ints, so we'll just keep this function
+	// but it would be fun to write a template at a later time :)
+	auto& getIni() const { return config_ini; }
+
+	int getValue(const std::string& section, const std::string& key) const
+	{
+		return getValue(config_ini, section, key);
 	}
 
 	int getInitWinWidth() const
@@ -159,6 +265,10 @@ public:
 	{
 		return getValue("Window", "USE_VSYNC");
 	}
+	int getVRRMode() const
+	{
+		return getValue("Window", "VRR_MODE");
+	}
 	int getBGColor() const
 	{
 		return getValue("Window", "BACKGROUND_COLOR");
@@ -167,10 +277,30 @@ public:
 	{
 		return getValue("Gamepad", "GAMEPAD_INDEX");
 	}
+	int getIdleMode() const
+	{
+		return getValue("Performance", "IDLE_MODE");
+	}
+	int getIdleHeartbeatMs() const
+	{
+		return getValue("Performance", "IDLE_HEARTBEAT_MS");
+	}
+	int getLatchMarginMs() const
+	{
+		return getValue("Performance", "LATCH_MARGIN_MS");
+	}
+	int getRecordInput() const
+	{
+		return getValue("Recording", "RECORD_INPUT");
+	}
 	int getDebugMode() const
 	{
 		return getValue("Debug", "MODE");
 	}
+	int getTrace() const
+	{
+		return getValue("Debug", "TRACE");
+	}
 	int getDefault(const std::string& section, const std::string& key) const;
 
 //$ ----- Setters -----
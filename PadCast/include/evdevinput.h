@@ -0,0 +1,77 @@
+#ifndef PADCAST_EVDEVINPUT_H
+#define PADCAST_EVDEVINPUT_H
+
+#include "inputsource.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Gamepads read straight from the kernel's evdev nodes (/dev/input/event*),
+// for headless modes on machines with no X11/Wayland session, where GLFW
+// can't start. Gamepad indices are handed out like GLFW's joystick IDs.
+//
+// Buttons are translated with the kernel's gamepad layout (BTN_SOUTH is the
+// bottom face button, BTN_DPAD_* or the first hat is the D-pad), which most
+// current pads follow. GLFW instead uses SDL's mapping database, so a pad
+// that only reports generic joystick buttons (BTN_TRIGGER...) has no
+// buttons here; analog-only D-pads (ABS_X/ABS_Y with no hat) are read as a
+// D-pad.
+//
+// Needs read access to /dev/input (usually the "input" group). Linux only;
+// elsewhere open() fails.
+class EvdevInput final : public InputSource
+{
+public:
+	EvdevInput() = default;
+	~EvdevInput() override { close(); }
+
+	EvdevInput(const EvdevInput&) = delete;
+	EvdevInput& operator=(const EvdevInput&) = delete;
+
+	// Finds the joystick devices; false if /dev/input can't be read at all
+	bool open();
+	void close();
+
+	// Reads pending events, and looks for hotplugged pads once a second
+	void update() override;
+	bool isAvailable(int gamepad) const override;
+	const char* getName(int gamepad) const override;
+	PadState sample(int gamepad) override;
+	int getButtonPressed() const override { return mLastPressed; }
+	bool supportsIdle() const override { return false; }
+
+private:
+	struct AxisRange
+	{
+		int minimum{ -1 };
+		int maximum{ 1 };
+	};
+
+	struct Device
+	{
+		int fd{ -1 };
+		std::string path;
+		std::string name;
+		uint32_t buttons{ 0 };		// bit n = raylib GamepadButton n
+		uint32_t hatButtons{ 0 };	// D-pad bits from the hat
+		uint32_t stickButtons{ 0 };	// D-pad bits from an analog-only D-pad
+		bool stickIsDpad{ false };
+		std::array<float, PadState::kAxisCount> axes{};
+		std::array<AxisRange, PadState::kAxisCount> ranges{};
+	};
+
+	void scan();
+	void sync(Device& device);
+	void read(Device& device);
+	void setButton(Device& device, int button, bool down);
+	void setAxis(Device& device, int code, int value);
+
+	std::vector<Device> mDevices;	// index = gamepad; fd -1 = free slot
+	std::chrono::steady_clock::time_point mLastScan{};
+	int mLastPressed{ 0 };
+	bool mOpen{ false };
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef PADCAST_FRAMEPACER_H
+#define PADCAST_FRAMEPACER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Frame limiter used in place of raylib's SetTargetFPS().
+// raylib's wait is a plain sleep measured from the end of the previous frame,
+// which shows up as visible jitter against a 60 Hz capture clock. This keeps
+// absolute deadlines (previous deadline + period) so rounding never
+// accumulates into drift, sleeps until just before the deadline and spins the
+// rest of the way. Call waitForNextFrame() right before the buffer swap so
+// presents land evenly spaced.
+//
+// It also tells the loop when to latch input: waitForLatch() returns a margin
+// ahead of the coming present (the frame deadline, or with VSync the vblank
+// predicted from the last present) so the pad can be sampled as late as
+// possible and only the overlay is drawn after it.
+class FramePacer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats
+	{
+		uint64_t frames{ 0 };
+		uint64_t missedDeadlines{ 0 };	// frames that were ready after their deadline
+		double lastLatenessMs{ 0.0 };
+		double worstLatenessMs{ 0.0 };
+	};
+
+	// What the pace is derived from; the period is recomputed whenever one changes.
+	// VSync: the swap blocks on vblank, so don't pace, only predict vblanks for latching.
+	// VRR: frames are only presented when something changed, no faster than the panel.
+	// Otherwise: the target FPS (0 = unlimited).
+	void setTargetFPS(int fps);
+	void setVSync(bool enabled);
+	void setVRR(bool enabled);
+	// Refresh rate of the monitor the window is on (0 = unknown)
+	void setRefreshRate(int refreshRate);
+
+	int getTargetFPS() const { return mTargetFPS; }
+	int getRefreshRate() const { return mRefreshRate; }
+	bool isVSync() const { return mVSync; }
+	bool isVRR() const { return mVRR; }
+	// Rate waitForNextFrame() holds to, 0 if it doesn't wait
+	int getPacedFPS() const { return mPacedFPS; }
+
+	void setLatchMargin(std::chrono::microseconds margin) { mLatchMargin = margin; }
+
+	// Prepared part of the frame is submitted; block until it's time to sample input
+	void waitForLatch();
+	// Block until the frame deadline (no-op with VSync)
+	void waitForNextFrame();
+	// Call right after the swap returns
+	void markPresented();
+	// VRR with nothing to present: sleep one refresh period (60 Hz if the
+	// rate is unknown) before the loop checks for changes again
+	void waitForNextCheck();
+	// The loop was deliberately blocked (event waiting); start a new deadline
+	// sequence instead of counting the gap as missed frames
+	void resync()
+	{
+		mNextDeadline = Clock::time_point{};
+		mLastPresent = Clock::time_point{};
+	}
+
+	const Stats& getStats() const { return mStats; }
+	void resetStats() { mStats = Stats{}; }
+
+	// Recent frame-to-frame intervals in ms, oldest first at getHistoryStart()
+	static constexpr size_t kHistorySize{ 256 };
+	const std::array<float, kHistorySize>& getHistory() const { return mHistory; }
+	size_t getHistoryStart() const { return mHistoryHead; }
+
+private:
+	// Sleep this far short of the deadline and spin the remainder. Desktop
+	// Linux wakes within ~100us, Windows' 1 ms timer period needs more slack.
+#ifdef _WIN32
+	static constexpr auto kSpinMargin{ std::chrono::microseconds(2000) };
+#else
+	static constexpr auto kSpinMargin{ std::chrono::microseconds(1000) };
+#endif
+
+	static void waitUntil(Clock::time_point deadline);
+	void applyMode();
+	void recordFrame(Clock::time_point now);
+
+	int mTargetFPS{ 0 };
+	int mRefreshRate{ 0 };
+	bool mVSync{ false };
+	bool mVRR{ false };
+	int mPacedFPS{ 0 };
+	Clock::duration mPeriod{};
+	Clock::duration mLatchMargin{};
+	Clock::time_point mLastPresent{};
+	Clock::duration mLastPresentInterval{};
+	Clock::time_point mNextDeadline{};
+	Clock::time_point mLastFrame{};
+
+	Stats mStats;
+	std::array<float, kHistorySize> mHistory{};
+	size_t mHistoryHead{ 0 };
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef PADCAST_GLFWBRIDGE_H
+#define PADCAST_GLFWBRIDGE_H
+
+// raylib builds GLFW straight into the library (rglfw.c) but doesn't expose
+// these through its own API, so declare the few GLFW functions we need here
+// instead of pulling in GLFW's headers.
+
+extern "C"
+{
+	// Same layout as GLFW 3.3+'s GLFWgamepadstate
+	typedef struct GLFWgamepadstate
+	{
+		unsigned char buttons[15];
+		float axes[6];
+	} GLFWgamepadstate;
+
+	// Thread-safe: wakes the main thread out of glfwWaitEvents()
+	void glfwPostEmptyEvent(void);
+
+	// Main thread only. Reads the device right now rather than returning what
+	// raylib saw at the last PollInputEvents(). Returns 0 if the joystick isn't
+	// present or has no gamepad mapping.
+	int glfwGetGamepadState(int jid, GLFWgamepadstate* state);
+
+	// Windowless use (--daemon): GLFW can read joysticks after glfwInit()
+	// without any window or GL context being created
+	#define PADCAST_GLFW_PLATFORM 0x00050003
+	#define PADCAST_GLFW_ANY_PLATFORM 0x00060000
+	void glfwInitHint(int hint, int value);
+	int glfwInit(void);
+	void glfwTerminate(void);
+	void glfwPollEvents(void);
+	int glfwJoystickIsGamepad(int jid);
+	const char* glfwGetGamepadName(int jid);
+
+	// Current context must be made current; used for GL entry points raylib
+	// doesn't wrap (timer queries)
+	typedef void (*GLFWglproc)(void);
+	GLFWglproc glfwGetProcAddress(const char* procname);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef PADCAST_GPUTIMER_H
+#define PADCAST_GPUTIMER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Measures GPU time per frame with GL_TIME_ELAPSED queries. Results are read a
+// few frames late from a small ring of queries so reading never stalls the
+// pipeline. rlgl doesn't wrap query objects, so the entry points are loaded
+// through GLFW on first use; if the driver doesn't have them isSupported()
+// turns false and everything is a no-op.
+//
+// A query counts GPU wall time from begin() to end(), so a frame that waits
+// on the CPU in the middle (the late latch) is measured in segments around
+// the wait, and the frame's time is their sum.
+class GpuTimer
+{
+public:
+	GpuTimer() = default;
+	~GpuTimer();
+
+	GpuTimer(const GpuTimer&) = delete;
+	GpuTimer& operator=(const GpuTimer&) = delete;
+
+	// Bracket a stretch of the frame's GL work, up to kMaxSegments per frame.
+	// Queries can't nest.
+	void begin();
+	void end();
+	// After the frame's last segment
+	void endFrame();
+
+	bool isSupported() const { return mSupported; }
+	// Most recent completed measurement
+	double getLastMs() const { return mLastMs; }
+
+private:
+	static constexpr size_t kFrameCount{ 4 };	// frames in flight
+	static constexpr size_t kMaxSegments{ 2 };
+	static constexpr size_t kQueryCount{ kFrameCount * kMaxSegments };
+
+	bool init();
+	void collect();
+
+	bool mInitialized{ false };
+	bool mSupported{ false };
+	std::array<unsigned int, kQueryCount> mQueries{};	// frame f's segments at f * kMaxSegments
+	std::array<size_t, kFrameCount> mSegments{};		// segments recorded per frame
+	std::array<bool, kFrameCount> mPending{};
+	size_t mWriteIndex{ 0 };
+	size_t mSegmentCount{ 0 };	// in the frame being recorded
+	bool mFrameOpen{ false };
+	bool mSkipFrame{ false };	// every frame still in flight, this one isn't measured
+	bool mActive{ false };
+	double mLastMs{ 0.0 };
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef PADCAST_INPUTLOG_H
+#define PADCAST_INPUTLOG_H
+
+#include "padstate.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// On-disk format of recorded gamepad input (.pcrec), shared by the recorder
+// and replay.
+//
+// A 16 byte header is followed by a stream of records, each starting with a
+// tag byte whose low two bits give the kind:
+//
+//   Delta       varint time since the previous record (in ticks), then
+//               if kHasButtons: varint XOR of the button mask, or one byte
+//                               with the bit index if kSingleButton is set
+//               if kHasAxes:    byte mask of changed axes, then a zigzag
+//                               varint per changed axis (quantized delta)
+//   Keyframe    varint absolute time, connected byte, varint buttons,
+//               kAxisCount quantized axes -- the full state, so a reader can
+//               start decoding here (seeking)
+//   Connection  varint time since the previous record; kConnected in the tag
+//   Index       written once, after the last record, when the recording is
+//               closed: varint keyframe count, then per keyframe varint time
+//               and varint offset (each as the difference from the previous
+//               keyframe), then varint time of the last record
+//
+// The Index record is followed by a 12 byte trailer: u64 offset of the Index
+// record and the magic kIndexMagic. Offsets count from the end of the header.
+// With it a reader finds the keyframes without walking the file; a recording
+// that was never closed has no index and is scanned instead.
+//
+// Times are in ticks of kTickUs from the start of the recording. Axes are
+// quantized to int8 (-127..127). The file is append-only; a truncated last
+// record (crash, power loss) is simply ignored by the reader.
+namespace inputlog
+{
+	inline constexpr std::array<char, 4> kMagic{ 'P', 'C', 'I', 'R' };
+	inline constexpr uint8_t kVersion{ 1 };
+	inline constexpr size_t kHeaderSize{ 16 };
+	inline constexpr uint32_t kTickUs{ 100 };
+	// Keyframes are written at most this often, and only when something changes
+	inline constexpr uint64_t kKeyframeIntervalTicks{ 5'000'000 / kTickUs };
+	inline constexpr std::array<char, 4> kIndexMagic{ 'P', 'C', 'I', 'X' };
+	inline constexpr size_t kIndexTrailerSize{ 12 };
+
+	enum class Kind : uint8_t
+	{
+		Delta = 0,
+		Keyframe = 1,
+		Connection = 2,
+		Index = 3
+	};
+
+	inline constexpr uint8_t kKindMask{ 0x03 };
+	inline constexpr uint8_t kHasButtons{ 0x04 };
+	inline constexpr uint8_t kHasAxes{ 0x08 };
+	inline constexpr uint8_t kSingleButton{ 0x10 };
+	inline constexpr uint8_t kConnected{ 0x04 };	// Connection records only
+
+	struct Header
+	{
+		uint8_t version{ kVersion };
+		uint8_t axisCount{ PadState::kAxisCount };
+		uint16_t tickUs{ kTickUs };
+		uint64_t startUnixMs{};	// wall clock at tick 0
+
+		void write(std::vector<uint8_t>& out) const;
+		// False if data isn't a recording this build can read
+		static bool read(const uint8_t* data, size_t size, Header& out);
+	};
+
+	struct Sample
+	{
+		uint64_t ticks{};
+		uint32_t buttons{};
+		std::array<int8_t, PadState::kAxisCount> axes{};
+		bool connected{ false };
+
+		bool sameState(const Sample& other) const
+		{
+			return buttons == other.buttons && axes == other.axes && connected == other.connected;
+		}
+
+		static Sample fromPad(const PadState& pad, bool connected, uint64_t ticks);
+		PadState toPad(int gamepad) const;
+	};
+
+	struct IndexEntry
+	{
+		uint64_t ticks{};
+		uint64_t offset{};	// decoder offset of the keyframe record
+	};
+
+	struct Index
+	{
+		std::vector<IndexEntry> keyframes;
+		uint64_t endTicks{};		// time of the last record
+		uint64_t recordsSize{};		// bytes of records before the index (read() only)
+
+		// Appends the Index record and trailer; offset is where the record starts
+		void write(std::vector<uint8_t>& out, uint64_t offset) const;
+		// records..end is everything after the header. False if there's no
+		// index, or it doesn't fit the file (then scan for the keyframes).
+		static bool read(const uint8_t* records, const uint8_t* end, Index& out);
+	};
+
+	int8_t quantizeAxis(float value);
+	float dequantizeAxis(int8_t value);
+
+	void putVarint(std::vector<uint8_t>& out, uint64_t value);
+	// Advances p; false on truncated or overlong input
+	bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value);
+
+	// Turns a sequence of samples into records. Keeps the previous sample
+	// so each record only carries what changed.
+	class Encoder
+	{
+	public:
+		// True if the sample was written as a keyframe
+		bool encode(const Sample& sample, std::vector<uint8_t>& out);
+		// The next sample is written in full (after dropped samples)
+		void forceKeyframe() { mForceKeyframe = true; }
+		// Time of the last record written
+		uint64_t getLastTicks() const { return mLast.ticks; }
+
+	private:
+		void writeKeyframe(const Sample& sample, std::vector<uint8_t>& out);
+
+		Sample mLast{};
+		uint64_t mLastKeyframe{ 0 };
+		bool mForceKeyframe{ true };
+	};
+
+	// Walks the records of a mapped/loaded file, one at a time
+	class Decoder
+	{
+	public:
+		Decoder() = default;
+		Decoder(const uint8_t* begin, const uint8_t* end) : mBegin(begin), mPos(begin), mEnd(end) {}
+
+		// Decodes the next record into state. False at the end (an Index record
+		// or the end of the data) or on a truncated record.
+		bool next(Sample& state);
+		// Byte offset of the record next() will decode, from begin
+		size_t offset() const { return static_cast<size_t>(mPos - mBegin); }
+		void seek(size_t offset) { mPos = mBegin + offset; }
+		bool lastWasKeyframe() const { return mLastKind == Kind::Keyframe; }
+
+	private:
+		const uint8_t* mBegin{ nullptr };
+		const uint8_t* mPos{ nullptr };
+		const uint8_t* mEnd{ nullptr };
+		Kind mLastKind{ Kind::Delta };
+	};
+}
+
+#endif
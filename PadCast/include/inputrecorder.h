@@ -0,0 +1,103 @@
+#ifndef PADCAST_INPUTRECORDER_H
+#define PADCAST_INPUTRECORDER_H
+
+#include "inputlog.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records gamepad state changes to a .pcrec file (see inputlog.h).
+//
+// record() is called from the render loop every frame. It only compares the
+// pad with the last state it saw and, if something changed, drops the sample
+// into a fixed-size single-producer ring -- no locks, allocation or I/O. A
+// background thread encodes and appends to the file. If the writer falls so
+// far behind that the ring fills, samples are dropped (counted) and the next
+// one is written as a keyframe so the log stays consistent. stop() ends the
+// file with an index of its keyframes, so replay can open it without a scan.
+class InputRecorder
+{
+public:
+	InputRecorder() = default;
+	~InputRecorder() { stop(); }
+
+	InputRecorder(const InputRecorder&) = delete;
+	InputRecorder& operator=(const InputRecorder&) = delete;
+
+	// Creates (truncates) path and starts the writer thread
+	bool start(const std::string& path);
+	// Writes everything still queued and closes the file
+	void stop();
+
+	bool isRecording() const { return mThread.joinable(); }
+	const std::string& getPath() const { return mPath; }
+
+	// padcast-<local date>-<time>.pcrec, for one recording per session
+	static std::string sessionFileName();
+
+	// Render thread only
+	void record(const PadState& pad, bool connected);
+
+	uint64_t getDroppedSamples() const { return mDropped.load(std::memory_order_relaxed); }
+	uint64_t getBytesWritten() const { return mBytesWritten.load(std::memory_order_relaxed); }
+
+private:
+	struct Entry
+	{
+		inputlog::Sample sample;
+		bool keyframe{ false };
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	void run();
+	// Writer thread: encodes whatever is in the ring; returns true if anything was taken
+	bool drainRing();
+	void flushBuffer();
+	// Where the next record will start, counted from the end of the header
+	uint64_t recordsOffset() const { return getBytesWritten() + mBuffer.size() - inputlog::kHeaderSize; }
+
+	// ~1 minute of button mashing at 60 FPS; the writer empties it every kWriterPeriod
+	static constexpr size_t kRingSize{ 4096 };
+	static constexpr auto kWriterPeriod{ std::chrono::milliseconds(50) };
+	static constexpr auto kFlushPeriod{ std::chrono::seconds(1) };
+	// Axis moves smaller than this (in quantized steps) don't count as a change,
+	// so stick noise doesn't turn into a record per frame. Centre and full
+	// deflection always count, so a released stick is recorded exactly.
+	static constexpr int kAxisStep{ 2 };
+
+	std::array<Entry, kRingSize> mRing{};
+	std::atomic<size_t> mHead{ 0 };	// next slot the render thread writes
+	std::atomic<size_t> mTail{ 0 };	// next slot the writer reads
+
+	// Render thread state
+	Clock::time_point mStart{};
+	inputlog::Sample mLastPushed{};
+	bool mHavePushed{ false };
+	bool mNeedKeyframe{ false };
+
+	// Writer thread state
+	std::FILE* mFile{ nullptr };
+	inputlog::Encoder mEncoder;
+	inputlog::Index mIndex;
+	std::vector<uint8_t> mBuffer;
+	Clock::time_point mLastFlush{};
+
+	std::string mPath;
+	std::thread mThread;
+	std::atomic<bool> mRunning{ false };
+	std::atomic<uint64_t> mDropped{ 0 };
+	std::atomic<uint64_t> mBytesWritten{ 0 };
+	std::mutex mStopMutex;
+	std::condition_variable mStopSignal;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef PADCAST_INPUTREPLAY_H
+#define PADCAST_INPUTREPLAY_H
+
+#include "inputsource.h"
+#include "inputlog.h"
+#include "mappedfile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Plays a .pcrec recording (see inputlog.h) back as a gamepad, so the overlay
+// for an edited VOD can be regenerated through the normal drawing path, or a
+// session can be rerun as a reproducible workload.
+//
+// The file is memory-mapped, and its keyframes come from the index the
+// recorder writes when it closes the file, so opening touches only the end
+// of it. A recording without an index (cut short by a crash) is walked once
+// instead. A seek decodes forward from the nearest keyframe at or before the
+// target, so it costs at most kKeyframeIntervalTicks of records however long
+// the log is.
+//
+// Playback follows the wall clock scaled by the speed, and the late latch
+// (sample()) sees the state as of that moment, so presses land on the same
+// frame they would have live.
+class InputReplay final : public InputSource
+{
+public:
+	// Maps path and reads (or builds) its keyframe index. On failure error says why.
+	bool open(const std::string& path, std::string& error);
+
+	void setIndex(int gamepad) { mIndex = gamepad; }
+	// 1.0 is real time
+	void setSpeed(double speed);
+	// Play [start, end) over and over; end <= start turns looping off.
+	// Times in seconds from the start of the recording.
+	void setLoop(double startSeconds, double endSeconds);
+	void setPaused(bool paused);
+	void seek(double seconds);
+	// For stepping a paused replay frame by frame (offline rendering): moves
+	// forward by playing, so presses register, and only seeks when going back
+	void setTime(double seconds);
+	// Back to the start (of the loop region, if any) with the clock restarted
+	void restart();
+
+	// InputSource
+	void update() override;
+	bool isAvailable(int gamepad) const override { return mState.connected && gamepad == mIndex; }
+	const char* getName(int gamepad) const override;
+	PadState sample(int gamepad) override;
+	int getButtonPressed() const override { return mLastPressed; }
+	bool supportsIdle() const override { return false; }
+
+	double getPositionSeconds() const { return mPosition * mTickSeconds; }
+	double getDurationSeconds() const { return static_cast<double>(mEndTicks) * mTickSeconds; }
+	double getSpeed() const { return mSpeed; }
+	bool isPaused() const { return mPaused; }
+	bool isLooping() const { return mLoopEnd > mLoopStart; }
+	bool isFinished() const { return !isLooping() && !mHavePending; }
+	size_t getKeyframeCount() const { return mKeyframes.size(); }
+
+private:
+	using Keyframe = inputlog::IndexEntry;
+	using Clock = std::chrono::steady_clock;
+
+	// Fallback for recordings without an index: one pass over the records
+	void scanKeyframes();
+
+	// Moves the playback position along with the wall clock, wrapping at the loop end
+	void advanceClock();
+	// Applies every record up to ticks; countPresses is off while seeking
+	void advanceTo(uint64_t ticks, bool countPresses);
+	void seekTicks(uint64_t ticks);
+	// Decodes the record after mState into mPending
+	void peek();
+
+	MappedFile mFile;
+	inputlog::Header mHeader;
+	inputlog::Decoder mDecoder;
+	std::vector<Keyframe> mKeyframes;
+	uint64_t mEndTicks{ 0 };
+	double mTickSeconds{ inputlog::kTickUs / 1'000'000.0 };
+
+	inputlog::Sample mState{};		// as of the last applied record
+	inputlog::Sample mPending{};	// the next record, not yet due
+	bool mHavePending{ false };
+
+	int mIndex{ 0 };
+	double mSpeed{ 1.0 };
+	bool mPaused{ false };
+	uint64_t mLoopStart{ 0 };
+	uint64_t mLoopEnd{ 0 };
+
+	Clock::time_point mLastClock{};
+	double mPosition{ 0.0 };	// ticks
+	int mLastPressed{ 0 };
+};
+
+#endif
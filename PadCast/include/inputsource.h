@@ -0,0 +1,69 @@
+#ifndef PADCAST_INPUTSOURCE_H
+#define PADCAST_INPUTSOURCE_H
+
+#include "padstate.h"
+
+// Where gamepad state comes from. The main loop, the menus and the remap
+// screens only read pads through one of these, so a scripted VirtualGamepad
+// can stand in for hardware in automated runs and benchmarks.
+class InputSource
+{
+public:
+	virtual ~InputSource() = default;
+
+	// Once per frame, after raylib has polled events
+	virtual void update() {}
+
+	virtual bool isAvailable(int gamepad) const = 0;
+	virtual const char* getName(int gamepad) const = 0;
+
+	// The pad as of right now (what the late latch reads)
+	virtual PadState sample(int gamepad) = 0;
+
+	// Button that went down during the last update(), 0 if none.
+	// Same meaning as raylib's GetGamepadButtonPressed().
+	virtual int getButtonPressed() const = 0;
+
+	// False if nothing outside the process will wake an idle (event-waiting) loop
+	// for this source's input
+	virtual bool supportsIdle() const { return true; }
+};
+
+// The real thing: raylib/GLFW
+class RaylibInput final : public InputSource
+{
+public:
+	bool isAvailable(int gamepad) const override;
+	const char* getName(int gamepad) const override;
+	PadState sample(int gamepad) override { return PadState::sampleNow(gamepad); }
+	int getButtonPressed() const override;
+};
+
+// GLFW without raylib's window: for modes that never open one (--daemon).
+// GLFW reads joysticks through the desktop session's platform (X11/Wayland on
+// Linux), but no window or GL context is ever created, so the GPU isn't used.
+class GlfwInput final : public InputSource
+{
+public:
+	GlfwInput() = default;
+	~GlfwInput() { shutdown(); }
+
+	GlfwInput(const GlfwInput&) = delete;
+	GlfwInput& operator=(const GlfwInput&) = delete;
+
+	bool init();
+	void shutdown();
+
+	// Picks up hotplugged pads
+	void update() override;
+	bool isAvailable(int gamepad) const override;
+	const char* getName(int gamepad) const override;
+	PadState sample(int gamepad) override;
+	int getButtonPressed() const override { return 0; }
+	bool supportsIdle() const override { return false; }
+
+private:
+	bool mInitialized{ false };
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef PADCAST_INPUTWATCHER_H
+#define PADCAST_INPUTWATCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Background thread that lets the main loop sleep in raylib's event waiting
+// (EnableEventWaiting) between inputs. GLFW doesn't treat gamepad input as a
+// window event, so on its own glfwWaitEvents() would never wake for a button
+// press -- this posts an empty event whenever a gamepad reports activity,
+// plus a low-rate heartbeat so hotplug/connection checks keep running.
+//
+// On Linux it watches the evdev nodes of joystick devices and /dev/input for
+// hotplug. Elsewhere (or without read access to /dev/input) it can only
+// provide the heartbeat; isWatchingDevices() tells the caller whether it's
+// safe to idle while a gamepad is connected.
+class InputWatcher
+{
+public:
+	InputWatcher() = default;
+	~InputWatcher() { stop(); }
+
+	InputWatcher(const InputWatcher&) = delete;
+	InputWatcher& operator=(const InputWatcher&) = delete;
+
+	void start(int heartbeatMs);
+	void stop();
+
+	// While paused (e.g. window minimized) nothing is posted, not even the heartbeat
+	void setPaused(bool paused) { mPaused.store(paused, std::memory_order_relaxed); }
+	bool isWatchingDevices() const { return mWatchedDevices.load(std::memory_order_relaxed) > 0; }
+
+private:
+	void run();
+
+	std::thread mThread;
+	std::atomic<bool> mRunning{ false };
+	std::atomic<bool> mPaused{ false };
+	std::atomic<int> mWatchedDevices{ 0 };
+	int mHeartbeatMs{ 250 };
+	int mWakeFd{ -1 };	// eventfd used to interrupt the thread on stop() (Linux)
+	std::mutex mStopMutex;	// used to interrupt the heartbeat sleep elsewhere
+	std::condition_variable mStopSignal;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef PADCAST_MAPPEDFILE_H
+#define PADCAST_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Memory-mapped where the platform allows,
+// so opening a large file costs nothing up front and pages are read on
+// demand; otherwise the file is read into memory.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const { return mData != nullptr; }
+	bool isMapped() const { return mMapped; }
+	const uint8_t* data() const { return mData; }
+	size_t size() const { return mSize; }
+
+private:
+	const uint8_t* mData{ nullptr };
+	size_t mSize{ 0 };
+	bool mMapped{ false };
+	std::vector<uint8_t> mFallback;	// used when mapping isn't available
+#ifdef _WIN32
+	void* mFileHandle{ nullptr };
+	void* mMappingHandle{ nullptr };
+#endif
+};
+
+#endif
@@ -9,14 +9,17 @@
 #endif
 
 #include <PadCast.h>
+#include "framepacer.h"
+#include "taskqueue.h"
+#include "inputsource.h"
 
 #ifdef _WIN32
 	#undef NOGDI
 	#undef NOUSER
 #endif
 
-#include <functional>
-#include <vector>
+#include <array>
+#include <cstddef>
 
 enum class Menu
 {
@@ -27,74 +30,131 @@ enum class Menu
 	Controller,
 	Resolution,
 	FPS,
+	FPSLocked,	// shown in place of FPS while VSync is on
 	BGColor,
 	Tint,
 	RemapButtons,
-	Gamepad
+	Gamepad,
+	Count
 };
 
-struct MenuItem
+struct MenuContext;
+
+struct MenuParams
 {
-	std::string label{};
-	std::function<void()> action;
+	MenuContext& menu;
+	raylib::Window& window;
+	Config& config;
+	PadCast& padcast;
+	ScalingInfo& scaling;
+	int& gamepadIndex;
+	FramePacer& pacer;
+	TaskQueue& tasks;
+	InputSource& input;
+
+	MenuParams(MenuContext& men, raylib::Window& win, Config& con, 
+			   PadCast& pad, ScalingInfo& sca, int& gpIndex, FramePacer& pac, TaskQueue& tsk,
+			   InputSource& inp)
+		: menu(men), window(win), config(con), padcast(pad), scaling(sca), gamepadIndex(gpIndex),
+		  pacer(pac), tasks(tsk), input(inp)
+	{
+	}
 };
 
-struct MenuContext
-{
-	Menu active{ Menu::None };
-	// items will hold menu options for whatever the active menu is
-	std::vector<MenuItem> items;
-	int selectedIndex{ 0 };
+// Plain function pointer + argument instead of std::function so items never allocate
+using MenuAction = void (*)(MenuParams& params, int arg);
 
-	struct MenuParams
-	{
-		MenuContext& menu;
-		raylib::Window& window;
-		Config& config;
-		PadCast& padcast;
-		ScalingInfo& scaling;
-		int& gamepadIndex;
-
-		MenuParams(MenuContext& men, raylib::Window& win, Config& con, 
-				   PadCast& pad, ScalingInfo& sca, int& gpIndex)
-			: menu(men), window(win), config(con), padcast(pad), scaling(sca), gamepadIndex(gpIndex)
-		{
-		}
-	};
+inline constexpr size_t kMenuLabelSize{ 64 };
+// Largest page: Background Color (6 colours, a spacer, Back, Close)
+inline constexpr size_t kMaxMenuItems{ 9 };
+
+struct MenuItem
+{
+	char label[kMenuLabelSize]{};
+	MenuAction action{ nullptr };	// nullptr = spacer / no-op
+	int arg{ 0 };
 };
 
-MenuItem createMenuItem(const std::string& label, std::function<void()> action);
+struct MenuPage
+{
+	std::array<MenuItem, kMaxMenuItems> items{};
+	size_t count{ 0 };
 
-MenuItem createBackMenuItem(MenuContext::MenuParams& params);
+	size_t size() const { return count; }
+	const MenuItem& operator[](size_t i) const { return items[i]; }
+};
 
-MenuItem createCloseMenuItem(MenuContext& menu);
+// Screen geometry of the open menu. Only recomputed when the window is
+// resized, the active page changes, or the config is reloaded.
+struct MenuLayout
+{
+	bool valid{ false };
+	int x{};			// top-left of the first item
+	int y{};
+	int itemWidth{};	// hit-test width of a row
+	int lineHeight{};
+	int padding{};
+	int panelWidth{};
+	int panelHeight{};
+	int fontSize{};
+};
 
-MenuItem createSpacer();
+// The open menu rendered into a texture. Redrawn only when the selection or
+// content changes; every other frame it's one textured quad.
+struct MenuPanel
+{
+	RenderTexture2D target{};
+	bool dirty{ true };
+	Menu drawnPage{ Menu::None };
+	int drawnSelection{ -1 };
+};
 
-void SetupMainMenu(MenuContext::MenuParams& params);
+struct MenuContext
+{
+	Menu active{ Menu::None };
+	// Every page is built once up front; navigating just switches which one is active
+	std::array<MenuPage, static_cast<size_t>(Menu::Count)> pages{};
+	int selectedIndex{ 0 };
 
-void SetupVideoMenu(MenuContext::MenuParams& params);
+	// Last values the dynamic labels were formatted from (-1 = never formatted)
+	int labelVsync{ -1 };
+	int labelFPS{ -1 };
 
-void SetupVisualsMenu(MenuContext::MenuParams& params);
+	MenuLayout layout;
+	MenuPanel panel;
 
-void SetupControllerMenu(MenuContext::MenuParams& params);
+	using MenuParams = ::MenuParams;
 
-void SetupResolutionMenu(MenuContext::MenuParams& params);
+	MenuContext();
+	~MenuContext();
 
-void SetupFPSMenu(MenuContext::MenuParams& params);
+	MenuContext(const MenuContext&) = delete;
+	MenuContext& operator=(const MenuContext&) = delete;
 
-void SetupBGColorMenu(MenuContext::MenuParams& params);
+	void invalidateLayout() { layout.valid = false; panel.dirty = true; }
 
-void SetupTintMenu(MenuContext::MenuParams& params);
+	// Color + depth attachment of the cached panel
+	size_t getTextureMemory() const
+	{
+		const int width = panel.target.texture.width;
+		const int height = panel.target.texture.height;
+		return static_cast<size_t>(GetPixelDataSize(width, height, panel.target.texture.format))
+			+ static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+	}
+
+	MenuPage& page(Menu menu) { return pages[static_cast<size_t>(menu)]; }
+	const MenuPage& current() const { return pages[static_cast<size_t>(active)]; }
+};
 
-void SetupRemapMenu(MenuContext::MenuParams& params);
+void OpenMenu(MenuContext::MenuParams& params, Menu target);
 
-void SetupGamepadMenu(MenuContext::MenuParams& params);
+// Right click, spacebar or M this frame
+bool IsMenuTogglePressed();
 
 void HandleMenuInput(MenuContext::MenuParams& params);
 
-void DrawMenu(const MenuContext& menu, const ScalingInfo& scaling, const Config& config,
-	int baseX, int baseY);
+void DrawMenu(MenuContext& menu, const ScalingInfo& scaling, const Config& config,
+	TextCache& textCache);
 
 void ResetRemapState();
 
@@ -0,0 +1,51 @@
+#ifndef PADCAST_OFFLINERENDER_H
+#define PADCAST_OFFLINERENDER_H
+
+#include <cstdint>
+#include <string>
+
+class InputReplay;
+
+// Renders a replay to video frames as fast as the machine allows instead of in
+// real time, for regenerating the overlay of a long VOD.
+//
+// Frames are drawn on the main thread into an offscreen target with the same
+// textures, ScalingInfo and draw calls as the live window, then read back and
+// handed to a WorkStealingPool that encodes them (PNG, or RGB -> YUV 4:2:0 for
+// Y4M) on every core. A small ring of frame slots bounds memory and keeps the
+// Y4M stream in order: a slot's frame is written out just before the slot is
+// reused.
+class OfflineRenderer
+{
+public:
+	enum class Format
+	{
+		Png,	// numbered image sequence in a directory
+		Y4m		// one YUV4MPEG2 file, for ffmpeg
+	};
+
+	struct Settings
+	{
+		std::string outPath;	// *.y4m for a Y4M stream, otherwise a directory for PNGs
+		double fps{ 60.0 };
+		int width{ 0 };			// 0 = the image canvas size from config.ini
+		int height{ 0 };
+		unsigned int threads{ 0 };	// 0 = all hardware threads
+		double startSeconds{ 0.0 };
+		double endSeconds{ 0.0 };	// 0 = end of the recording
+	};
+
+	explicit OfflineRenderer(Settings settings);
+
+	// Opens a hidden window for the GL context, renders every frame and
+	// returns the process exit code
+	int run(InputReplay& replay);
+
+	static Format formatFor(const std::string& outPath);
+
+private:
+	Settings mSettings;
+	Format mFormat;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef PADCAST_PADDAEMON_H
+#define PADCAST_PADDAEMON_H
+
+#include <cstdint>
+#include <string>
+
+class Config;
+class InputSource;
+
+// --daemon: PadCast's input pipeline (InputSource -> PadMapper) with no window,
+// serving the pad to browser sources over a local WebSocket (wsserver.h).
+//
+// Only changes are sent -- connect/disconnect and button edges -- not a
+// snapshot per frame, so an idle pad costs no traffic. Input is still polled
+// about every millisecond, so an edge goes out within ~1 ms of the OS seeing it.
+//
+// JSON event (text message):
+//   {"type":"state","seq":12,"t":1234.567,"connected":true,"gamepad":0,
+//    "name":"...","buttons":96,"raw":96}
+// Binary event (24 bytes, little endian):
+//   u8 version (1), u8 flags (bit 0 connected), i16 gamepad, u32 seq,
+//   u32 buttons, u32 raw, u64 microseconds since the daemon started
+//
+// "buttons" are padshm::Button bits after the button map; "raw" are raylib
+// GamepadButton bits straight from the pad.
+class PadDaemon
+{
+public:
+	struct Settings
+	{
+		std::string bindAddress{ "127.0.0.1" };
+		int port{ 8765 };
+		std::string relayTarget;	// host:port to also relay the pad to over UDP (padrelay.h), empty = off
+	};
+
+	static constexpr size_t kBinaryEventBytes{ 24 };
+	static constexpr uint8_t kBinaryVersion{ 1 };
+
+	explicit PadDaemon(Settings settings);
+
+	// Serves until SIGINT/SIGTERM; returns the process exit code
+	int run(Config& config, InputSource& input);
+
+private:
+	Settings mSettings;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef PADCAST_PADMAPPER_H
+#define PADCAST_PADMAPPER_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include "config.h"
+#include "inputsource.h"
+#include "padstate.h"
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+struct ButtonMap
+{
+	std::unordered_map<int, int> buttonIndex;
+	std::unordered_map<int, int> defaultSNESIndex {
+		{GAMEPAD_BUTTON_LEFT_FACE_UP, 1},    // D-pad UP
+		{GAMEPAD_BUTTON_LEFT_FACE_RIGHT, 2}, // D-pad RIGHT
+		{GAMEPAD_BUTTON_LEFT_FACE_DOWN, 3},  // D-pad DOWN
+		{GAMEPAD_BUTTON_LEFT_FACE_LEFT, 4},  // D-pad LEFT
+		{GAMEPAD_BUTTON_RIGHT_FACE_UP, 5},   // X
+		{GAMEPAD_BUTTON_RIGHT_FACE_RIGHT, 6},// A
+		{GAMEPAD_BUTTON_RIGHT_FACE_DOWN, 7}, // B
+		{GAMEPAD_BUTTON_RIGHT_FACE_LEFT, 8}, // Y
+		{GAMEPAD_BUTTON_LEFT_TRIGGER_1, 9},  // Left shoulder
+		{GAMEPAD_BUTTON_RIGHT_TRIGGER_1, 11},// Right shoulder
+		{GAMEPAD_BUTTON_MIDDLE_LEFT, 13},    // Select
+		{GAMEPAD_BUTTON_MIDDLE_RIGHT, 15}    // Start
+	};
+
+	ButtonMap()
+	{
+		// std::println("DEBUG: ButtonMap constructor - buttonIndex starts empty");
+	}
+
+	void remapButton(int raylibButton, int newIndex)
+	{
+		buttonIndex[raylibButton] = newIndex;
+	}
+};
+
+struct CachedButtons
+{
+	// Cache all frequently used button indices
+	int dpadUp{};
+	int dpadRight{};
+	int dpadDown{};
+	int dpadLeft{};
+	int xButton{};        // RIGHT_FACE_UP
+	int aButton{};        // RIGHT_FACE_RIGHT
+	int bButton{};        // RIGHT_FACE_DOWN
+	int yButton{};        // RIGHT_FACE_LEFT
+	int leftTrigger{};
+	int rightTrigger{};
+	int selectButton{};   // MIDDLE_LEFT
+	int startButton{};    // MIDDLE_RIGHT
+
+	CachedButtons() {}; // empty default
+
+	CachedButtons(const ButtonMap& buttonMap)
+	{
+		refreshCache(buttonMap);
+	}
+
+	void refreshCache(const ButtonMap& buttonMap);
+};
+
+// The part of PadCast's input pipeline that needs no window or GL: the button
+// map from config.ini and the STABILITY_THRESHOLD connection debouncing. The
+// GUI (through PadCast), --daemon and --tui all read the pad through one of
+// these, so they agree on mappings and on when a pad counts as connected.
+class PadMapper
+{
+public:
+	explicit PadMapper(Config& config);
+
+	// Once per frame with whether the pad is there right now; returns whether
+	// it should be treated as connected (disconnects are debounced)
+	bool updateGamepadConnection(bool currentlyAvailable);
+	// For the windowless loops (--daemon, --tui), which may pass any number of
+	// times a frame: updateGamepadConnection() at the window's pace while
+	// connected, so STABILITY_THRESHOLD means the same, and on every call while
+	// disconnected, so a plugged-in pad shows up right away
+	bool pollGamepadConnection(const InputSource& input, int gamepad);
+	// pad's held buttons as the overlay sees them, through the button map (padshm::Button bits)
+	uint32_t getLogicalButtons(const PadState& pad) const;
+	const CachedButtons& getButtons() const { return mButtonCache; }
+
+	void loadButtonsFromConfig();
+	void resetButtonsToDefault()
+	{
+		mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
+		mButtonCache.refreshCache(mButtonMap);
+	}
+	void refreshButtonCache() { mButtonCache.refreshCache(mButtonMap); }
+	void setButtonMap(int raylibButton, int newIndex)
+	{
+		mButtonMap.remapButton(raylibButton, newIndex);
+		mButtonCache.refreshCache(mButtonMap);
+	}
+
+private:
+	Config& mConfig;
+	ButtonMap mButtonMap;
+	CachedButtons mButtonCache;
+
+	bool mGamepadWasConnected{ false };
+	int mStabilityCounter{ 0 };
+	int mCachedStabilityThreshold{ -1 };
+	// main.cpp's gamepadCheckInterval
+	static constexpr auto kConnectionCheckInterval{ std::chrono::milliseconds(250) };
+	std::chrono::steady_clock::time_point mNextConnectionCheck{};
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef PADCAST_PADRELAY_H
+#define PADCAST_PADRELAY_H
+
+#include "inputsource.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Pad relay over UDP, for two-PC streaming setups: the gaming PC runs
+// PadCast --daemon --relay-send <host> next to the pad, and the streaming PC
+// runs PadCast --relay-listen -, where the Receiver stands in for a local
+// gamepad (button map, STABILITY_THRESHOLD and drawing all happen there).
+//
+// The sender is given the pad every time it's read (about every millisecond
+// with --daemon, once a frame in the window) and sends a packet when the
+// state changes, again on the next kRepeats reads, and otherwise a heartbeat
+// every kHeartbeatMs. Each state
+// gets a sequence number, and every packet also carries the kRedundancy - 1
+// states before it, so one lost packet (or a few in a row) loses nothing: the
+// next one fills the gap, and a press and release that arrive together are
+// still shown for a frame. The repeats make sure a next one comes soon even
+// when the pad goes quiet after a change.
+//
+// Packet (little endian):
+//   char[4] magic "PCRL", u8 version, u8 state count, u8 name length,
+//   u8 reserved, u32 session (random per sender run), name bytes,
+//   then the states newest first, kStateBytes each:
+//   u32 sequence, u64 sender steady-clock microseconds, u8 flags (bit 0
+//   connected), u8 reserved, u32 buttons (bit n = raylib GamepadButton n),
+//   i16 axes[6] (-32767..32767)
+//
+// Linux only; elsewhere open() fails.
+namespace padrelay
+{
+	inline constexpr std::array<char, 4> kMagic{ 'P', 'C', 'R', 'L' };
+	inline constexpr uint8_t kVersion{ 1 };
+	inline constexpr int kDefaultPort{ 8766 };
+	inline constexpr size_t kRedundancy{ 4 };
+	inline constexpr size_t kHeaderBytes{ 12 };
+	inline constexpr size_t kStateBytes{ 30 };
+	inline constexpr size_t kMaxNameBytes{ 48 };
+	inline constexpr size_t kMaxPacketBytes{ kHeaderBytes + kMaxNameBytes + kRedundancy * kStateBytes };
+	inline constexpr int kRepeats{ 2 };
+	inline constexpr int kHeartbeatMs{ 100 };
+	// No packets for this long and the receiver reports the pad disconnected
+	inline constexpr int kTimeoutMs{ 1000 };
+
+	struct State
+	{
+		uint32_t sequence{ 0 };
+		uint64_t timeUs{ 0 };	// sender's steady clock
+		bool connected{ false };
+		uint32_t buttons{ 0 };
+		std::array<float, PadState::kAxisCount> axes{};
+	};
+
+	struct Packet
+	{
+		uint32_t session{ 0 };
+		std::string name;
+		std::array<State, kRedundancy> states{};	// newest first
+		size_t stateCount{ 0 };
+	};
+
+	// Returns the packet size; out must hold kMaxPacketBytes
+	size_t encode(const Packet& packet, uint8_t* out);
+	bool decode(const uint8_t* data, size_t size, Packet& out);
+
+	uint64_t nowUs();
+
+	class Sender
+	{
+	public:
+		Sender() = default;
+		~Sender() { close(); }
+
+		Sender(const Sender&) = delete;
+		Sender& operator=(const Sender&) = delete;
+
+		// target is host[:port], port defaulting to kDefaultPort (IPv4)
+		bool open(const std::string& target, std::string& error);
+		void close();
+		bool isOpen() const { return mSocket >= 0; }
+
+		// Sends if the state changed, a repeat or a heartbeat is due; cheap otherwise
+		void publish(bool connected, const PadState& pad, const char* name);
+
+		uint64_t getPacketsSent() const { return mPacketsSent; }
+		uint32_t getSequence() const { return mPacket.stateCount > 0 ? mPacket.states[0].sequence : 0; }
+
+	private:
+		void send();
+
+		int mSocket{ -1 };
+		Packet mPacket;	// the last kRedundancy states, as sent
+		uint64_t mLastSendUs{ 0 };
+		int mRepeatsLeft{ 0 };
+		uint64_t mPacketsSent{ 0 };
+	};
+
+	// Counters for --relay-listen's log line and the bench
+	struct ReceiverStats
+	{
+		uint64_t packets{ 0 };
+		uint64_t states{ 0 };		// applied, in order
+		uint64_t recovered{ 0 };	// applied from a later packet's redundant copy
+		uint64_t lost{ 0 };			// gaps too long for the redundancy to cover
+		uint64_t rejected{ 0 };		// not a relay packet
+		int64_t lastTransitUs{ 0 };	// receive time minus send time; only absolute on one machine
+	};
+
+	class Receiver final : public InputSource
+	{
+	public:
+		Receiver() = default;
+		~Receiver() override { close(); }
+
+		Receiver(const Receiver&) = delete;
+		Receiver& operator=(const Receiver&) = delete;
+
+		// listen is [address:]port, or "-" for kDefaultPort; the address defaults to 0.0.0.0
+		bool open(const std::string& listen, std::string& error);
+		void close();
+
+		void setIndex(int gamepad) { mIndex = gamepad; }
+		const ReceiverStats& getStats() const { return mStats; }
+
+		// Takes whatever has arrived; also done by sample(), so the late latch
+		// sees packets that came in during the frame
+		void receive();
+
+		// InputSource
+		void update() override;
+		bool isAvailable(int gamepad) const override;
+		const char* getName(int gamepad) const override;
+		PadState sample(int gamepad) override;
+		int getButtonPressed() const override { return mLastPressed; }
+		bool supportsIdle() const override { return false; }
+
+	private:
+		void apply(const State& state);
+
+		int mSocket{ -1 };
+		int mIndex{ 0 };
+		uint32_t mSession{ 0 };
+		uint32_t mLastSequence{ 0 };
+		std::chrono::steady_clock::time_point mLastPacket{};
+
+		bool mConnected{ false };
+		uint32_t mButtons{ 0 };
+		uint32_t mLatched{ 0 };			// pressed since the last frame, shown even if already released
+		uint32_t mLatchedSampled{ 0 };	// of those, the ones a sample() this frame has shown
+		std::array<float, PadState::kAxisCount> mAxes{};
+		std::string mName;
+		int mLastPressed{ 0 };
+
+		ReceiverStats mStats;
+	};
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef PADCAST_PADSHM_H
+#define PADCAST_PADSHM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Live pad state in shared memory: PadCast publishes what it just read from
+// the gamepad into a small named POSIX shared-memory object, so other local
+// overlays and scripts can follow the same pad without opening the device
+// themselves. Buttons are given both as raylib GamepadButtons and resolved
+// through PadCast's button map into the SNES buttons the overlay draws.
+//
+// The segment is one Segment struct. The Snapshot is guarded by a seqlock:
+// the writer makes Segment::sequence odd, stores the snapshot words, then
+// makes it even again; a reader copies the words out and retries if the
+// sequence was odd or changed meanwhile. Readers never write, so any number
+// of them can follow along, and a read is a 128 byte copy.
+//
+// Linux only; elsewhere nothing is published.
+namespace padshm
+{
+	inline constexpr std::array<char, 8> kMagic{ 'P', 'C', 'P', 'A', 'D', 'S', 'T', 'A' };
+	inline constexpr uint32_t kVersion{ 1 };
+	inline constexpr const char* kDefaultName{ "padcast-pad" };
+	inline constexpr int kAxisCount{ 6 };
+	inline constexpr size_t kNameBytes{ 64 };
+
+	// Bits of Snapshot::logicalButtons: the overlay's buttons, whatever
+	// physical button each is mapped to
+	enum Button : uint32_t
+	{
+		Up = 1u << 0,
+		Right = 1u << 1,
+		Down = 1u << 2,
+		Left = 1u << 3,
+		X = 1u << 4,
+		A = 1u << 5,
+		B = 1u << 6,
+		Y = 1u << 7,
+		L = 1u << 8,
+		R = 1u << 9,
+		Select = 1u << 10,
+		Start = 1u << 11
+	};
+
+	struct Snapshot
+	{
+		uint64_t sampleNs;			// CLOCK_MONOTONIC when the pad was read
+		uint64_t changedNs;			// ... when a button or the connection last changed
+		uint64_t updates;			// snapshots published so far
+		uint32_t logicalButtons;	// padshm::Button bits
+		uint32_t rawButtons;		// bit n = raylib GamepadButton n
+		int32_t gamepad;			// -1 when disconnected
+		uint32_t connected;
+		std::array<float, kAxisCount> axes;	// raylib GamepadAxis order, -1..1
+		std::array<char, kNameBytes> name;	// gamepad name, NUL terminated
+	};
+
+	inline constexpr size_t kSnapshotWords{ sizeof(Snapshot) / sizeof(uint64_t) };
+	static_assert(sizeof(Snapshot) % sizeof(uint64_t) == 0);
+	static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+	struct Segment
+	{
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t snapshotBytes;
+		uint32_t writerPid;
+		std::atomic<uint32_t> closed;	// writer has gone away
+
+		alignas(64) std::atomic<uint64_t> sequence;	// odd while the snapshot is being written
+		// The Snapshot, stored word by word so concurrent reads aren't a data race
+		std::array<std::atomic<uint64_t>, kSnapshotWords> words;
+	};
+
+	// Render thread side
+	class Writer
+	{
+	public:
+		Writer() = default;
+		~Writer() { close(); }
+
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		// Fails with error set if another running writer already has the name
+		bool create(const std::string& name, std::string& error);
+		// Marks the segment closed and unlinks the name
+		void close();
+		bool isOpen() const { return mSegment != nullptr; }
+
+		// Cheap enough to call every frame: a few dozen stores, no syscalls.
+		// Does nothing if the segment isn't open. name may be null.
+		void publish(bool connected, int gamepad, uint32_t logicalButtons, uint32_t rawButtons,
+		             const std::array<float, kAxisCount>& axes, const char* name);
+
+	private:
+		Segment* mSegment{ nullptr };
+		std::string mName;
+		Snapshot mSnapshot{};
+	};
+
+	// Consumer side
+	class Reader
+	{
+	public:
+		Reader() = default;
+		~Reader() { close(); }
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		bool open(const std::string& name, std::string& error);
+		void close();
+		bool isOpen() const { return mSegment != nullptr; }
+
+		// Consistent copy of the current snapshot; false only if the writer
+		// kept it busy for the whole retry budget
+		bool read(Snapshot& out) const;
+		// Changes whenever a snapshot is published; compare to skip unchanged reads
+		uint64_t sequence() const { return mSegment->sequence.load(std::memory_order_acquire); }
+		bool writerClosed() const { return mSegment->closed.load(std::memory_order_acquire) != 0; }
+
+	private:
+		const Segment* mSegment{ nullptr };
+	};
+}
+
+#endif
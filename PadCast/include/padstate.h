@@ -0,0 +1,45 @@
+#ifndef PADCAST_PADSTATE_H
+#define PADCAST_PADSTATE_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Snapshot of one gamepad: which raylib GamepadButtons are held plus the six
+// standard axes. The overlay draws from one of these instead of querying
+// raylib button by button, so the state can be captured at a chosen moment.
+struct PadState
+{
+	static constexpr int kAxisCount{ 6 };
+
+	int gamepad{ -1 };
+	uint32_t buttons{ 0 };	// bit n set = GamepadButton n is down
+	std::array<float, kAxisCount> axes{};
+
+	bool isDown(int button) const
+	{
+		return button > 0 && button < 32 && (buttons & (1u << button)) != 0;
+	}
+
+	// What raylib saw at the last PollInputEvents() (i.e. the end of the previous frame)
+	static PadState fromRaylib(int gamepad);
+	// Read from the device now, bypassing raylib's per-frame poll.
+	// Falls back to fromRaylib() if GLFW has no gamepad mapping for the device.
+	static PadState sampleNow(int gamepad);
+};
+
+#endif
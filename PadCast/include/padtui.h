@@ -0,0 +1,25 @@
+#ifndef PADCAST_PADTUI_H
+#define PADCAST_PADTUI_H
+
+#include <string>
+
+class Config;
+class InputSource;
+
+// --tui: PadCast's input pipeline (InputSource -> PadMapper) drawn in the
+// terminal, for checking a pad and its button map over SSH or on a machine
+// with no X11/Wayland session or GPU.
+//
+// The SNES layout is drawn from ButtonMap::defaultSNESIndex with Unicode half
+// blocks ("▀", one cell = two square pixels) and 256-colour ANSI escapes. A
+// frame is only composed when the pad state or the terminal size changes,
+// and only the cells that differ from what's on screen are written.
+class PadTui
+{
+public:
+	// Runs until q, SIGINT or SIGTERM; returns the process exit code.
+	// inputLabel says where the pad is read from (shown in the status lines).
+	int run(Config& config, InputSource& input, const std::string& inputLabel);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PADCAST_PERFHUD_H
+#define PADCAST_PERFHUD_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include "framepacer.h"
+#include "gputimer.h"
+#include "textcache.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Toggleable (F3) overlay showing what PadCast itself costs: frame-time
+// percentiles and graph, CPU time per loop phase, GPU time, texture memory
+// and presents skipped in VRR mode. Nothing is measured while it's hidden.
+class PerfHUD
+{
+public:
+	enum class Phase
+	{
+		Input,		// menu input, connection checks, pad sampling
+		Overlay,	// base image and pressed buttons
+		Menu,		// menu / remap screens
+		Wait,		// frame pacer sleeping
+		Present,	// EndDrawing: swap and event poll
+		Count
+	};
+
+	void toggle();
+	bool isVisible() const { return mVisible; }
+
+	// Phases are sequential: entering one ends the previous
+	void beginFrame();
+	void enter(Phase phase);
+	void endFrame();
+
+	// GPU time segments; pause around CPU waits so they aren't counted
+	void beginGpu() { if (mVisible) mGpuTimer.begin(); }
+	void endGpu() { mGpuTimer.end(); }
+
+	void countSkippedPresent() { ++mSkippedPresents; }
+
+	void draw(TextCache& textCache, const FramePacer& pacer, size_t textureBytes, int screenWidth);
+
+private:
+	using Clock = std::chrono::steady_clock;
+	static constexpr size_t kPhaseCount{ static_cast<size_t>(Phase::Count) };
+
+	void closePhase(Clock::time_point now);
+
+	bool mVisible{ false };
+	Phase mPhase{ Phase::Count };
+	Clock::time_point mPhaseStart{};
+	std::array<double, kPhaseCount> mFrameMs{};		// this frame
+	std::array<double, kPhaseCount> mAverageMs{};	// smoothed over recent frames
+	GpuTimer mGpuTimer;
+	uint64_t mSkippedPresents{ 0 };
+	std::array<float, FramePacer::kHistorySize> mSorted{};
+};
+
+#endif
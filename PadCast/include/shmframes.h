@@ -0,0 +1,154 @@
+#ifndef PADCAST_SHMFRAMES_H
+#define PADCAST_SHMFRAMES_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Shared-memory frame ring: PadCast publishes each composed overlay frame into
+// a named POSIX shared-memory object, and local consumers (capture plugins,
+// ffmpeg wrappers, tests) map it and read the pixels in place -- no socket,
+// pipe or extra copy on the reading side.
+//
+// Layout (all little-endian, the machine's own):
+//
+//   [0, kHeaderBytes)             Header
+//   then slotCount slots of slotBytes each:
+//     [0, kSlotHeaderBytes)       SlotHeader
+//     then height rows of stride bytes, top-down RGBA8
+//
+// Frame n goes to slot n % slotCount. Each slot is a seqlock: its sequence is
+// 2n+1 while frame n is being written and 2n+2 once it's complete, so a reader
+// that finds the same even value before and after using the pixels knows they
+// weren't overwritten meanwhile. Header::published counts finished frames, and
+// Header::futex is bumped with it so readers can sleep in FUTEX_WAIT until the
+// next one (Linux only; elsewhere nothing is published).
+namespace shmframes
+{
+	inline constexpr std::array<char, 8> kMagic{ 'P', 'C', 'F', 'R', 'A', 'M', 'E', 'S' };
+	inline constexpr uint32_t kVersion{ 1 };
+	inline constexpr size_t kHeaderBytes{ 4096 };
+	inline constexpr size_t kSlotHeaderBytes{ 64 };
+	inline constexpr uint32_t kDefaultSlots{ 4 };
+	inline constexpr const char* kDefaultName{ "padcast-frames" };
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+		"shared-memory atomics must be lock-free");
+
+	struct Header
+	{
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t headerBytes;
+		uint32_t width;
+		uint32_t height;
+		uint32_t stride;		// bytes per row
+		uint32_t slotCount;
+		uint64_t slotBytes;		// slot header + pixels, page aligned
+		uint32_t fpsNumerator;
+		uint32_t fpsDenominator;
+		uint32_t writerPid;
+
+		alignas(64) std::atomic<uint64_t> published;	// frames finished so far; newest is published - 1
+		std::atomic<uint32_t> futex;		// bumped after every frame; what readers FUTEX_WAIT on
+		std::atomic<uint32_t> waiters;		// readers inside FUTEX_WAIT, so the writer can skip the wake
+		std::atomic<uint32_t> closed;		// writer has gone away
+	};
+	static_assert(sizeof(Header) <= kHeaderBytes);
+
+	struct SlotHeader
+	{
+		std::atomic<uint64_t> sequence;	// 2n+1 while frame n is written, 2n+2 when done
+		uint64_t frame;
+		uint64_t timestampNs;			// CLOCK_MONOTONIC when the frame was published
+	};
+	static_assert(sizeof(SlotHeader) <= kSlotHeaderBytes);
+
+	// CLOCK_MONOTONIC in ns (what timestampNs is measured against)
+	uint64_t monotonicNs();
+
+	// Creates a writer's shared-memory object (e.g. "/padcast-frames") and
+	// returns its descriptor, or -1 with error set. An object left behind by a
+	// writer that has exited is replaced; one whose writer is still running is
+	// not, so a second PadCast can't wipe a ring out from under live readers.
+	// The writer's pid is the uint32_t at pidOffset. Also used by padshm.
+	int createObject(const std::string& object, size_t pidOffset, std::string& error);
+
+	// Render thread side
+	class Writer
+	{
+	public:
+		Writer() = default;
+		~Writer() { close(); }
+
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		// Creates (or takes over a stale) shared-memory object called name.
+		// On failure error says why.
+		bool create(const std::string& name, uint32_t width, uint32_t height,
+		            uint32_t fpsNumerator, uint32_t fpsDenominator, std::string& error,
+		            uint32_t slots = kDefaultSlots);
+		// Marks the ring closed, wakes readers and unlinks the name
+		void close();
+		bool isOpen() const { return mHeader != nullptr; }
+
+		// Pixels of the next frame's slot (top-down rows of getStride() bytes)
+		uint8_t* beginFrame();
+		// Publishes what was written since beginFrame()
+		void endFrame();
+
+		uint32_t getStride() const { return mHeader ? mHeader->stride : 0; }
+		uint32_t getHeight() const { return mHeader ? mHeader->height : 0; }
+
+	private:
+		Header* mHeader{ nullptr };
+		uint8_t* mBase{ nullptr };
+		size_t mSize{ 0 };
+		std::string mName;
+		SlotHeader* mCurrent{ nullptr };
+	};
+
+	// Consumer side
+	class Reader
+	{
+	public:
+		struct Frame
+		{
+			const uint8_t* pixels{ nullptr };
+			uint64_t frame{ 0 };
+			uint64_t timestampNs{ 0 };
+			uint64_t sequence{ 0 };
+			const SlotHeader* slot{ nullptr };
+		};
+
+		Reader() = default;
+		~Reader() { close(); }
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		bool open(const std::string& name, std::string& error);
+		void close();
+		bool isOpen() const { return mHeader != nullptr; }
+		const Header& header() const { return *mHeader; }
+
+		// Sleeps until more than `after` frames have been published (true), the
+		// timeout passes or the writer closes (false). timeoutMs < 0 waits forever.
+		bool waitForFrame(uint64_t after, int timeoutMs);
+		// Newest complete frame, in place; false if none yet
+		bool latest(Frame& frame) const;
+		// True if frame's pixels weren't overwritten while they were being used
+		bool stillValid(const Frame& frame) const;
+		bool writerClosed() const { return mHeader->closed.load(std::memory_order_acquire) != 0; }
+
+	private:
+		Header* mHeader{ nullptr };		// mapped writable for Header::waiters
+		const uint8_t* mBase{ nullptr };
+		size_t mSize{ 0 };
+	};
+}
+
+#endif
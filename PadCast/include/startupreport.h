@@ -0,0 +1,56 @@
+#ifndef PADCAST_STARTUPREPORT_H
+#define PADCAST_STARTUPREPORT_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Time from entering main() to each startup milestone, logged once as a
+// single line so the time to first frame can be checked after a restart.
+// With --profile-startup tracing is on from the first line of main() and
+// printProfile() breaks the time down by every trace span on the main thread.
+class StartupReport
+{
+public:
+	enum class Phase
+	{
+		Window,			// window and GL context created
+		Resources,		// textures, font and menus loaded
+		FirstFrame,		// first frame presented
+		GamepadReady,	// overlay live
+		Count
+	};
+
+	StartupReport();
+
+	// Only the first mark of each phase counts
+	void mark(Phase phase);
+	bool isMarked(Phase phase) const { return mMarked[static_cast<size_t>(phase)]; }
+	double elapsedMs(Phase phase) const;
+
+	// Logs the milestones reached so far; does nothing after the first call
+	void log();
+
+	// Full breakdown up to the first frame, to stdout
+	void printProfile(const char* cacheState) const;
+
+	// Drops the files under path from the OS page cache so the next read comes
+	// from disk. Returns false if nothing was dropped, if any file couldn't be
+	// opened or advised, or where unsupported (Linux only).
+	static bool evictFromFileCache(const std::string& path);
+
+private:
+	using Clock = std::chrono::steady_clock;
+	static constexpr size_t kPhaseCount{ static_cast<size_t>(Phase::Count) };
+
+	Clock::time_point mStart;
+	uint64_t mStartTraceNs{ 0 };
+	std::array<Clock::time_point, kPhaseCount> mTimes{};
+	std::array<uint64_t, kPhaseCount> mTraceNs{};
+	std::array<bool, kPhaseCount> mMarked{};
+	bool mLogged{ false };
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef PADCAST_TASKQUEUE_H
+#define PADCAST_TASKQUEUE_H
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <utility>
+
+// A unit of deferred main-thread work, written as a coroutine. Each
+// co_await TaskQueue::slice() ends a slice; the queue resumes it later in the
+// same frame if there's budget left, otherwise next frame.
+//
+//     DeferredTask reload(Config& config)
+//     {
+//         config.reloadConfig();
+//         co_await TaskQueue::slice();
+//         ...apply it...
+//     }
+class DeferredTask
+{
+public:
+	struct promise_type
+	{
+		DeferredTask get_return_object()
+		{
+			return DeferredTask{ std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+		// Nothing runs until the queue gets to it
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	DeferredTask(DeferredTask&& other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+	DeferredTask& operator=(DeferredTask&& other) noexcept
+	{
+		if (this != &other)
+		{
+			destroy();
+			mHandle = std::exchange(other.mHandle, nullptr);
+		}
+		return *this;
+	}
+	DeferredTask(const DeferredTask&) = delete;
+	DeferredTask& operator=(const DeferredTask&) = delete;
+	~DeferredTask() { destroy(); }
+
+	bool done() const { return !mHandle || mHandle.done(); }
+	void resume() { mHandle.resume(); }
+
+private:
+	explicit DeferredTask(std::coroutine_handle<promise_type> handle) : mHandle(handle) {}
+
+	void destroy()
+	{
+		if (mHandle)
+		{
+			mHandle.destroy();
+			mHandle = nullptr;
+		}
+	}
+
+	std::coroutine_handle<promise_type> mHandle;
+};
+
+// Main-thread queue of DeferredTasks run under a per-frame time budget, so a
+// config reload or a save spreads over a few frames instead of making one long one.
+// Slices are never interrupted: keep the work between two co_awaits short.
+class TaskQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static std::suspend_always slice() { return {}; }
+
+	void post(DeferredTask task) { mTasks.push_back(std::move(task)); }
+
+	// Resume queued tasks round-robin until the budget is spent. At least one
+	// slice runs per call so work always makes progress.
+	void run(Clock::duration budget);
+	// Run everything to completion, ignoring the budget (shutdown)
+	void drain();
+
+	bool empty() const { return mTasks.empty(); }
+	size_t size() const { return mTasks.size(); }
+
+private:
+	std::deque<DeferredTask> mTasks;
+};
+
+#endif
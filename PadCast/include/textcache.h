@@ -0,0 +1,100 @@
+#ifndef PADCAST_TEXTCACHE_H
+#define PADCAST_TEXTCACHE_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include "uifont.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// All UI text goes through here. Glyphs come from the SDF atlas in UIFont so
+// nothing is re-rasterized on resize; what's cached is the measured size of
+// each (string, font size) pair, which the menus and remap prompts use for
+// layout every frame.
+// Wrap draw() calls in begin()/end() so a run of strings is one draw call.
+class TextCache
+{
+public:
+	TextCache() = default;
+
+	TextCache(const TextCache&) = delete;
+	TextCache& operator=(const TextCache&) = delete;
+
+	void begin() const { mFont.begin(); }
+	void end() const { mFont.end(); }
+
+	void draw(const char* text, int posX, int posY, int fontSize, Color tint) const;
+	int measure(const char* text, int fontSize);
+
+	size_t memoryBytes() const { return mFont.memoryBytes(); }
+
+	// Call on window resize -- every cached size is stale at that point anyway
+	void clear() { mEntries.clear(); }
+
+private:
+	struct Entry
+	{
+		int width{};
+		int height{};
+	};
+
+	// Lets find() take a string_view so per-frame lookups don't build a std::string
+	struct KeyView
+	{
+		std::string_view text;
+		int fontSize;
+	};
+
+	struct KeyHash
+	{
+		using is_transparent = void;
+		size_t operator()(const KeyView& key) const
+		{
+			return std::hash<std::string_view>{}(key.text) ^ (static_cast<size_t>(key.fontSize) << 1);
+		}
+		size_t operator()(const std::pair<std::string, int>& key) const
+		{
+			return (*this)(KeyView{ key.first, key.second });
+		}
+	};
+
+	struct KeyEqual
+	{
+		using is_transparent = void;
+		static KeyView view(const KeyView& key) { return key; }
+		static KeyView view(const std::pair<std::string, int>& key) { return { key.first, key.second }; }
+
+		template <typename A, typename B>
+		bool operator()(const A& a, const B& b) const
+		{
+			return view(a).fontSize == view(b).fontSize && view(a).text == view(b).text;
+		}
+	};
+
+	// Labels only change on menu transitions so this is plenty; going over it
+	// just means a stale set of labels gets thrown out
+	static constexpr size_t kMaxEntries{ 64 };
+
+	const Entry& getEntry(const char* text, int fontSize);
+
+	UIFont mFont;
+	std::unordered_map<std::pair<std::string, int>, Entry, KeyHash, KeyEqual> mEntries;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef PADCAST_TRACE_H
+#define PADCAST_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Scoped trace markers for offline hitch analysis. Each thread records into
+// its own preallocated ring buffer (no locks, no allocation per event) and
+// dump() writes everything still in the rings as Chrome trace JSON, which
+// chrome://tracing and ui.perfetto.dev both open. A thread's ring is reused
+// after it exits; its events are copied out first (kept up to one ring's
+// worth across all exited threads), so short-lived worker threads still
+// show up without each keeping a ring.
+//
+// While tracing is off a marker costs one relaxed atomic load, so they stay
+// compiled into release builds.
+//
+//     void save()
+//     {
+//         PADCAST_TRACE_SCOPE("Config::saveConfig");
+//         ...
+//     }
+namespace trace
+{
+	namespace detail
+	{
+		extern std::atomic<bool> gEnabled;
+		uint64_t now();
+		void record(const char* name, uint64_t startNs, uint64_t endNs);
+	}
+
+	inline bool isEnabled() { return detail::gEnabled.load(std::memory_order_relaxed); }
+
+	// For spans that don't fit a scope: take now() at the start, record() at the end
+	inline uint64_t now() { return detail::now(); }
+	inline void record(const char* name, uint64_t startNs)
+	{
+		if (isEnabled())
+		{
+			detail::record(name, startNs, detail::now());
+		}
+	}
+	void setEnabled(bool enabled);
+
+	// Shown as the track name in the viewer
+	void setThreadName(const char* name);
+
+	// Writes every thread's ring to path. Returns false if the file can't be written.
+	bool dump(const std::string& path);
+
+	// Events recorded so far on the calling thread, oldest first (by end time)
+	using Visitor = std::function<void(const char* name, uint64_t startNs, uint64_t endNs)>;
+	void visitThisThread(const Visitor& visitor);
+
+	// name must outlive the trace (string literals)
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name)
+			: mName(isEnabled() ? name : nullptr)
+			, mStart(mName ? detail::now() : 0)
+		{
+		}
+		~Scope()
+		{
+			if (mName)
+			{
+				detail::record(mName, mStart, detail::now());
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* mName;
+		uint64_t mStart;
+	};
+}
+
+#define PADCAST_TRACE_CONCAT_INNER(a, b) a##b
+#define PADCAST_TRACE_CONCAT(a, b) PADCAST_TRACE_CONCAT_INNER(a, b)
+#define PADCAST_TRACE_SCOPE(name) ::trace::Scope PADCAST_TRACE_CONCAT(padcastTraceScope, __LINE__){ name }
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef PADCAST_UIFONT_H
+#define PADCAST_UIFONT_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include <cstddef>
+
+// Signed-distance-field font built from the bundled TTF at startup.
+// The SDF shader keeps glyph edges sharp at any size, so the atlas is generated
+// once and never re-rasterized, and every string shares the same texture --
+// anything drawn between begin() and end() lands in a single batch.
+// If the TTF can't be loaded this falls back to raylib's default bitmap font.
+class UIFont
+{
+public:
+	UIFont();
+	~UIFont();
+
+	UIFont(const UIFont&) = delete;
+	UIFont& operator=(const UIFont&) = delete;
+
+	void begin() const;
+	void end() const;
+
+	void draw(const char* text, Vector2 position, float fontSize, Color tint) const;
+	Vector2 measure(const char* text, float fontSize) const;
+
+	bool isSDF() const { return mIsSDF; }
+	size_t memoryBytes() const
+	{
+		return static_cast<size_t>(GetPixelDataSize(mFont.texture.width, mFont.texture.height, mFont.texture.format));
+	}
+
+private:
+	// Size glyphs are rendered at in the atlas; the SDF handles scaling from here
+	static constexpr int kAtlasFontSize{ 32 };
+	static constexpr int kGlyphCount{ 95 }; // printable ASCII
+
+	float spacingFor(float fontSize) const { return mIsSDF ? fontSize / 20.0f : fontSize / 10.0f; }
+
+	Font mFont{};
+	Shader mShader{};
+	bool mIsSDF{ false };
+};
+
+#endif
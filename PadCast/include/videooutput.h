@@ -0,0 +1,133 @@
+#ifndef PADCAST_VIDEOOUTPUT_H
+#define PADCAST_VIDEOOUTPUT_H
+
+#ifdef _WIN32
+	#define NOGDI
+	#define NOUSER
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+	#undef NOGDI
+	#undef NOUSER
+#endif
+
+#include "shmframes.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams the overlay as raw video to stdout or a file/named pipe, for capture
+// setups that read ffmpeg/GStreamer input instead of grabbing the window.
+//
+// Each frame is drawn into an offscreen target of the stream's size
+// (beginFrame()/endFrame()). endFrame() starts an asynchronous readback into
+// one of two pixel buffer objects and maps the other one, which holds the
+// previous frame and has had a whole frame to finish -- so the render loop
+// never waits on the GPU. The pixels are copied into a free buffer and a
+// writer thread converts and writes them; if the reader can't keep up, frames
+// are dropped rather than stalling the loop.
+//
+// Formats:
+//   Y4m   YUV4MPEG2, 4:2:0 (see y4m.h)
+//   Rgba  a kRgbaHeaderSize byte header, then top-down RGBA8 frames:
+//           "PCRAWVID", then little-endian uint32 width, height,
+//           frame rate numerator, denominator, bytes per pixel (4), 0
+//   Shm   no file: frames are published into the shared-memory ring named by
+//         path (see shmframes.h), copied straight out of the mapped pixel
+//         buffer with no writer thread; local readers take them in place
+class VideoOutput
+{
+public:
+	enum class Format
+	{
+		Y4m,
+		Rgba,
+		Shm
+	};
+
+	static constexpr size_t kRgbaHeaderSize{ 32 };
+
+	VideoOutput() = default;
+	~VideoOutput() { close(); }
+
+	VideoOutput(const VideoOutput&) = delete;
+	VideoOutput& operator=(const VideoOutput&) = delete;
+
+	// Main thread, GL context current. path "-" is stdout. The file is opened
+	// by the writer thread, so a named pipe with no reader yet doesn't block
+	// startup; frames are skipped until it connects.
+	bool open(const std::string& path, Format format, int width, int height, double fps);
+	void close();
+	bool isOpen() const { return mTarget.id != 0; }
+	bool isShared() const { return mShared.isOpen(); }
+
+	// Inside BeginDrawing(): the stream's frame is drawn between these two
+	void beginFrame();
+	void endFrame();
+
+	int getWidth() const { return mWidth; }
+	int getHeight() const { return mHeight; }
+	uint64_t getFramesWritten() const { return mWritten.load(std::memory_order_relaxed); }
+	uint64_t getFramesDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+	// For "-": raylib's log and std::cout go to stderr so they don't end up in the stream
+	static void moveLogsToStderr();
+
+private:
+	void collect(size_t pbo);
+	void queueFrame(const uint8_t* pixels);
+	void publishFrame(const uint8_t* pixels);
+	void run();
+	bool writeHeader();
+	bool writeFrame(const std::vector<uint8_t>& pixels);
+
+	// Frames copied out of GL waiting for the writer, plus one being written
+	static constexpr size_t kBufferCount{ 3 };
+
+	RenderTexture2D mTarget{};
+	int mWidth{ 0 };
+	int mHeight{ 0 };
+	double mFps{ 60.0 };
+	Format mFormat{ Format::Y4m };
+	std::string mPath;
+
+	bool mUsePbo{ false };
+	std::array<unsigned int, 2> mPbo{};
+	std::array<bool, 2> mPboPending{};
+	uint64_t mFrameIndex{ 0 };
+	std::vector<uint8_t> mSyncPixels;	// readback target when PBOs aren't available
+	shmframes::Writer mShared;			// Format::Shm
+
+	std::array<std::vector<uint8_t>, kBufferCount> mBuffers;
+	std::deque<size_t> mFree;
+	std::deque<size_t> mReady;
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	bool mStopping{ false };
+	std::thread mThread;
+
+	// Writer thread
+	std::FILE* mFile{ nullptr };
+	std::vector<uint8_t> mEncoded;
+	std::vector<char> mFileBuffer;
+
+	std::atomic<bool> mOpening{ false };	// writer is inside fopen()
+	std::atomic<bool> mFinished{ false };	// writer thread is about to exit
+	std::atomic<bool> mStreaming{ false };	// file open and header written
+	std::atomic<uint64_t> mWritten{ 0 };
+	std::atomic<uint64_t> mDropped{ 0 };
+};
+
+#endif
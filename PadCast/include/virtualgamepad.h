@@ -0,0 +1,109 @@
+#ifndef PADCAST_VIRTUALGAMEPAD_H
+#define PADCAST_VIRTUALGAMEPAD_H
+
+#include "inputsource.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scripted gamepad for deterministic runs. A timeline of presses, releases,
+// axis moves and (dis)connects is replayed against a clock, so remapping,
+// press latching, the disconnect debounce (STABILITY_THRESHOLD) and frame
+// cost can be exercised without hardware.
+//
+// Script format, one command per line, times in milliseconds from start:
+//
+//     # comments and blank lines are ignored
+//     index 0                  which gamepad index the pad shows up at
+//     fixed_step 16.667        advance the clock by this much per update()
+//                              instead of following wall time
+//     loop 2000                restart the timeline every 2000 ms
+//     0     connect
+//     100   press A            buttons: UP DOWN LEFT RIGHT A B X Y L R L2 R2
+//     180   release A                   SELECT START GUIDE L3 R3, or a raylib number
+//     250   axis 4 1.0         axis index, value
+//     400   disconnect
+//     430   connect
+//     500   glitch 40          disconnect for 40 ms
+//     1000  storm 500 30 A B   press/release A and B alternately at 30 Hz for 500 ms
+//
+// The pad starts disconnected unless the script connects it, and presses
+// while it's disconnected are dropped, as they would be on hardware.
+class VirtualGamepad final : public InputSource
+{
+public:
+	enum class EventType : uint8_t
+	{
+		Press,
+		Release,
+		Axis,
+		Connect,
+		Disconnect
+	};
+
+	struct Event
+	{
+		double timeMs{};
+		EventType type{};
+		int code{};		// button or axis
+		float value{};	// axis value
+	};
+
+	VirtualGamepad();
+
+	// Replaces the timeline. On failure error says which line was bad.
+	bool loadScript(const std::string& path, std::string& error);
+	bool parseScript(const std::string& text, std::string& error);
+
+	// Building a timeline from code
+	void add(const Event& event);
+	void addStorm(double startMs, double durationMs, double rateHz, const std::vector<int>& buttons);
+	void setIndex(int gamepad) { mIndex = gamepad; }
+	void setLoop(double periodMs) { mLoopMs = periodMs; }
+	void setFixedStep(double stepMs) { mFixedStepMs = stepMs; }
+	void restart();
+
+	// InputSource
+	void update() override;
+	bool isAvailable(int gamepad) const override { return mConnected && gamepad == mIndex; }
+	const char* getName(int gamepad) const override;
+	PadState sample(int gamepad) override;
+	int getButtonPressed() const override { return mLastPressed; }
+	bool supportsIdle() const override { return false; }
+
+	double getTimeMs() const { return mNowMs; }
+	bool isFinished() const { return mLoopMs <= 0.0 && mNext >= mEvents.size(); }
+	const std::vector<Event>& getEvents() const { return mEvents; }
+
+	// Name or number -> raylib GamepadButton, -1 if unknown
+	static int parseButton(const std::string& name);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void sortEvents();
+	void advanceTo(double timeMs);
+	void apply(const Event& event);
+
+	std::vector<Event> mEvents;
+	size_t mNext{ 0 };
+	bool mSorted{ true };
+
+	int mIndex{ 0 };
+	double mLoopMs{ 0.0 };
+	double mFixedStepMs{ 0.0 };
+
+	Clock::time_point mStart{};
+	double mNowMs{ 0.0 };
+	double mLoopBaseMs{ 0.0 };	// start of the current loop iteration
+
+	bool mConnected{ false };
+	uint32_t mButtons{ 0 };
+	std::array<float, PadState::kAxisCount> mAxes{};
+	int mLastPressed{ 0 };
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef PADCAST_WORKPOOL_H
+#define PADCAST_WORKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for CPU-heavy batch work (frame encoding).
+//
+// Every worker owns a deque. Tasks submitted from outside the pool are dealt
+// round-robin; a task submitted from a worker goes on that worker's own deque.
+// A worker takes its newest task first (still warm in its cache) and, once its
+// deque is empty, steals the oldest task from another worker, so uneven task
+// costs don't leave cores idle while one queue is backed up.
+class WorkStealingPool
+{
+public:
+	using Task = std::function<void()>;
+
+	// 0 = one worker per hardware thread
+	explicit WorkStealingPool(unsigned int threads = 0);
+	// Runs everything already submitted, then joins the workers
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	void submit(Task task);
+	// Blocks until every submitted task has finished
+	void waitIdle();
+
+	unsigned int size() const { return static_cast<unsigned int>(mThreads.size()); }
+	// Tasks taken from another worker's deque so far
+	size_t getSteals() const { return mSteals.load(std::memory_order_relaxed); }
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void run(unsigned int index);
+	bool popLocal(unsigned int index, Task& task);
+	bool steal(unsigned int thief, Task& task);
+
+	std::vector<std::unique_ptr<Queue>> mQueues;
+	std::vector<std::thread> mThreads;
+	std::atomic<size_t> mNextQueue{ 0 };
+
+	std::atomic<size_t> mQueued{ 0 };		// submitted, not yet taken
+	std::atomic<size_t> mUnfinished{ 0 };	// submitted, not yet finished
+	std::atomic<size_t> mSteals{ 0 };
+	bool mStopping{ false };
+	std::mutex mSleepMutex;
+	std::condition_variable mWake;
+	std::condition_variable mIdle;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef PADCAST_WSSERVER_H
+#define PADCAST_WSSERVER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Small HTTP + WebSocket (RFC 6455) server for --daemon: serves the browser
+// renderer and the overlay images, and pushes pad updates to every connected
+// WebSocket. Everything runs on the caller's thread from one epoll set, so a
+// few hundred clients cost one thread and no locks.
+//
+// An update is framed once per format and the same shared buffer is queued
+// on every client; sockets that can't take it right away keep their place in
+// it and get EPOLLOUT. Updates are whole states, so a client that falls far
+// behind just has its backlog replaced by the newest one.
+//
+//   GET /                   index.html from the web root
+//   GET /<file>             other files from the web root
+//   GET /images/<file>      the overlay images
+//   GET /ws                 WebSocket, JSON text messages
+//   GET /ws?format=binary   WebSocket, binary messages
+//
+// Linux only (epoll); start() fails elsewhere.
+class WebSocketServer
+{
+public:
+	enum class Format
+	{
+		Json,
+		Binary
+	};
+
+	struct Settings
+	{
+		std::string bindAddress{ "127.0.0.1" };
+		int port{ 8765 };
+		std::filesystem::path webRoot;
+		std::filesystem::path imageRoot;
+	};
+
+	WebSocketServer() = default;
+	~WebSocketServer() { stop(); }
+
+	WebSocketServer(const WebSocketServer&) = delete;
+	WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+	bool start(const Settings& settings, std::string& error);
+	void stop();
+	bool isRunning() const { return mEpoll >= 0; }
+
+	// Handles whatever socket activity arrives within timeoutMs
+	void poll(int timeoutMs);
+
+	// Sends one update to every WebSocket client, and to later ones when they connect
+	void broadcast(std::string_view json, std::string_view binary);
+
+	size_t getClientCount() const { return mClients; }
+	uint64_t getMessagesSent() const { return mSent; }
+
+private:
+	using Buffer = std::shared_ptr<const std::string>;
+
+	struct Connection
+	{
+		int fd{ -1 };
+		bool upgraded{ false };
+		Format format{ Format::Json };
+		bool closeAfterFlush{ false };
+		bool writeInterest{ false };
+		std::string input;
+		std::deque<Buffer> output;
+		size_t outputOffset{ 0 };	// bytes of output.front() already sent
+	};
+
+	void acceptClients();
+	void onReadable(Connection& connection);
+	void handleRequest(Connection& connection, std::string_view request);
+	void handleFrames(Connection& connection);
+	void queue(Connection& connection, Buffer buffer);
+	void flush(Connection& connection);
+	void setWriteInterest(Connection& connection, bool wanted);
+	void respond(Connection& connection, int status, std::string_view type, std::string_view body);
+	void serveFile(Connection& connection, const std::filesystem::path& path);
+	void drop(Connection& connection);
+
+	static std::string frame(uint8_t opcode, std::string_view payload);
+
+	// Past this, a client's queued updates are collapsed into the newest
+	static constexpr size_t kMaxQueued{ 64 };
+	static constexpr size_t kMaxRequestBytes{ 8192 };
+	static constexpr size_t kMaxMessageBytes{ 65536 };
+
+	Settings mSettings;
+	int mListen{ -1 };
+	int mEpoll{ -1 };
+	std::unordered_map<int, Connection> mConnections;
+	std::vector<int> mClosing;	// closed at the end of poll(), not mid-iteration
+	std::array<Buffer, 2> mLatest;	// newest update per Format
+	size_t mClients{ 0 };
+	uint64_t mSent{ 0 };
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PADCAST_Y4M_H
+#define PADCAST_Y4M_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// YUV4MPEG2 (.y4m) writing, the uncompressed stream format ffmpeg and
+// GStreamer read from files and pipes. Frames are 4:2:0, BT.709, limited range.
+namespace y4m
+{
+	// Stream header line. Width and height must be even.
+	std::string header(int width, int height, double fps);
+
+	// Converts one RGBA frame into a "FRAME" record (tag and planes), replacing
+	// out's contents. rowStride is the byte step from one row to the next going
+	// down the image; pass the last row and a negative stride for GL's bottom-up
+	// readback.
+	void encodeFrame(const uint8_t* firstRow, ptrdiff_t rowStride, int width, int height,
+	                 std::vector<uint8_t>& out);
+
+	// Y4M wants a ratio; 29.97 and friends come out as n/1000
+	void frameRate(double fps, long long& numerator, long long& denominator);
+}
+
+#endif
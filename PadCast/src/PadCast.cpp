@@ -7,6 +7,7 @@
 
 #include "PadCast.h"
 #include "Gamepad.hpp"
+#include "trace.h"
 
 #ifdef _WIN32
     #undef NOGDI
@@ -16,22 +17,60 @@
 #include <iostream>
 
 GamepadTextures::GamepadTextures()
-: unpressed(PathManager::getResourcePath("images/controller.png"))
-, pressedA(PathManager::getResourcePath("images/pressed/A.png"))
-, pressedB(PathManager::getResourcePath("images/pressed/B.png"))
-, pressedX(PathManager::getResourcePath("images/pressed/X.png"))
-, pressedY(PathManager::getResourcePath("images/pressed/Y.png"))
-, pressedUp(PathManager::getResourcePath("images/pressed/up.png"))
-, pressedLeft(PathManager::getResourcePath("images/pressed/left.png"))
-, pressedDown(PathManager::getResourcePath("images/pressed/down.png"))
-, pressedRight(PathManager::getResourcePath("images/pressed/right.png"))
-, pressedStart(PathManager::getResourcePath("images/pressed/start.png"))
-, pressedSelect(PathManager::getResourcePath("images/pressed/select.png"))
-, pressedLBump(PathManager::getResourcePath("images/pressed/L-bumper.png"))
-, pressedRBump(PathManager::getResourcePath("images/pressed/R-bumper.png"))
+: GamepadTextures(trace::now())
 {
 }
 
+GamepadTextures::GamepadTextures(uint64_t traceStart)
+: unpressed(PathManager::getResourcePath(kFiles[0]))
+, pressedA(PathManager::getResourcePath(kFiles[1]))
+, pressedB(PathManager::getResourcePath(kFiles[2]))
+, pressedX(PathManager::getResourcePath(kFiles[3]))
+, pressedY(PathManager::getResourcePath(kFiles[4]))
+, pressedUp(PathManager::getResourcePath(kFiles[5]))
+, pressedLeft(PathManager::getResourcePath(kFiles[6]))
+, pressedDown(PathManager::getResourcePath(kFiles[7]))
+, pressedRight(PathManager::getResourcePath(kFiles[8]))
+, pressedStart(PathManager::getResourcePath(kFiles[9]))
+, pressedSelect(PathManager::getResourcePath(kFiles[10]))
+, pressedLBump(PathManager::getResourcePath(kFiles[11]))
+, pressedRBump(PathManager::getResourcePath(kFiles[12]))
+{
+    trace::record("GamepadTextures (13 PNGs)", traceStart);
+}
+
+namespace
+{
+    constexpr std::array<raylib::Texture2D GamepadTextures::*, GamepadTextures::kCount> kTextureMembers{
+        &GamepadTextures::unpressed, &GamepadTextures::pressedA, &GamepadTextures::pressedB,
+        &GamepadTextures::pressedX, &GamepadTextures::pressedY, &GamepadTextures::pressedUp,
+        &GamepadTextures::pressedLeft, &GamepadTextures::pressedDown, &GamepadTextures::pressedRight,
+        &GamepadTextures::pressedStart, &GamepadTextures::pressedSelect, &GamepadTextures::pressedLBump,
+        &GamepadTextures::pressedRBump
+    };
+}
+
+raylib::Texture2D& GamepadTextures::at(size_t index)
+{
+    return this->*kTextureMembers[index];
+}
+
+const raylib::Texture2D& GamepadTextures::at(size_t index) const
+{
+    return this->*kTextureMembers[index];
+}
+
+size_t GamepadTextures::memoryBytes() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < kCount; ++i)
+    {
+        const raylib::Texture2D& texture = at(i);
+        total += static_cast<size_t>(GetPixelDataSize(texture.width, texture.height, texture.format));
+    }
+    return total;
+}
+
 ScalingInfo::ScalingInfo(int currentWidth, int currentHeight, 
                          int originalWidth, int originalHeight)
 {
@@ -42,72 +81,11 @@ ScalingInfo::ScalingInfo(int currentWidth, int currentHeight,
     offsetY = (currentHeight - (originalHeight * scale)) / 2.0f;
 }
 
-void CachedButtons::refreshCache(const ButtonMap& buttonMap)
-{
-    //std::cout << "DEBUG: Starting refreshCache()" << std::endl;
-    // reset each
-    dpadUp = dpadRight = dpadDown = dpadLeft = 0;
-    xButton = aButton = bButton = yButton = 0;
-    leftTrigger = rightTrigger = selectButton = startButton = 0;
-    for (const auto& [raylibButton, displayIndex] : buttonMap.buttonIndex)
-    {
-        //std::cout << "DEBUG: refreshing " << raylibButton << " to " << displayIndex << std::endl;
-        switch (raylibButton)
-        {
-        case 1: // D-pad UP display
-            dpadUp = displayIndex;
-            break;
-        case 2: // D-pad RIGHT display
-            dpadRight = displayIndex;
-            break;
-        case 3: // D-pad DOWN display
-            dpadDown = displayIndex;
-            break;
-        case 4: // D-pad LEFT display
-            dpadLeft = displayIndex;
-            break;
-        case 5: // X button display
-            xButton = displayIndex;
-            break;
-        case 6: // A button display
-            aButton = displayIndex;
-            break;
-        case 7: // B button display
-            bButton = displayIndex;
-            break;
-        case 8: // Y button display
-            yButton = displayIndex;
-            break;
-        case 9: // Left shoulder display
-            leftTrigger = displayIndex;
-            break;
-        /* For future non-SNES controller use:
-        case 10: // Left trigger display
-            leftTrigger2 = displayIndex;
-            break;
-            */
-        case 11: // Right shoulder display
-            rightTrigger = displayIndex;
-            break;
-        /* For future non-SNES controller use:
-        case 12: // Left trigger display
-            leftTrigger2 = displayIndex;
-            break;
-            */
-        case 13: // Select display
-            selectButton = displayIndex;
-            break;
-        case 15: // Start display
-            startButton = displayIndex;
-            break;
-        }
-    }
-}
-
 //$ ----- PadCast ----- //
 
 PadCast::PadCast(Config& mainConfig)
     : mConfig{ mainConfig }
+    , mMapper{ mainConfig }
 {
     if (mConfig.getDebugMode() == 1)
     {
@@ -115,40 +93,27 @@ PadCast::PadCast(Config& mainConfig)
     }
 
     gamepadIndex = mainConfig.getGPIndex();
-
-    loadButtonsFromConfig();
-    mButtonCache.refreshCache(mButtonMap);
 }
 
-bool PadCast::updateGamepadConnection(bool currentlyAvailable)
+bool PadCast::replaceTexture(size_t index, const Image& image)
 {
-    // Cache stability threshold
-    if (mCachedStabilityThreshold == -1)
-    {
-        mCachedStabilityThreshold = mConfig.getValue("Gamepad", "STABILITY_THRESHOLD");
-    }
-
-    if (currentlyAvailable == mGamepadWasConnected)
+    const Texture2D texture = LoadTextureFromImage(image);
+    if (!IsTextureValid(texture))
     {
-        mStabilityCounter = 0;
-    }
-    else
-    {
-        ++mStabilityCounter;
-        if (mStabilityCounter >= mCachedStabilityThreshold)
-        {
-            mGamepadWasConnected = currentlyAvailable;
-            mStabilityCounter = 0;
-        }
+        return false;
     }
-    return mGamepadWasConnected;
+    // Unloads the old one
+    mTextures.at(index) = raylib::Texture2D{ texture };
+    return true;
 }
 
-void PadCast::drawGamepadButtons(const raylib::Gamepad& gamepad, 
+void PadCast::drawGamepadButtons(const PadState& pad, 
                                  const ScalingInfo& scaling)
 {
+    PADCAST_TRACE_SCOPE("drawGamepadButtons");
     const raylib::Vector2 position{ scaling.offsetX, scaling.offsetY };
     auto scale = scaling.scale;
+    const CachedButtons& buttons = mMapper.getButtons();
 
     // pressed texture tint
     if (!mTintCacheValid)
@@ -193,6 +158,7 @@ void PadCast::drawGamepadButtons(const raylib::Gamepad& gamepad,
 
     if (mDebugMode)
     {
+        raylib::Gamepad gamepad(pad.gamepad);
         int newButtonPress = gamepad.GetButtonPressed();
         if (newButtonPress > 0)
         {
@@ -200,9 +166,9 @@ void PadCast::drawGamepadButtons(const raylib::Gamepad& gamepad,
             drawDebugButtonIndex(gamepad, scaling);
         }
 
-        for (int axisIndex = 0; axisIndex < 6; ++axisIndex)  // Standard gamepads have 6 axes
+        for (int axisIndex = 0; axisIndex < PadState::kAxisCount; ++axisIndex)  // Standard gamepads have 6 axes
         {
-            float axisValue = gamepad.GetAxisMovement(axisIndex);
+            float axisValue = pad.axes[axisIndex];
             if (std::abs(axisValue) > 0.2f)  // Use dead zone to filter noise
             {
                 TraceLog(LOG_INFO, "Axis %d movement: %.3f", axisIndex, axisValue);
@@ -226,57 +192,57 @@ void PadCast::drawGamepadButtons(const raylib::Gamepad& gamepad,
     }
 
     // D-Pad
-    if (gamepad.IsButtonDown(mButtonCache.dpadUp))
+    if (pad.isDown(buttons.dpadUp))
     {
         mTextures.pressedUp.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.dpadRight))
+    if (pad.isDown(buttons.dpadRight))
     {
         mTextures.pressedRight.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.dpadDown))
+    if (pad.isDown(buttons.dpadDown))
     {
         mTextures.pressedDown.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.dpadLeft))
+    if (pad.isDown(buttons.dpadLeft))
     {
         mTextures.pressedLeft.Draw(position, 0.0f, scale, texture_tint);
     }
 
     // Face buttons
-    if (gamepad.IsButtonDown(mButtonCache.xButton))
+    if (pad.isDown(buttons.xButton))
     {
         mTextures.pressedX.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.aButton))
+    if (pad.isDown(buttons.aButton))
     {
         mTextures.pressedA.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.bButton))
+    if (pad.isDown(buttons.bButton))
     {
         mTextures.pressedB.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.yButton))
+    if (pad.isDown(buttons.yButton))
     {
         mTextures.pressedY.Draw(position, 0.0f, scale, texture_tint);
     }
 
     // Shoulder buttons
-    if (gamepad.IsButtonDown(mButtonCache.leftTrigger))
+    if (pad.isDown(buttons.leftTrigger))
     {
         mTextures.pressedLBump.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.rightTrigger))
+    if (pad.isDown(buttons.rightTrigger))
     {
         mTextures.pressedRBump.Draw(position, 0.0f, scale, texture_tint);
     }
 
     // Select / Start
-    if (gamepad.IsButtonDown(mButtonCache.selectButton))
+    if (pad.isDown(buttons.selectButton))
     {
         mTextures.pressedSelect.Draw(position, 0.0f, scale, texture_tint);
     }
-    if (gamepad.IsButtonDown(mButtonCache.startButton))
+    if (pad.isDown(buttons.startButton))
     {
         mTextures.pressedStart.Draw(position, 0.0f, scale, texture_tint);
     }
@@ -284,18 +250,21 @@ void PadCast::drawGamepadButtons(const raylib::Gamepad& gamepad,
 
 void PadCast::drawNoGamepadMessage(const ScalingInfo& scaling)
 {
-    int fontSize = std::max(
-        static_cast<int>(mConfig.getValue("Font", "DEFAULT_FONT_SIZE") * scaling.scale),
-        mConfig.getValue("Font", "MIN_FONT_SIZE")
-    );
+    if (!mMessageLayoutValid)
+    {
+        const int textOffset = mConfig.getValue("Font", "TEXT_OFFSET");
+        mMessageFontSize = std::max(
+            static_cast<int>(mConfig.getValue("Font", "DEFAULT_FONT_SIZE") * scaling.scale),
+            mConfig.getValue("Font", "MIN_FONT_SIZE")
+        );
+        mMessageX = static_cast<int>(textOffset * scaling.scale + scaling.offsetX);
+        mMessageY = static_cast<int>(textOffset * scaling.scale + scaling.offsetY);
+        mMessageLayoutValid = true;
+    }
 
-    raylib::DrawText(
-        "No Gamepad Connected",
-        static_cast<int>(mConfig.getValue("Font", "TEXT_OFFSET") * scaling.scale + scaling.offsetX),
-        static_cast<int>(mConfig.getValue("Font", "TEXT_OFFSET") * scaling.scale + scaling.offsetY),
-        fontSize,
-        raylib::Color(raylib::WHITE)
-    );
+    mTextCache.begin();
+    mTextCache.draw("No Gamepad Connected", mMessageX, mMessageY, mMessageFontSize, WHITE);
+    mTextCache.end();
 }
 
 void PadCast::findGamepadIndex()
@@ -438,101 +407,3 @@ raylib::Color PadCast::getBGColor() const
 
     return mCachedBGColor;
 }
-
-void PadCast::loadButtonsFromConfig()
-{
-    //std::cout << "DEBUG: Checking if ButtonMap section exists..." << std::endl;
-    // Clear the index
-    mButtonMap.buttonIndex.clear();
-    //std::cout << "DEBUG: Cleared buttonIndex" << std::endl;
-
-    if (!mConfig.getIni().has("ButtonMap"))
-    {
-        //std::cout << "DEBUG: ButtonMap section NOT found, using default SNES map" << std::endl;
-        mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
-        mButtonCache.refreshCache(mButtonMap);
-        return;
-    }
-
-    //std::cout << "DEBUG: ButtonMap section found, loading mappings..." << std::endl;
-    const auto& buttonSection = mConfig.getIni().get("ButtonMap");
-    //std::cout << "DEBUG: ButtonSection size: " << buttonSection.size() << std::endl;
-
-    for (const auto& [key, value_str] : buttonSection)
-    {
-        //std::cout << "DEBUG: Processing " << key << " = " << value_str << std::endl;
-        int value = 0;
-        try {
-            value = std::stoi(value_str);
-            //std::cout << "DEBUG: Converted " << value_str << " to int: " << value << std::endl;
-        }
-        catch (...) {
-            std::cerr << "DEBUG: Failed to convert " << value_str << " to int" << std::endl;
-            continue;
-        }
-
-        // Map INI keys to raylib button constants
-        bool mapped = false;
-        if (key == "DPAD_UP") 
-        {
-            mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_UP] = value;
-        }
-        else if (key == "DPAD_RIGHT") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = value;
-        }
-        else if (key == "DPAD_DOWN") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_DOWN] = value;
-        }
-        else if (key == "DPAD_LEFT") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_LEFT] = value;
-        }
-        else if (key == "X_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_UP] = value;
-        }
-        else if (key == "A_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_RIGHT] = value;
-        }
-        else if (key == "B_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_DOWN] = value;
-        }
-        else if (key == "Y_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_LEFT] = value;
-        }
-        else if (key == "L_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_TRIGGER_1] = value;
-        }
-        else if (key == "R_BUTTON") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_TRIGGER_1] = value;
-        }
-        else if (key == "SELECT") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_MIDDLE_LEFT] = value;
-        }
-        else if (key == "START") 
-        {
-                mButtonMap.buttonIndex[GAMEPAD_BUTTON_MIDDLE_RIGHT] = value;
-        }
-    }
-
-    //std::cout << "DEBUG: Final buttonIndex size: " << mButtonMap.buttonIndex.size() << std::endl;
-
-    // Safety check - if somehow buttonIndex is still empty, use defaults
-    if (mButtonMap.buttonIndex.empty())
-    {
-        std::cerr << "DEBUG: WARNING - buttonIndex still empty, using defaults" << std::endl;
-        mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
-    }
-
-    // Refresh the cache after loading
-    mButtonCache.refreshCache(mButtonMap);
-    // std::cout << "DEBUG: Finished loading button mappings" << std::endl;
-}
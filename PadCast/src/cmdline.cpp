@@ -0,0 +1,248 @@
+#include "cmdline.h"
+
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+    bool parseNumber(std::string_view text, double& out)
+    {
+        const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+        return ec == std::errc{} && end == text.data() + text.size() && std::isfinite(out) && out >= 0.0;
+    }
+
+    // <start>:<end> in seconds
+    bool parseRange(std::string_view text, double& start, double& end)
+    {
+        const size_t colon = text.find(':');
+        return colon != std::string_view::npos
+            && parseNumber(text.substr(0, colon), start)
+            && parseNumber(text.substr(colon + 1), end)
+            && end > start;
+    }
+
+    // <width>x<height>
+    bool parseSize(std::string_view text, int& width, int& height)
+    {
+        const size_t x = text.find('x');
+        if (x == std::string_view::npos)
+        {
+            return false;
+        }
+        const std::string_view w = text.substr(0, x);
+        const std::string_view h = text.substr(x + 1);
+        const auto [wEnd, wEc] = std::from_chars(w.data(), w.data() + w.size(), width);
+        const auto [hEnd, hEc] = std::from_chars(h.data(), h.data() + h.size(), height);
+        return wEc == std::errc{} && hEc == std::errc{} && wEnd == w.data() + w.size() && hEnd == h.data() + h.size()
+            && width > 0 && height > 0 && width <= 16384 && height <= 16384;
+    }
+}
+
+CommandLine CommandLine::parse(int argc, char** argv)
+{
+    CommandLine options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ argv[i] };
+        if (arg == "-h" || arg == "--help")
+        {
+            options.showHelp = true;
+        }
+        else if (arg == "--profile-startup" || arg == "--profile-startup=warm")
+        {
+            options.profileStartup = true;
+            options.cacheState = CacheState::Warm;
+        }
+        else if (arg == "--profile-startup=cold")
+        {
+            options.profileStartup = true;
+            options.cacheState = CacheState::Cold;
+        }
+        else if (arg.starts_with("--virtual-pad="))
+        {
+            options.virtualPadScript = arg.substr(std::string_view{ "--virtual-pad=" }.size());
+        }
+        else if (arg == "--virtual-pad" && i + 1 < argc)
+        {
+            options.virtualPadScript = argv[++i];
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            options.recordPath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            options.replayPath = argv[++i];
+        }
+        else if (arg == "--replay-speed" && i + 1 < argc)
+        {
+            if (!parseNumber(argv[++i], options.replaySpeed) || options.replaySpeed == 0.0)
+            {
+                std::cerr << "--replay-speed needs a positive number" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--replay-start" && i + 1 < argc)
+        {
+            if (!parseNumber(argv[++i], options.replayStart))
+            {
+                std::cerr << "--replay-start needs a time in seconds" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--replay-loop" && i + 1 < argc)
+        {
+            if (!parseRange(argv[++i], options.replayLoopStart, options.replayLoopEnd))
+            {
+                std::cerr << "--replay-loop needs <start>:<end> in seconds, end after start" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--video-out" && i + 1 < argc)
+        {
+            options.videoOutPath = argv[++i];
+        }
+        else if (arg == "--video-format" && i + 1 < argc)
+        {
+            const std::string_view format{ argv[++i] };
+            if (format == "y4m")
+            {
+                options.videoFormat = VideoFormat::Y4m;
+            }
+            else if (format == "rgba")
+            {
+                options.videoFormat = VideoFormat::Rgba;
+            }
+            else if (format == "shm")
+            {
+                options.videoFormat = VideoFormat::Shm;
+            }
+            else
+            {
+                std::cerr << "--video-format is y4m, rgba or shm" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--video-size" && i + 1 < argc)
+        {
+            if (!parseSize(argv[++i], options.videoWidth, options.videoHeight))
+            {
+                std::cerr << "--video-size needs <width>x<height>" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--share-pad" && i + 1 < argc)
+        {
+            options.sharePadName = argv[++i];
+        }
+        else if (arg == "--relay-send" && i + 1 < argc)
+        {
+            options.relaySend = argv[++i];
+        }
+        else if (arg == "--relay-listen" && i + 1 < argc)
+        {
+            options.relayListen = argv[++i];
+        }
+        else if (arg == "--daemon")
+        {
+            options.daemon = true;
+        }
+        else if (arg == "--daemon-port" && i + 1 < argc)
+        {
+            const std::string_view value{ argv[++i] };
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.daemonPort);
+            if (ec != std::errc{} || end != value.data() + value.size() || options.daemonPort < 1
+                || options.daemonPort > 65535)
+            {
+                std::cerr << "--daemon-port needs a port number" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--daemon-bind" && i + 1 < argc)
+        {
+            options.daemonBind = argv[++i];
+        }
+        else if (arg == "--tui")
+        {
+            options.tui = true;
+        }
+        else if (arg == "--render" && i + 1 < argc)
+        {
+            options.renderPath = argv[++i];
+        }
+        else if (arg == "--render-fps" && i + 1 < argc)
+        {
+            if (!parseNumber(argv[++i], options.renderFps) || options.renderFps < 1.0 || options.renderFps > 1000.0)
+            {
+                std::cerr << "--render-fps needs a frame rate between 1 and 1000" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--render-size" && i + 1 < argc)
+        {
+            if (!parseSize(argv[++i], options.renderWidth, options.renderHeight))
+            {
+                std::cerr << "--render-size needs <width>x<height>" << std::endl;
+                options.valid = false;
+            }
+        }
+        else if (arg == "--render-threads" && i + 1 < argc)
+        {
+            const std::string_view value{ argv[++i] };
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.renderThreads);
+            if (ec != std::errc{} || end != value.data() + value.size())
+            {
+                std::cerr << "--render-threads needs a number (0 = all cores)" << std::endl;
+                options.valid = false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            options.valid = false;
+        }
+    }
+    return options;
+}
+
+void CommandLine::printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --profile-startup[=warm|cold]  Print a breakdown of the time to first frame and exit.\n"
+              << "                                 cold drops PadCast's assets and config from the OS file\n"
+              << "                                 cache first (Linux only).\n"
+              << "  --virtual-pad <script>         Replace real gamepads with a scripted virtual one\n"
+              << "                                 (see README for the script format).\n"
+              << "  --record <file>                Record gamepad input to <file> (.pcrec).\n"
+              << "  --replay <file>                Play a .pcrec recording back instead of reading gamepads.\n"
+              << "  --replay-speed <x>             Replay speed, 1 = real time (default).\n"
+              << "  --replay-start <seconds>       Start the replay this far in.\n"
+              << "  --replay-loop <start>:<end>    Repeat this part of the replay (seconds).\n"
+              << "  --render <out>                 With --replay: render it offline as fast as possible to\n"
+              << "                                 <out>.y4m, or to a directory of PNGs, then exit.\n"
+              << "                                 --replay-start/--replay-loop pick the part to render.\n"
+              << "  --render-fps <n>               Frame rate of the rendered video (default 60).\n"
+              << "  --render-size <w>x<h>          Frame size (default: the image canvas size).\n"
+              << "  --render-threads <n>           Encoder threads (default: all cores).\n"
+              << "  --video-out <path|->           Stream the overlay as raw video to a file or named pipe\n"
+              << "                                 (- = stdout), e.g. for ffmpeg or GStreamer.\n"
+              << "  --video-format <y4m|rgba|shm>  Stream format (default y4m). shm publishes RGBA frames\n"
+              << "                                 into the shared-memory ring named by --video-out\n"
+              << "                                 (Linux; read with padcast_shm_reader).\n"
+              << "  --video-size <w>x<h>           Stream frame size (default: the image canvas size).\n"
+              << "  --share-pad <name|->           Publish live pad state to shared memory for other local\n"
+              << "                                 tools (Linux; - = padcast-pad).\n"
+              << "  --relay-send <host[:port]>     Also send the pad to another PC's PadCast over UDP\n"
+              << "                                 (default port 8766; Linux).\n"
+              << "  --relay-listen <[addr:]port|-> Read the pad from a --relay-send PC instead of a local\n"
+              << "                                 gamepad (- = port 8766; Linux).\n"
+              << "  --daemon                       No window: serve pad state to browser sources over a\n"
+              << "                                 local WebSocket (Linux).\n"
+              << "  --daemon-port <n>              Daemon port (default 8765).\n"
+              << "  --daemon-bind <address>        Daemon address (default 127.0.0.1).\n"
+              << "  --tui                          No window: draw the pad in the terminal, to check a pad\n"
+              << "                                 and its mapping without X11/Wayland or a GPU.\n"
+              << "  -h, --help                     Show this message.\n";
+}
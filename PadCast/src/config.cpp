@@ -5,28 +5,37 @@
 
 void Config::loadConfig()
 {
-	mConfigPath = getConfigFilePath();
-	mConfigFile = mINI::INIFile{ mConfigPath };
-
-	try
+	PADCAST_TRACE_SCOPE("Config::loadConfig");
 	{
-		auto configDir{ std::filesystem::path{mConfigPath}.parent_path() };
+		PADCAST_TRACE_SCOPE("Config path + directory checks");
+		mConfigPath = getConfigFilePath();
+		mConfigFile = mINI::INIFile{ mConfigPath };
+
+		try
+		{
+			auto configDir{ std::filesystem::path{mConfigPath}.parent_path() };
 
-		if (!std::filesystem::exists(configDir))
+			if (!std::filesystem::exists(configDir))
+			{
+				std::cout << "Creating config directory: " << configDir.string() << std::endl;
+				std::filesystem::create_directories(configDir);
+			}
+		}
+		catch (const std::filesystem::filesystem_error& e)
 		{
-			std::cout << "Creating config directory: " << configDir.string() << std::endl;
-			std::filesystem::create_directories(configDir);
+			std::cerr << "Error: Cannot create config directory - " << e.what() << std::endl;
+			// Fallback: try to use current directory
+			mConfigPath = "config.ini";
+			std::cout << "Falling back to current directory" << std::endl;
 		}
 	}
-	catch (const std::filesystem::filesystem_error& e)
+
+	bool readOk{ false };
 	{
-		std::cerr << "Error: Cannot create config directory - " << e.what() << std::endl;
-		// Fallback: try to use current directory
-		mConfigPath = "config.ini";
-		std::cout << "Falling back to current directory" << std::endl;
+		PADCAST_TRACE_SCOPE("mINI read");
+		readOk = mConfigFile.read(config_ini);
 	}
-
-	if (!mConfigFile.read(config_ini))
+	if (!readOk)
 	{
 		// config.ini doesn't exist so we'll create one with default values
 		std::cout << "config.ini doesn't exist at " << mConfigPath << ", creating a default one." << std::endl;
@@ -40,530 +49,667 @@ void Config::loadConfig()
 //! [!!!] Rewrite this as a template! [!!!]
 void Config::validateConfig()
 {
+	PADCAST_TRACE_SCOPE("Config::validateConfig");
 	bool needsSave{ false };
+	for (size_t section = 0; section < kSections.size(); ++section)
+	{
+		needsSave = validateSection(config_ini, section) || needsSave;
+	}
+
+    if (needsSave)
+    {
+        std::cout << "Adding missing or invalid config values..." << std::endl;
+        saveConfig();
+    }
+}
 
-    //$ ----- Check Window section ----- //
+bool Config::validateSection(mINI::INIStructure& ini, size_t section) const
+{
+	bool needsSave{ false };
+	switch (section)
+	{
+	case 0: validateWindow(ini, needsSave); break;
+	case 1: validateImage(ini, needsSave); break;
+	case 2: validateGamepad(ini, needsSave); break;
+	case 3: validateFont(ini, needsSave); break;
+	case 4: validateButtonMap(ini, needsSave); break;
+	case 5: validatePerformance(ini, needsSave); break;
+	case 6: validateRecording(ini, needsSave); break;
+	case 7: validateDebug(ini, needsSave); break;
+	default: break;
+	}
+	return needsSave;
+}
 
-    if (!hasValue("Window", "INITIAL_WINDOW_WIDTH"))
+//$ ----- Check Window section ----- //
+void Config::validateWindow(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Window", "INITIAL_WINDOW_WIDTH"))
     {
-        config_ini["Window"]["INITIAL_WINDOW_WIDTH"] = std::to_string(DefaultValues::INITIAL_WINDOW_WIDTH);
+        ini["Window"]["INITIAL_WINDOW_WIDTH"] = std::to_string(DefaultValues::INITIAL_WINDOW_WIDTH);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Window", "INITIAL_WINDOW_WIDTH");
+        int val = getValue(ini, "Window", "INITIAL_WINDOW_WIDTH");
         if (val < 1)
         {
-            config_ini["Window"]["INITIAL_WINDOW_WIDTH"] = std::to_string(DefaultValues::INITIAL_WINDOW_WIDTH);
+            ini["Window"]["INITIAL_WINDOW_WIDTH"] = std::to_string(DefaultValues::INITIAL_WINDOW_WIDTH);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "INITIAL_WINDOW_HEIGHT"))
+    if (!hasValue(ini, "Window", "INITIAL_WINDOW_HEIGHT"))
     {
-        config_ini["Window"]["INITIAL_WINDOW_HEIGHT"] = std::to_string(DefaultValues::INITIAL_WINDOW_HEIGHT);
+        ini["Window"]["INITIAL_WINDOW_HEIGHT"] = std::to_string(DefaultValues::INITIAL_WINDOW_HEIGHT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Window", "INITIAL_WINDOW_HEIGHT");
+        int val = getValue(ini, "Window", "INITIAL_WINDOW_HEIGHT");
         if (val < 1)
         {
-            config_ini["Window"]["INITIAL_WINDOW_HEIGHT"] = std::to_string(DefaultValues::INITIAL_WINDOW_HEIGHT);
+            ini["Window"]["INITIAL_WINDOW_HEIGHT"] = std::to_string(DefaultValues::INITIAL_WINDOW_HEIGHT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "TARGET_FPS"))
+    if (!hasValue(ini, "Window", "TARGET_FPS"))
     {
-        config_ini["Window"]["TARGET_FPS"] = std::to_string(DefaultValues::TARGET_FPS);
+        ini["Window"]["TARGET_FPS"] = std::to_string(DefaultValues::TARGET_FPS);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Window", "TARGET_FPS");
+        int val = getValue(ini, "Window", "TARGET_FPS");
         if (val < 1 || val > 250) // idk why anyone would need more than 250 but if so I'll change this
         {
-            config_ini["Window"]["TARGET_FPS"] = std::to_string(DefaultValues::TARGET_FPS);
+            ini["Window"]["TARGET_FPS"] = std::to_string(DefaultValues::TARGET_FPS);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "USE_VSYNC"))
+    if (!hasValue(ini, "Window", "USE_VSYNC"))
     {
-        config_ini["Window"]["USE_VSYNC"] = std::to_string(DefaultValues::USE_VSYNC);
+        ini["Window"]["USE_VSYNC"] = std::to_string(DefaultValues::USE_VSYNC);
         needsSave = true;
     }
     else
     {
-        int existingVsync = getValue("Window", "USE_VSYNC");
+        int existingVsync = getValue(ini, "Window", "USE_VSYNC");
         if (existingVsync != 0 && existingVsync != 1)
         {
-            config_ini["Window"]["USE_VSYNC"] = std::to_string(DefaultValues::USE_VSYNC);
+            ini["Window"]["USE_VSYNC"] = std::to_string(DefaultValues::USE_VSYNC);
             needsSave = true;
         }
 	}
 
-    if (!hasValue("Window", "BACKGROUND_COLOR"))
+    if (!hasValue(ini, "Window", "VRR_MODE"))
+    {
+        ini["Window"]["VRR_MODE"] = std::to_string(DefaultValues::VRR_MODE);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Window", "VRR_MODE");
+        if (val != 0 && val != 1)
+        {
+            ini["Window"]["VRR_MODE"] = std::to_string(DefaultValues::VRR_MODE);
+            needsSave = true;
+        }
+    }
+
+    if (!hasValue(ini, "Window", "BACKGROUND_COLOR"))
     {
-        config_ini["Window"]["BACKGROUND_COLOR"] = std::to_string(DefaultValues::BACKGROUND_COLOR);
+        ini["Window"]["BACKGROUND_COLOR"] = std::to_string(DefaultValues::BACKGROUND_COLOR);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Window", "BACKGROUND_COLOR");
+        int val = getValue(ini, "Window", "BACKGROUND_COLOR");
         if (val < 0 || val > 4)
         {
-            config_ini["Window"]["BACKGROUND_COLOR"] = std::to_string(DefaultValues::BACKGROUND_COLOR);
+            ini["Window"]["BACKGROUND_COLOR"] = std::to_string(DefaultValues::BACKGROUND_COLOR);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "CUSTOM_BG_RED"))
+    if (!hasValue(ini, "Window", "CUSTOM_BG_RED"))
     {
-        config_ini["Window"]["CUSTOM_BG_RED"] = std::to_string(DefaultValues::CUSTOM_BG_RED);
+        ini["Window"]["CUSTOM_BG_RED"] = std::to_string(DefaultValues::CUSTOM_BG_RED);
         needsSave = true;
     }
     else
     {
-        int existingRed = getValue("Window", "CUSTOM_BG_RED");
+        int existingRed = getValue(ini, "Window", "CUSTOM_BG_RED");
         if (existingRed < 0 || existingRed > 255)
         {
-            config_ini["Window"]["CUSTOM_BG_RED"] = std::to_string(DefaultValues::CUSTOM_BG_RED);
+            ini["Window"]["CUSTOM_BG_RED"] = std::to_string(DefaultValues::CUSTOM_BG_RED);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "CUSTOM_BG_GREEN"))
+    if (!hasValue(ini, "Window", "CUSTOM_BG_GREEN"))
     {
-        config_ini["Window"]["CUSTOM_BG_GREEN"] = std::to_string(DefaultValues::CUSTOM_BG_GREEN);
+        ini["Window"]["CUSTOM_BG_GREEN"] = std::to_string(DefaultValues::CUSTOM_BG_GREEN);
         needsSave = true;
     }
     else
     {
-        int existingGreen = getValue("Window", "CUSTOM_BG_GREEN");
+        int existingGreen = getValue(ini, "Window", "CUSTOM_BG_GREEN");
         if (existingGreen < 0 || existingGreen > 255)
         {
-            config_ini["Window"]["CUSTOM_BG_GREEN"] = std::to_string(DefaultValues::CUSTOM_BG_GREEN);
+            ini["Window"]["CUSTOM_BG_GREEN"] = std::to_string(DefaultValues::CUSTOM_BG_GREEN);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "CUSTOM_BG_BLUE"))
+    if (!hasValue(ini, "Window", "CUSTOM_BG_BLUE"))
     {
-        config_ini["Window"]["CUSTOM_BG_BLUE"] = std::to_string(DefaultValues::CUSTOM_BG_BLUE);
+        ini["Window"]["CUSTOM_BG_BLUE"] = std::to_string(DefaultValues::CUSTOM_BG_BLUE);
         needsSave = true;
     }
     else
     {
-        int existingBlue = getValue("Window", "CUSTOM_BG_BLUE");
+        int existingBlue = getValue(ini, "Window", "CUSTOM_BG_BLUE");
         if (existingBlue < 0 || existingBlue > 255)
         {
-            config_ini["Window"]["CUSTOM_BG_BLUE"] = std::to_string(DefaultValues::CUSTOM_BG_BLUE);
+            ini["Window"]["CUSTOM_BG_BLUE"] = std::to_string(DefaultValues::CUSTOM_BG_BLUE);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Window", "USE_CUSTOM_BG"))
+    if (!hasValue(ini, "Window", "USE_CUSTOM_BG"))
     {
-        config_ini["Window"]["USE_CUSTOM_BG"] = std::to_string(DefaultValues::USE_CUSTOM_BG);
+        ini["Window"]["USE_CUSTOM_BG"] = std::to_string(DefaultValues::USE_CUSTOM_BG);
         needsSave = true;
     }
     else
     {
-        int existingUseCustom = getValue("Window", "USE_CUSTOM_BG");
+        int existingUseCustom = getValue(ini, "Window", "USE_CUSTOM_BG");
         if (existingUseCustom != 0 && existingUseCustom != 1)
         {
-            config_ini["Window"]["USE_CUSTOM_BG"] = std::to_string(DefaultValues::USE_CUSTOM_BG);
+            ini["Window"]["USE_CUSTOM_BG"] = std::to_string(DefaultValues::USE_CUSTOM_BG);
             needsSave = true;
         }
     }
+}
 
-    //$ ----- Check Image section ----- //
-
-    if (!hasValue("Image", "IMAGE_CANVAS_WIDTH"))
+//$ ----- Check Image section ----- //
+void Config::validateImage(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Image", "IMAGE_CANVAS_WIDTH"))
     {
-        config_ini["Image"]["IMAGE_CANVAS_WIDTH"] = std::to_string(DefaultValues::IMAGE_CANVAS_WIDTH);
+        ini["Image"]["IMAGE_CANVAS_WIDTH"] = std::to_string(DefaultValues::IMAGE_CANVAS_WIDTH);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_CANVAS_WIDTH");
+        int val = getValue(ini, "Image", "IMAGE_CANVAS_WIDTH");
         if (val < 1)
         {
-            config_ini["Image"]["IMAGE_CANVAS_WIDTH"] = std::to_string(DefaultValues::IMAGE_CANVAS_WIDTH);
+            ini["Image"]["IMAGE_CANVAS_WIDTH"] = std::to_string(DefaultValues::IMAGE_CANVAS_WIDTH);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "IMAGE_CANVAS_HEIGHT"))
+    if (!hasValue(ini, "Image", "IMAGE_CANVAS_HEIGHT"))
     {
-        config_ini["Image"]["IMAGE_CANVAS_HEIGHT"] = std::to_string(DefaultValues::IMAGE_CANVAS_HEIGHT);
+        ini["Image"]["IMAGE_CANVAS_HEIGHT"] = std::to_string(DefaultValues::IMAGE_CANVAS_HEIGHT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_CANVAS_HEIGHT");
+        int val = getValue(ini, "Image", "IMAGE_CANVAS_HEIGHT");
         if (val < 1)
         {
-            config_ini["Image"]["IMAGE_CANVAS_HEIGHT"] = std::to_string(DefaultValues::IMAGE_CANVAS_HEIGHT);
+            ini["Image"]["IMAGE_CANVAS_HEIGHT"] = std::to_string(DefaultValues::IMAGE_CANVAS_HEIGHT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "USE_CUSTOM_TINT"))
+    if (!hasValue(ini, "Image", "USE_CUSTOM_TINT"))
     {
-        config_ini["Image"]["USE_CUSTOM_TINT"] = std::to_string(DefaultValues::USE_CUSTOM_TINT);
+        ini["Image"]["USE_CUSTOM_TINT"] = std::to_string(DefaultValues::USE_CUSTOM_TINT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "USE_CUSTOM_TINT");
+        int val = getValue(ini, "Image", "USE_CUSTOM_TINT");
         if (val != 0 && val != 1)
         {
-            config_ini["Image"]["USE_CUSTOM_TINT"] = std::to_string(DefaultValues::USE_CUSTOM_TINT);
+            ini["Image"]["USE_CUSTOM_TINT"] = std::to_string(DefaultValues::USE_CUSTOM_TINT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "IMAGE_TINT_RED"))
+    if (!hasValue(ini, "Image", "IMAGE_TINT_RED"))
     {
-        config_ini["Image"]["IMAGE_TINT_RED"] = std::to_string(DefaultValues::IMAGE_TINT_RED);
+        ini["Image"]["IMAGE_TINT_RED"] = std::to_string(DefaultValues::IMAGE_TINT_RED);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_TINT_RED");
+        int val = getValue(ini, "Image", "IMAGE_TINT_RED");
         if (val < 0 || val > 255)
         {
-            config_ini["Image"]["IMAGE_TINT_RED"] = std::to_string(DefaultValues::IMAGE_TINT_RED);
+            ini["Image"]["IMAGE_TINT_RED"] = std::to_string(DefaultValues::IMAGE_TINT_RED);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "IMAGE_TINT_GREEN"))
+    if (!hasValue(ini, "Image", "IMAGE_TINT_GREEN"))
     {
-        config_ini["Image"]["IMAGE_TINT_GREEN"] = std::to_string(DefaultValues::IMAGE_TINT_GREEN);
+        ini["Image"]["IMAGE_TINT_GREEN"] = std::to_string(DefaultValues::IMAGE_TINT_GREEN);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_TINT_GREEN");
+        int val = getValue(ini, "Image", "IMAGE_TINT_GREEN");
         if (val < 0 || val > 255)
         {
-            config_ini["Image"]["IMAGE_TINT_GREEN"] = std::to_string(DefaultValues::IMAGE_TINT_GREEN);
+            ini["Image"]["IMAGE_TINT_GREEN"] = std::to_string(DefaultValues::IMAGE_TINT_GREEN);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "IMAGE_TINT_BLUE"))
+    if (!hasValue(ini, "Image", "IMAGE_TINT_BLUE"))
     {
-        config_ini["Image"]["IMAGE_TINT_BLUE"] = std::to_string(DefaultValues::IMAGE_TINT_BLUE);
+        ini["Image"]["IMAGE_TINT_BLUE"] = std::to_string(DefaultValues::IMAGE_TINT_BLUE);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_TINT_BLUE");
+        int val = getValue(ini, "Image", "IMAGE_TINT_BLUE");
         if (val < 0 || val > 255)
         {
-            config_ini["Image"]["IMAGE_TINT_BLUE"] = std::to_string(DefaultValues::IMAGE_TINT_BLUE);
+            ini["Image"]["IMAGE_TINT_BLUE"] = std::to_string(DefaultValues::IMAGE_TINT_BLUE);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Image", "IMAGE_TINT_PALETTE"))
+    if (!hasValue(ini, "Image", "IMAGE_TINT_PALETTE"))
     {
-        config_ini["Image"]["IMAGE_TINT_PALETTE"] = std::to_string(DefaultValues::IMAGE_TINT_PALETTE);
+        ini["Image"]["IMAGE_TINT_PALETTE"] = std::to_string(DefaultValues::IMAGE_TINT_PALETTE);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Image", "IMAGE_TINT_PALETTE");
+        int val = getValue(ini, "Image", "IMAGE_TINT_PALETTE");
         if (val < 0 || val > 3)
         {
-            config_ini["Image"]["IMAGE_TINT_PALETTE"] = std::to_string(DefaultValues::IMAGE_TINT_PALETTE);
+            ini["Image"]["IMAGE_TINT_PALETTE"] = std::to_string(DefaultValues::IMAGE_TINT_PALETTE);
             needsSave = true;
         }
     }
+}
 
-    // Check Gamepad section
-    if (!hasValue("Gamepad", "STABILITY_THRESHOLD"))
+//$ ----- Check Gamepad section ----- //
+void Config::validateGamepad(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Gamepad", "STABILITY_THRESHOLD"))
     {
-        config_ini["Gamepad"]["STABILITY_THRESHOLD"] = std::to_string(DefaultValues::STABILITY_THRESHOLD);
+        ini["Gamepad"]["STABILITY_THRESHOLD"] = std::to_string(DefaultValues::STABILITY_THRESHOLD);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Gamepad", "STABILITY_THRESHOLD");
+        int val = getValue(ini, "Gamepad", "STABILITY_THRESHOLD");
         if (val < 1)
         {
-            config_ini["Gamepad"]["STABILITY_THRESHOLD"] = std::to_string(DefaultValues::STABILITY_THRESHOLD);
+            ini["Gamepad"]["STABILITY_THRESHOLD"] = std::to_string(DefaultValues::STABILITY_THRESHOLD);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Gamepad", "GAMEPAD_INDEX"))
+    if (!hasValue(ini, "Gamepad", "GAMEPAD_INDEX"))
     {
-        config_ini["Gamepad"]["GAMEPAD_INDEX"] = std::to_string(DefaultValues::GAMEPAD_INDEX);
+        ini["Gamepad"]["GAMEPAD_INDEX"] = std::to_string(DefaultValues::GAMEPAD_INDEX);
         needsSave = true;
     }
     else 
     {
-        int val = getValue("Gamepad", "GAMEPAD_INDEX");
+        int val = getValue(ini, "Gamepad", "GAMEPAD_INDEX");
         if (val < 0 || val > 3)
         {
-            config_ini["Gamepad"]["GAMEPAD_INDEX"] = std::to_string(DefaultValues::GAMEPAD_INDEX);
+            ini["Gamepad"]["GAMEPAD_INDEX"] = std::to_string(DefaultValues::GAMEPAD_INDEX);
             needsSave = true;
         }
     }
+}
 
-    // Check Font section
-    if (!hasValue("Font", "MIN_FONT_SIZE"))
+//$ ----- Check Font section ----- //
+void Config::validateFont(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Font", "MIN_FONT_SIZE"))
     {
-        config_ini["Font"]["MIN_FONT_SIZE"] = std::to_string(DefaultValues::MIN_FONT_SIZE);
+        ini["Font"]["MIN_FONT_SIZE"] = std::to_string(DefaultValues::MIN_FONT_SIZE);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Font", "MIN_FONT_SIZE");
+        int val = getValue(ini, "Font", "MIN_FONT_SIZE");
         if (val < 1)
         {
-            config_ini["Font"]["MIN_FONT_SIZE"] = std::to_string(DefaultValues::MIN_FONT_SIZE);
+            ini["Font"]["MIN_FONT_SIZE"] = std::to_string(DefaultValues::MIN_FONT_SIZE);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Font", "DEFAULT_FONT_SIZE"))
+    if (!hasValue(ini, "Font", "DEFAULT_FONT_SIZE"))
     {
-        config_ini["Font"]["DEFAULT_FONT_SIZE"] = std::to_string(DefaultValues::DEFAULT_FONT_SIZE);
+        ini["Font"]["DEFAULT_FONT_SIZE"] = std::to_string(DefaultValues::DEFAULT_FONT_SIZE);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Font", "DEFAULT_FONT_SIZE");
+        int val = getValue(ini, "Font", "DEFAULT_FONT_SIZE");
         if (val < 1)
         {
-            config_ini["Font"]["DEFAULT_FONT_SIZE"] = std::to_string(DefaultValues::DEFAULT_FONT_SIZE);
+            ini["Font"]["DEFAULT_FONT_SIZE"] = std::to_string(DefaultValues::DEFAULT_FONT_SIZE);
             needsSave = true;
         }
     }
 
-    if (!hasValue("Font", "TEXT_OFFSET"))
+    if (!hasValue(ini, "Font", "TEXT_OFFSET"))
     {
-        config_ini["Font"]["TEXT_OFFSET"] = std::to_string(DefaultValues::TEXT_OFFSET);
+        ini["Font"]["TEXT_OFFSET"] = std::to_string(DefaultValues::TEXT_OFFSET);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Font", "TEXT_OFFSET");
+        int val = getValue(ini, "Font", "TEXT_OFFSET");
         if (val < 0) // Text offset can be 0 (no offset)
         {
-            config_ini["Font"]["TEXT_OFFSET"] = std::to_string(DefaultValues::TEXT_OFFSET);
+            ini["Font"]["TEXT_OFFSET"] = std::to_string(DefaultValues::TEXT_OFFSET);
             needsSave = true;
         }
     }
+}
 
-    // Check ButtonMap section
-    if (!hasValue("ButtonMap", "DPAD_UP"))
+//$ ----- Check ButtonMap section ----- //
+void Config::validateButtonMap(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "ButtonMap", "DPAD_UP"))
     {
-        config_ini["ButtonMap"]["DPAD_UP"] = std::to_string(SNESMapDefaults::DPAD_UP);
+        ini["ButtonMap"]["DPAD_UP"] = std::to_string(SNESMapDefaults::DPAD_UP);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "DPAD_UP");
+        int val = getValue(ini, "ButtonMap", "DPAD_UP");
         if (val < 1) // Button indices should be positive
         {
-            config_ini["ButtonMap"]["DPAD_UP"] = std::to_string(SNESMapDefaults::DPAD_UP);
+            ini["ButtonMap"]["DPAD_UP"] = std::to_string(SNESMapDefaults::DPAD_UP);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "DPAD_RIGHT"))
+    if (!hasValue(ini, "ButtonMap", "DPAD_RIGHT"))
     {
-        config_ini["ButtonMap"]["DPAD_RIGHT"] = std::to_string(SNESMapDefaults::DPAD_RIGHT);
+        ini["ButtonMap"]["DPAD_RIGHT"] = std::to_string(SNESMapDefaults::DPAD_RIGHT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "DPAD_RIGHT");
+        int val = getValue(ini, "ButtonMap", "DPAD_RIGHT");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["DPAD_RIGHT"] = std::to_string(SNESMapDefaults::DPAD_RIGHT);
+            ini["ButtonMap"]["DPAD_RIGHT"] = std::to_string(SNESMapDefaults::DPAD_RIGHT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "DPAD_DOWN"))
+    if (!hasValue(ini, "ButtonMap", "DPAD_DOWN"))
     {
-        config_ini["ButtonMap"]["DPAD_DOWN"] = std::to_string(SNESMapDefaults::DPAD_DOWN);
+        ini["ButtonMap"]["DPAD_DOWN"] = std::to_string(SNESMapDefaults::DPAD_DOWN);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "DPAD_DOWN");
+        int val = getValue(ini, "ButtonMap", "DPAD_DOWN");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["DPAD_DOWN"] = std::to_string(SNESMapDefaults::DPAD_DOWN);
+            ini["ButtonMap"]["DPAD_DOWN"] = std::to_string(SNESMapDefaults::DPAD_DOWN);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "DPAD_LEFT"))
+    if (!hasValue(ini, "ButtonMap", "DPAD_LEFT"))
     {
-        config_ini["ButtonMap"]["DPAD_LEFT"] = std::to_string(SNESMapDefaults::DPAD_LEFT);
+        ini["ButtonMap"]["DPAD_LEFT"] = std::to_string(SNESMapDefaults::DPAD_LEFT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "DPAD_LEFT");
+        int val = getValue(ini, "ButtonMap", "DPAD_LEFT");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["DPAD_LEFT"] = std::to_string(SNESMapDefaults::DPAD_LEFT);
+            ini["ButtonMap"]["DPAD_LEFT"] = std::to_string(SNESMapDefaults::DPAD_LEFT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "X_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "X_BUTTON"))
     {
-        config_ini["ButtonMap"]["X_BUTTON"] = std::to_string(SNESMapDefaults::X_BUTTON);
+        ini["ButtonMap"]["X_BUTTON"] = std::to_string(SNESMapDefaults::X_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "X_BUTTON");
+        int val = getValue(ini, "ButtonMap", "X_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["X_BUTTON"] = std::to_string(SNESMapDefaults::X_BUTTON);
+            ini["ButtonMap"]["X_BUTTON"] = std::to_string(SNESMapDefaults::X_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "A_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "A_BUTTON"))
     {
-        config_ini["ButtonMap"]["A_BUTTON"] = std::to_string(SNESMapDefaults::A_BUTTON);
+        ini["ButtonMap"]["A_BUTTON"] = std::to_string(SNESMapDefaults::A_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "A_BUTTON");
+        int val = getValue(ini, "ButtonMap", "A_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["A_BUTTON"] = std::to_string(SNESMapDefaults::A_BUTTON);
+            ini["ButtonMap"]["A_BUTTON"] = std::to_string(SNESMapDefaults::A_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "B_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "B_BUTTON"))
     {
-        config_ini["ButtonMap"]["B_BUTTON"] = std::to_string(SNESMapDefaults::B_BUTTON);
+        ini["ButtonMap"]["B_BUTTON"] = std::to_string(SNESMapDefaults::B_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "B_BUTTON");
+        int val = getValue(ini, "ButtonMap", "B_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["B_BUTTON"] = std::to_string(SNESMapDefaults::B_BUTTON);
+            ini["ButtonMap"]["B_BUTTON"] = std::to_string(SNESMapDefaults::B_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "Y_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "Y_BUTTON"))
     {
-        config_ini["ButtonMap"]["Y_BUTTON"] = std::to_string(SNESMapDefaults::Y_BUTTON);
+        ini["ButtonMap"]["Y_BUTTON"] = std::to_string(SNESMapDefaults::Y_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "Y_BUTTON");
+        int val = getValue(ini, "ButtonMap", "Y_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["Y_BUTTON"] = std::to_string(SNESMapDefaults::Y_BUTTON);
+            ini["ButtonMap"]["Y_BUTTON"] = std::to_string(SNESMapDefaults::Y_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "L_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "L_BUTTON"))
     {
-        config_ini["ButtonMap"]["L_BUTTON"] = std::to_string(SNESMapDefaults::L_BUTTON);
+        ini["ButtonMap"]["L_BUTTON"] = std::to_string(SNESMapDefaults::L_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "L_BUTTON");
+        int val = getValue(ini, "ButtonMap", "L_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["L_BUTTON"] = std::to_string(SNESMapDefaults::L_BUTTON);
+            ini["ButtonMap"]["L_BUTTON"] = std::to_string(SNESMapDefaults::L_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "R_BUTTON"))
+    if (!hasValue(ini, "ButtonMap", "R_BUTTON"))
     {
-        config_ini["ButtonMap"]["R_BUTTON"] = std::to_string(SNESMapDefaults::R_BUTTON);
+        ini["ButtonMap"]["R_BUTTON"] = std::to_string(SNESMapDefaults::R_BUTTON);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "R_BUTTON");
+        int val = getValue(ini, "ButtonMap", "R_BUTTON");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["R_BUTTON"] = std::to_string(SNESMapDefaults::R_BUTTON);
+            ini["ButtonMap"]["R_BUTTON"] = std::to_string(SNESMapDefaults::R_BUTTON);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "SELECT"))
+    if (!hasValue(ini, "ButtonMap", "SELECT"))
     {
-        config_ini["ButtonMap"]["SELECT"] = std::to_string(SNESMapDefaults::SELECT);
+        ini["ButtonMap"]["SELECT"] = std::to_string(SNESMapDefaults::SELECT);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "SELECT");
+        int val = getValue(ini, "ButtonMap", "SELECT");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["SELECT"] = std::to_string(SNESMapDefaults::SELECT);
+            ini["ButtonMap"]["SELECT"] = std::to_string(SNESMapDefaults::SELECT);
             needsSave = true;
         }
     }
 
-    if (!hasValue("ButtonMap", "START"))
+    if (!hasValue(ini, "ButtonMap", "START"))
     {
-        config_ini["ButtonMap"]["START"] = std::to_string(SNESMapDefaults::START);
+        ini["ButtonMap"]["START"] = std::to_string(SNESMapDefaults::START);
         needsSave = true;
     }
     else
     {
-        int val = getValue("ButtonMap", "START");
+        int val = getValue(ini, "ButtonMap", "START");
         if (val < 1)
         {
-            config_ini["ButtonMap"]["START"] = std::to_string(SNESMapDefaults::START);
+            ini["ButtonMap"]["START"] = std::to_string(SNESMapDefaults::START);
             needsSave = true;
         }
     }
+}
 
-    // Check Debug section
-    if (!hasValue("Debug", "MODE"))
+//$ ----- Check Performance section ----- //
+void Config::validatePerformance(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Performance", "IDLE_MODE"))
     {
-        config_ini["Debug"]["MODE"] = std::to_string(DefaultValues::DEBUG_MODE);
+        ini["Performance"]["IDLE_MODE"] = std::to_string(DefaultValues::IDLE_MODE);
         needsSave = true;
     }
     else
     {
-        int val = getValue("Debug", "MODE");
+        int val = getValue(ini, "Performance", "IDLE_MODE");
         if (val != 0 && val != 1)
         {
-            config_ini["Debug"]["MODE"] = std::to_string(DefaultValues::DEBUG_MODE);
+            ini["Performance"]["IDLE_MODE"] = std::to_string(DefaultValues::IDLE_MODE);
             needsSave = true;
         }
     }
 
-    if (needsSave)
+    if (!hasValue(ini, "Performance", "IDLE_HEARTBEAT_MS"))
     {
-        std::cout << "Adding missing or invalid config values..." << std::endl;
-        saveConfig();
+        ini["Performance"]["IDLE_HEARTBEAT_MS"] = std::to_string(DefaultValues::IDLE_HEARTBEAT_MS);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Performance", "IDLE_HEARTBEAT_MS");
+        if (val < 50 || val > 5000)
+        {
+            ini["Performance"]["IDLE_HEARTBEAT_MS"] = std::to_string(DefaultValues::IDLE_HEARTBEAT_MS);
+            needsSave = true;
+        }
+    }
+
+    if (!hasValue(ini, "Performance", "LATCH_MARGIN_MS"))
+    {
+        ini["Performance"]["LATCH_MARGIN_MS"] = std::to_string(DefaultValues::LATCH_MARGIN_MS);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Performance", "LATCH_MARGIN_MS");
+        if (val < 0 || val > 20)
+        {
+            ini["Performance"]["LATCH_MARGIN_MS"] = std::to_string(DefaultValues::LATCH_MARGIN_MS);
+            needsSave = true;
+        }
+    }
+}
+
+//$ ----- Check Recording section ----- //
+void Config::validateRecording(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Recording", "RECORD_INPUT"))
+    {
+        ini["Recording"]["RECORD_INPUT"] = std::to_string(DefaultValues::RECORD_INPUT);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Recording", "RECORD_INPUT");
+        if (val != 0 && val != 1)
+        {
+            ini["Recording"]["RECORD_INPUT"] = std::to_string(DefaultValues::RECORD_INPUT);
+            needsSave = true;
+        }
+    }
+}
+
+//$ ----- Check Debug section ----- //
+void Config::validateDebug(mINI::INIStructure& ini, bool& needsSave) const
+{
+    if (!hasValue(ini, "Debug", "MODE"))
+    {
+        ini["Debug"]["MODE"] = std::to_string(DefaultValues::DEBUG_MODE);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Debug", "MODE");
+        if (val != 0 && val != 1)
+        {
+            ini["Debug"]["MODE"] = std::to_string(DefaultValues::DEBUG_MODE);
+            needsSave = true;
+        }
+    }
+
+    if (!hasValue(ini, "Debug", "TRACE"))
+    {
+        ini["Debug"]["TRACE"] = std::to_string(DefaultValues::TRACE);
+        needsSave = true;
+    }
+    else
+    {
+        int val = getValue(ini, "Debug", "TRACE");
+        if (val != 0 && val != 1)
+        {
+            ini["Debug"]["TRACE"] = std::to_string(DefaultValues::TRACE);
+            needsSave = true;
+        }
     }
 }
 
@@ -579,6 +725,8 @@ int Config::getDefault(const std::string& section, const std::string& key) const
 			return DefaultValues::TARGET_FPS;
 		if (key == "USE_VSYNC")
 			return DefaultValues::USE_VSYNC;
+		if (key == "VRR_MODE")
+			return DefaultValues::VRR_MODE;
 		if (key == "BACKGROUND_COLOR")
 			return DefaultValues::BACKGROUND_COLOR;
 		if (key == "CUSTOM_BG_RED")
@@ -650,10 +798,26 @@ int Config::getDefault(const std::string& section, const std::string& key) const
 		if (key == "START")
 			return SNESMapDefaults::START;
 	}
+	if (section == "Performance")
+	{
+		if (key == "IDLE_MODE")
+			return DefaultValues::IDLE_MODE;
+		if (key == "IDLE_HEARTBEAT_MS")
+			return DefaultValues::IDLE_HEARTBEAT_MS;
+		if (key == "LATCH_MARGIN_MS")
+			return DefaultValues::LATCH_MARGIN_MS;
+	}
+	if (section == "Recording")
+	{
+		if (key == "RECORD_INPUT")
+			return DefaultValues::RECORD_INPUT;
+	}
 	if (section == "Debug") 
 	{
 		if (key == "MODE") 
 			return DefaultValues::DEBUG_MODE;
+		if (key == "TRACE")
+			return DefaultValues::TRACE;
 	}
 	// Fallback if unknown
 	return 0;
@@ -675,5 +839,4 @@ void Config::resetButtonMap()
 		{"SELECT",     "13"},
 		{"START",      "15"}
 	});
-	saveConfig();
 }
@@ -0,0 +1,377 @@
+#include "evdevinput.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <filesystem>
+
+    #include <fcntl.h>
+    #include <linux/input.h>
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+namespace
+{
+    constexpr auto kRescanInterval{ std::chrono::seconds(1) };
+    // An analog-only D-pad counts as pressed past this
+    constexpr float kStickDpadThreshold{ 0.5f };
+
+    // Kernel gamepad layout (Documentation/input/gamepad.rst) -> raylib
+    int buttonFor(int code)
+    {
+        switch (code)
+        {
+        case BTN_DPAD_UP: return GAMEPAD_BUTTON_LEFT_FACE_UP;
+        case BTN_DPAD_RIGHT: return GAMEPAD_BUTTON_LEFT_FACE_RIGHT;
+        case BTN_DPAD_DOWN: return GAMEPAD_BUTTON_LEFT_FACE_DOWN;
+        case BTN_DPAD_LEFT: return GAMEPAD_BUTTON_LEFT_FACE_LEFT;
+        case BTN_NORTH: return GAMEPAD_BUTTON_RIGHT_FACE_UP;
+        case BTN_EAST: return GAMEPAD_BUTTON_RIGHT_FACE_RIGHT;
+        case BTN_SOUTH: return GAMEPAD_BUTTON_RIGHT_FACE_DOWN;
+        case BTN_WEST: return GAMEPAD_BUTTON_RIGHT_FACE_LEFT;
+        case BTN_TL: return GAMEPAD_BUTTON_LEFT_TRIGGER_1;
+        case BTN_TL2: return GAMEPAD_BUTTON_LEFT_TRIGGER_2;
+        case BTN_TR: return GAMEPAD_BUTTON_RIGHT_TRIGGER_1;
+        case BTN_TR2: return GAMEPAD_BUTTON_RIGHT_TRIGGER_2;
+        case BTN_SELECT: return GAMEPAD_BUTTON_MIDDLE_LEFT;
+        case BTN_MODE: return GAMEPAD_BUTTON_MIDDLE;
+        case BTN_START: return GAMEPAD_BUTTON_MIDDLE_RIGHT;
+        case BTN_THUMBL: return GAMEPAD_BUTTON_LEFT_THUMB;
+        case BTN_THUMBR: return GAMEPAD_BUTTON_RIGHT_THUMB;
+        default: return GAMEPAD_BUTTON_UNKNOWN;
+        }
+    }
+
+    // raylib GamepadAxis for an ABS code, -1 if it isn't one
+    int axisFor(int code)
+    {
+        switch (code)
+        {
+        case ABS_X: return GAMEPAD_AXIS_LEFT_X;
+        case ABS_Y: return GAMEPAD_AXIS_LEFT_Y;
+        case ABS_RX: return GAMEPAD_AXIS_RIGHT_X;
+        case ABS_RY: return GAMEPAD_AXIS_RIGHT_Y;
+        case ABS_Z: return GAMEPAD_AXIS_LEFT_TRIGGER;
+        case ABS_RZ: return GAMEPAD_AXIS_RIGHT_TRIGGER;
+        default: return -1;
+        }
+    }
+
+    template <size_t N>
+    bool testBit(const std::array<unsigned long, N>& bits, int bit)
+    {
+        constexpr int bitsPerLong = sizeof(unsigned long) * 8;
+        return (bits[bit / bitsPerLong] >> (bit % bitsPerLong)) & 1UL;
+    }
+
+    constexpr size_t longsFor(int bits)
+    {
+        return (bits + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8);
+    }
+
+    // Same test as InputWatcher: joystick/gamepad buttons, so not a keyboard or mouse
+    bool isJoystick(const std::array<unsigned long, longsFor(KEY_CNT)>& keyBits)
+    {
+        for (int code = BTN_JOYSTICK; code < BTN_DIGI; ++code)
+        {
+            if (testBit(keyBits, code))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool EvdevInput::open()
+{
+    close();
+    std::error_code ec;
+    if (!std::filesystem::is_directory("/dev/input", ec))
+    {
+        return false;
+    }
+    mOpen = true;
+    scan();
+    return true;
+}
+
+void EvdevInput::close()
+{
+    for (Device& device : mDevices)
+    {
+        if (device.fd >= 0)
+        {
+            ::close(device.fd);
+        }
+    }
+    mDevices.clear();
+    mOpen = false;
+}
+
+void EvdevInput::scan()
+{
+    mLastScan = std::chrono::steady_clock::now();
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/input", ec))
+    {
+        if (entry.path().filename().string().starts_with("event"))
+        {
+            paths.push_back(entry.path().string());
+        }
+    }
+    // event2 before event10
+    std::sort(paths.begin(), paths.end(), [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+
+    for (const std::string& path : paths)
+    {
+        if (std::any_of(mDevices.begin(), mDevices.end(),
+                        [&](const Device& device) { return device.fd >= 0 && device.path == path; }))
+        {
+            continue;
+        }
+        const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        std::array<unsigned long, longsFor(KEY_CNT)> keyBits{};
+        std::array<unsigned long, longsFor(ABS_CNT)> absBits{};
+        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits.data()) < 0 || !isJoystick(keyBits))
+        {
+            ::close(fd);
+            continue;
+        }
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits.data());
+
+        Device device;
+        device.fd = fd;
+        device.path = path;
+        char name[128]{};
+        if (ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) >= 0)
+        {
+            device.name = name;
+        }
+        for (int code : { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ })
+        {
+            input_absinfo info{};
+            if (testBit(absBits, code) && ioctl(fd, EVIOCGABS(code), &info) >= 0 && info.maximum > info.minimum)
+            {
+                device.ranges[axisFor(code)] = AxisRange{ info.minimum, info.maximum };
+            }
+        }
+        device.stickIsDpad = !testBit(absBits, ABS_HAT0X) && !testBit(keyBits, BTN_DPAD_UP)
+                             && testBit(absBits, ABS_X) && testBit(absBits, ABS_Y);
+        sync(device);
+
+        // Like GLFW's joystick slots: an unplugged pad leaves its index free
+        // and the next pad plugged in takes the first free one
+        const auto freeSlot = std::find_if(mDevices.begin(), mDevices.end(),
+                                           [](const Device& slot) { return slot.fd < 0; });
+        if (freeSlot != mDevices.end())
+        {
+            *freeSlot = std::move(device);
+        }
+        else
+        {
+            mDevices.push_back(std::move(device));
+        }
+    }
+}
+
+void EvdevInput::sync(Device& device)
+{
+    // Start over from the kernel's view of the device (on open, and after SYN_DROPPED)
+    std::array<unsigned long, longsFor(KEY_CNT)> keys{};
+    ioctl(device.fd, EVIOCGKEY(sizeof(keys)), keys.data());
+    device.buttons = 0;
+    for (int code = BTN_MISC; code < BTN_DIGI; ++code)
+    {
+        if (testBit(keys, code))
+        {
+            setButton(device, buttonFor(code), true);
+        }
+    }
+    for (int code = BTN_DPAD_UP; code <= BTN_DPAD_RIGHT; ++code)
+    {
+        if (testBit(keys, code))
+        {
+            setButton(device, buttonFor(code), true);
+        }
+    }
+    for (int code : { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_HAT0X, ABS_HAT0Y })
+    {
+        input_absinfo info{};
+        if (ioctl(device.fd, EVIOCGABS(code), &info) >= 0)
+        {
+            setAxis(device, code, info.value);
+        }
+    }
+}
+
+void EvdevInput::setButton(Device& device, int button, bool down)
+{
+    if (button == GAMEPAD_BUTTON_UNKNOWN)
+    {
+        return;
+    }
+    const uint32_t bit = 1u << button;
+    if (down && (device.buttons & bit) == 0)
+    {
+        mLastPressed = mLastPressed == 0 ? button : mLastPressed;
+    }
+    device.buttons = down ? device.buttons | bit : device.buttons & ~bit;
+}
+
+void EvdevInput::setAxis(Device& device, int code, int value)
+{
+    if (code == ABS_HAT0X || code == ABS_HAT0Y)
+    {
+        const int negative = code == ABS_HAT0X ? GAMEPAD_BUTTON_LEFT_FACE_LEFT : GAMEPAD_BUTTON_LEFT_FACE_UP;
+        const int positive = code == ABS_HAT0X ? GAMEPAD_BUTTON_LEFT_FACE_RIGHT : GAMEPAD_BUTTON_LEFT_FACE_DOWN;
+        const uint32_t before = device.hatButtons;
+        device.hatButtons &= ~((1u << negative) | (1u << positive));
+        device.hatButtons |= value < 0 ? 1u << negative : (value > 0 ? 1u << positive : 0u);
+        const uint32_t pressed = device.hatButtons & ~before;
+        if (pressed != 0 && mLastPressed == 0)
+        {
+            mLastPressed = value < 0 ? negative : positive;
+        }
+        return;
+    }
+
+    const int axis = axisFor(code);
+    if (axis < 0)
+    {
+        return;
+    }
+    const AxisRange& range = device.ranges[axis];
+    const float normalized = 2.0f * static_cast<float>(value - range.minimum)
+                             / static_cast<float>(range.maximum - range.minimum) - 1.0f;
+    device.axes[axis] = std::clamp(normalized, -1.0f, 1.0f);
+
+    if (device.stickIsDpad && (axis == GAMEPAD_AXIS_LEFT_X || axis == GAMEPAD_AXIS_LEFT_Y))
+    {
+        const float x = device.axes[GAMEPAD_AXIS_LEFT_X];
+        const float y = device.axes[GAMEPAD_AXIS_LEFT_Y];
+        const uint32_t before = device.stickButtons;
+        device.stickButtons = (x < -kStickDpadThreshold ? 1u << GAMEPAD_BUTTON_LEFT_FACE_LEFT : 0u)
+                              | (x > kStickDpadThreshold ? 1u << GAMEPAD_BUTTON_LEFT_FACE_RIGHT : 0u)
+                              | (y < -kStickDpadThreshold ? 1u << GAMEPAD_BUTTON_LEFT_FACE_UP : 0u)
+                              | (y > kStickDpadThreshold ? 1u << GAMEPAD_BUTTON_LEFT_FACE_DOWN : 0u);
+        const uint32_t pressed = device.stickButtons & ~before;
+        if (pressed != 0 && mLastPressed == 0)
+        {
+            for (int button = GAMEPAD_BUTTON_LEFT_FACE_UP; button <= GAMEPAD_BUTTON_LEFT_FACE_LEFT; ++button)
+            {
+                if ((pressed & (1u << button)) != 0)
+                {
+                    mLastPressed = button;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void EvdevInput::read(Device& device)
+{
+    std::array<input_event, 64> events;
+    while (device.fd >= 0)
+    {
+        const ssize_t bytes = ::read(device.fd, events.data(), sizeof(events));
+        if (bytes < 0)
+        {
+            if (errno == ENODEV)
+            {
+                // Unplugged; frees the slot
+                ::close(device.fd);
+                device.fd = -1;
+            }
+            return;
+        }
+        const size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const input_event& event = events[i];
+            if (event.type == EV_KEY)
+            {
+                setButton(device, buttonFor(event.code), event.value != 0);
+            }
+            else if (event.type == EV_ABS)
+            {
+                setAxis(device, event.code, event.value);
+            }
+            else if (event.type == EV_SYN && event.code == SYN_DROPPED)
+            {
+                sync(device);
+                return;
+            }
+        }
+        if (count < events.size())
+        {
+            return;
+        }
+    }
+}
+
+void EvdevInput::update()
+{
+    if (!mOpen)
+    {
+        return;
+    }
+    mLastPressed = 0;
+    if (std::chrono::steady_clock::now() - mLastScan >= kRescanInterval)
+    {
+        scan();
+    }
+    for (Device& device : mDevices)
+    {
+        read(device);
+    }
+}
+
+bool EvdevInput::isAvailable(int gamepad) const
+{
+    return gamepad >= 0 && gamepad < static_cast<int>(mDevices.size()) && mDevices[gamepad].fd >= 0;
+}
+
+const char* EvdevInput::getName(int gamepad) const
+{
+    return isAvailable(gamepad) ? mDevices[gamepad].name.c_str() : "";
+}
+
+PadState EvdevInput::sample(int gamepad)
+{
+    PadState pad;
+    pad.gamepad = gamepad;
+    if (!isAvailable(gamepad))
+    {
+        return pad;
+    }
+    Device& device = mDevices[gamepad];
+    read(device);
+    pad.buttons = device.buttons | device.hatButtons | device.stickButtons;
+    pad.axes = device.axes;
+    return pad;
+}
+
+#else
+
+bool EvdevInput::open() { return false; }
+void EvdevInput::close() {}
+void EvdevInput::update() {}
+bool EvdevInput::isAvailable(int gamepad) const { (void)gamepad; return false; }
+const char* EvdevInput::getName(int gamepad) const { (void)gamepad; return ""; }
+PadState EvdevInput::sample(int gamepad) { PadState pad; pad.gamepad = gamepad; return pad; }
+
+#endif
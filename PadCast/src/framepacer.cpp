@@ -0,0 +1,192 @@
+#include "framepacer.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    FramePacer::Clock::duration periodFor(int rate)
+    {
+        if (rate <= 0)
+        {
+            return FramePacer::Clock::duration::zero();
+        }
+        return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    }
+}
+
+void FramePacer::setTargetFPS(int fps)
+{
+    mTargetFPS = std::max(fps, 0);
+    applyMode();
+}
+
+void FramePacer::setVSync(bool enabled)
+{
+    mVSync = enabled;
+    applyMode();
+}
+
+void FramePacer::setVRR(bool enabled)
+{
+    mVRR = enabled;
+    applyMode();
+}
+
+void FramePacer::setRefreshRate(int refreshRate)
+{
+    mRefreshRate = std::max(refreshRate, 0);
+    applyMode();
+}
+
+void FramePacer::applyMode()
+{
+    if (mVSync)
+    {
+        mPacedFPS = 0;
+        mPeriod = periodFor(mRefreshRate);
+    }
+    else if (mVRR)
+    {
+        mPacedFPS = mRefreshRate;
+        mPeriod = periodFor(mRefreshRate);
+    }
+    else
+    {
+        mPacedFPS = mTargetFPS;
+        mPeriod = periodFor(mTargetFPS);
+    }
+    // Start a fresh deadline sequence from the next frame
+    mNextDeadline = Clock::time_point{};
+    mLastPresent = Clock::time_point{};
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+    Clock::time_point now = Clock::now();
+    if (now >= deadline)
+    {
+        return;
+    }
+    if (deadline - now > kSpinMargin)
+    {
+        std::this_thread::sleep_until(deadline - kSpinMargin);
+    }
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::waitForLatch()
+{
+    PADCAST_TRACE_SCOPE("waitForLatch");
+    if (mPeriod == Clock::duration::zero() || mLatchMargin == Clock::duration::zero())
+    {
+        return;
+    }
+
+    if (mVSync)
+    {
+        // Only trust the prediction while presents are arriving once per
+        // refresh; after a stall or an idle wait the phase is unknown and
+        // waiting could make us miss the vblank we're aiming for.
+        if (mLastPresent == Clock::time_point{} || mLastPresentInterval > mPeriod + mPeriod / 2)
+        {
+            return;
+        }
+        waitUntil(mLastPresent + mPeriod - mLatchMargin);
+        return;
+    }
+
+    if (mNextDeadline == Clock::time_point{})
+    {
+        return;
+    }
+    waitUntil(mNextDeadline - mLatchMargin);
+}
+
+void FramePacer::markPresented()
+{
+    const Clock::time_point now = Clock::now();
+    if (mLastPresent != Clock::time_point{})
+    {
+        mLastPresentInterval = now - mLastPresent;
+    }
+    mLastPresent = now;
+}
+
+void FramePacer::waitForNextCheck()
+{
+    PADCAST_TRACE_SCOPE("waitForNextCheck");
+    // A plain sleep: a change found after it is presented within the same
+    // period, so there's no deadline to hit precisely
+    const Clock::duration period = mPeriod != Clock::duration::zero() ? mPeriod : periodFor(60);
+    std::this_thread::sleep_for(period);
+}
+
+void FramePacer::waitForNextFrame()
+{
+    PADCAST_TRACE_SCOPE("waitForNextFrame");
+    Clock::time_point now = Clock::now();
+
+    if (mPacedFPS <= 0)
+    {
+        recordFrame(now);
+        return;
+    }
+
+    // First frame of a new sequence goes out immediately and anchors the rest
+    if (mNextDeadline == Clock::time_point{})
+    {
+        mNextDeadline = now;
+    }
+
+    if (now < mNextDeadline)
+    {
+        waitUntil(mNextDeadline);
+        now = Clock::now();
+    }
+
+    // VRR only presents when something changed, so a gap isn't a miss, and the
+    // cap is a minimum spacing between presents rather than a fixed cadence
+    if (mVRR)
+    {
+        mNextDeadline = now + mPeriod;
+        recordFrame(now);
+        return;
+    }
+
+    // Anything past a tenth of a frame late is a miss the capture will notice
+    const auto lateness = now - mNextDeadline;
+    const double latenessMs = std::chrono::duration<double, std::milli>(lateness).count();
+    mStats.lastLatenessMs = latenessMs;
+    mStats.worstLatenessMs = std::max(mStats.worstLatenessMs, latenessMs);
+    if (lateness > mPeriod / 10)
+    {
+        ++mStats.missedDeadlines;
+    }
+
+    // Advance from the deadline rather than from "now" so error doesn't build up.
+    // If we're more than a whole frame behind (stall, event waiting, window drag)
+    // re-anchor instead of rushing out a burst of catch-up frames.
+    mNextDeadline += mPeriod;
+    if (now - mNextDeadline > mPeriod)
+    {
+        mNextDeadline = now + mPeriod;
+    }
+
+    recordFrame(now);
+}
+
+void FramePacer::recordFrame(Clock::time_point now)
+{
+    if (mLastFrame != Clock::time_point{})
+    {
+        mHistory[mHistoryHead] = std::chrono::duration<float, std::milli>(now - mLastFrame).count();
+        mHistoryHead = (mHistoryHead + 1) % kHistorySize;
+    }
+    mLastFrame = now;
+    ++mStats.frames;
+}
@@ -0,0 +1,144 @@
+#include "gputimer.h"
+#include "glfwbridge.h"
+
+#ifdef _WIN32
+    #define PADCAST_GLAPI __stdcall
+#else
+    #define PADCAST_GLAPI
+#endif
+
+namespace
+{
+    constexpr unsigned int GL_TIME_ELAPSED_ID{ 0x88BF };
+    constexpr unsigned int GL_QUERY_RESULT_ID{ 0x8866 };
+    constexpr unsigned int GL_QUERY_RESULT_AVAILABLE_ID{ 0x8867 };
+
+    using GenQueriesFn = void (PADCAST_GLAPI*)(int, unsigned int*);
+    using DeleteQueriesFn = void (PADCAST_GLAPI*)(int, const unsigned int*);
+    using BeginQueryFn = void (PADCAST_GLAPI*)(unsigned int, unsigned int);
+    using EndQueryFn = void (PADCAST_GLAPI*)(unsigned int);
+    using GetQueryObjectivFn = void (PADCAST_GLAPI*)(unsigned int, unsigned int, int*);
+    using GetQueryObjectui64vFn = void (PADCAST_GLAPI*)(unsigned int, unsigned int, uint64_t*);
+
+    GenQueriesFn glGenQueriesPtr{ nullptr };
+    DeleteQueriesFn glDeleteQueriesPtr{ nullptr };
+    BeginQueryFn glBeginQueryPtr{ nullptr };
+    EndQueryFn glEndQueryPtr{ nullptr };
+    GetQueryObjectivFn glGetQueryObjectivPtr{ nullptr };
+    GetQueryObjectui64vFn glGetQueryObjectui64vPtr{ nullptr };
+
+    template <typename Fn>
+    bool load(Fn& fn, const char* name)
+    {
+        fn = reinterpret_cast<Fn>(glfwGetProcAddress(name));
+        return fn != nullptr;
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (mSupported)
+    {
+        glDeleteQueriesPtr(static_cast<int>(kQueryCount), mQueries.data());
+    }
+}
+
+bool GpuTimer::init()
+{
+    mInitialized = true;
+    mSupported = load(glGenQueriesPtr, "glGenQueries")
+        && load(glDeleteQueriesPtr, "glDeleteQueries")
+        && load(glBeginQueryPtr, "glBeginQuery")
+        && load(glEndQueryPtr, "glEndQuery")
+        && load(glGetQueryObjectivPtr, "glGetQueryObjectiv")
+        && load(glGetQueryObjectui64vPtr, "glGetQueryObjectui64v");
+
+    if (mSupported)
+    {
+        glGenQueriesPtr(static_cast<int>(kQueryCount), mQueries.data());
+    }
+    return mSupported;
+}
+
+void GpuTimer::collect()
+{
+    // Oldest first, stop at the first frame the GPU hasn't finished
+    for (size_t n = 0; n < kFrameCount; ++n)
+    {
+        const size_t frame = (mWriteIndex + n) % kFrameCount;
+        if (!mPending[frame])
+        {
+            continue;
+        }
+        int available = 0;
+        glGetQueryObjectivPtr(mQueries[frame * kMaxSegments + mSegments[frame] - 1], GL_QUERY_RESULT_AVAILABLE_ID,
+                              &available);
+        if (!available)
+        {
+            break;
+        }
+        uint64_t totalNs = 0;
+        for (size_t segment = 0; segment < mSegments[frame]; ++segment)
+        {
+            uint64_t elapsedNs = 0;
+            glGetQueryObjectui64vPtr(mQueries[frame * kMaxSegments + segment], GL_QUERY_RESULT_ID, &elapsedNs);
+            totalNs += elapsedNs;
+        }
+        mLastMs = static_cast<double>(totalNs) / 1.0e6;
+        mPending[frame] = false;
+    }
+}
+
+void GpuTimer::begin()
+{
+    if (!mInitialized && !init())
+    {
+        return;
+    }
+    if (!mSupported || mActive)
+    {
+        return;
+    }
+
+    if (!mFrameOpen)
+    {
+        collect();
+        mFrameOpen = true;
+        mSegmentCount = 0;
+        // Every frame still in flight -- skip measuring this one rather than wait
+        mSkipFrame = mPending[mWriteIndex];
+    }
+    if (mSkipFrame || mSegmentCount >= kMaxSegments)
+    {
+        return;
+    }
+    glBeginQueryPtr(GL_TIME_ELAPSED_ID, mQueries[mWriteIndex * kMaxSegments + mSegmentCount]);
+    mActive = true;
+}
+
+void GpuTimer::end()
+{
+    if (!mActive)
+    {
+        return;
+    }
+    glEndQueryPtr(GL_TIME_ELAPSED_ID);
+    ++mSegmentCount;
+    mActive = false;
+}
+
+void GpuTimer::endFrame()
+{
+    end();
+    if (!mFrameOpen)
+    {
+        return;
+    }
+    if (!mSkipFrame && mSegmentCount > 0)
+    {
+        mSegments[mWriteIndex] = mSegmentCount;
+        mPending[mWriteIndex] = true;
+        mWriteIndex = (mWriteIndex + 1) % kFrameCount;
+    }
+    mFrameOpen = false;
+}
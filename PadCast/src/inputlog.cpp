@@ -0,0 +1,383 @@
+#include "inputlog.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace inputlog
+{
+    namespace
+    {
+        void putLE(std::vector<uint8_t>& out, uint64_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        uint64_t getLE(const uint8_t* p, int bytes)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i)
+            {
+                value |= static_cast<uint64_t>(p[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        uint64_t zigzag(int64_t value)
+        {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        int64_t unzigzag(uint64_t value)
+        {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+    }
+
+    void Header::write(std::vector<uint8_t>& out) const
+    {
+        out.insert(out.end(), kMagic.begin(), kMagic.end());
+        out.push_back(version);
+        out.push_back(axisCount);
+        putLE(out, tickUs, 2);
+        putLE(out, startUnixMs, 8);
+    }
+
+    bool Header::read(const uint8_t* data, size_t size, Header& out)
+    {
+        if (size < kHeaderSize || !std::equal(kMagic.begin(), kMagic.end(), data))
+        {
+            return false;
+        }
+        out.version = data[4];
+        out.axisCount = data[5];
+        out.tickUs = static_cast<uint16_t>(getLE(data + 6, 2));
+        out.startUnixMs = getLE(data + 8, 8);
+        return out.version == kVersion && out.axisCount == PadState::kAxisCount && out.tickUs != 0;
+    }
+
+    void Index::write(std::vector<uint8_t>& out, uint64_t offset) const
+    {
+        out.push_back(static_cast<uint8_t>(Kind::Index));
+        putVarint(out, keyframes.size());
+        IndexEntry previous{};
+        for (const IndexEntry& entry : keyframes)
+        {
+            putVarint(out, entry.ticks - previous.ticks);
+            putVarint(out, entry.offset - previous.offset);
+            previous = entry;
+        }
+        putVarint(out, endTicks);
+        putLE(out, offset, 8);
+        out.insert(out.end(), kIndexMagic.begin(), kIndexMagic.end());
+    }
+
+    bool Index::read(const uint8_t* records, const uint8_t* end, Index& out)
+    {
+        const size_t size = static_cast<size_t>(end - records);
+        if (size < kIndexTrailerSize || !std::equal(kIndexMagic.begin(), kIndexMagic.end(), end - kIndexMagic.size()))
+        {
+            return false;
+        }
+        const uint8_t* indexEnd = end - kIndexTrailerSize;
+        const uint64_t offset = getLE(indexEnd, 8);
+        if (offset >= size - kIndexTrailerSize || records[offset] != static_cast<uint8_t>(Kind::Index))
+        {
+            return false;
+        }
+
+        // Checked as it's read, so a damaged index falls back to a scan
+        // rather than sending seeks into the middle of a record
+        const uint8_t* p = records + offset + 1;
+        uint64_t count = 0;
+        if (!getVarint(p, indexEnd, count) || count > static_cast<uint64_t>(indexEnd - p) / 2)
+        {
+            return false;
+        }
+        Index index;
+        index.recordsSize = offset;
+        index.keyframes.reserve(static_cast<size_t>(count));
+        IndexEntry entry{};
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t ticks = 0;
+            uint64_t bytes = 0;
+            if (!getVarint(p, indexEnd, ticks) || !getVarint(p, indexEnd, bytes)
+                || (i > 0 && bytes == 0) || bytes >= offset - entry.offset || entry.ticks + ticks < entry.ticks)
+            {
+                return false;
+            }
+            entry.ticks += ticks;
+            entry.offset += bytes;
+            index.keyframes.push_back(entry);
+        }
+        if (!getVarint(p, indexEnd, index.endTicks) || p != indexEnd
+            || (!index.keyframes.empty() && index.endTicks < index.keyframes.back().ticks))
+        {
+            return false;
+        }
+        out = std::move(index);
+        return true;
+    }
+
+    Sample Sample::fromPad(const PadState& pad, bool connected, uint64_t ticks)
+    {
+        Sample sample;
+        sample.ticks = ticks;
+        sample.connected = connected;
+        if (connected)
+        {
+            sample.buttons = pad.buttons;
+            for (int i = 0; i < PadState::kAxisCount; ++i)
+            {
+                sample.axes[i] = quantizeAxis(pad.axes[i]);
+            }
+        }
+        return sample;
+    }
+
+    PadState Sample::toPad(int gamepad) const
+    {
+        PadState pad;
+        pad.gamepad = gamepad;
+        pad.buttons = buttons;
+        for (int i = 0; i < PadState::kAxisCount; ++i)
+        {
+            pad.axes[i] = dequantizeAxis(axes[i]);
+        }
+        return pad;
+    }
+
+    int8_t quantizeAxis(float value)
+    {
+        return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+    }
+
+    float dequantizeAxis(int8_t value)
+    {
+        return static_cast<float>(value) / 127.0f;
+    }
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (p == end)
+            {
+                return false;
+            }
+            const uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //$ ----- Encoder ----- //
+
+    void Encoder::writeKeyframe(const Sample& sample, std::vector<uint8_t>& out)
+    {
+        out.push_back(static_cast<uint8_t>(Kind::Keyframe));
+        putVarint(out, sample.ticks);
+        out.push_back(sample.connected ? 1 : 0);
+        putVarint(out, sample.buttons);
+        for (int8_t axis : sample.axes)
+        {
+            out.push_back(static_cast<uint8_t>(axis));
+        }
+        mLastKeyframe = sample.ticks;
+        mForceKeyframe = false;
+    }
+
+    bool Encoder::encode(const Sample& input, std::vector<uint8_t>& out)
+    {
+        Sample sample{ input };
+        sample.ticks = std::max(sample.ticks, mLast.ticks);
+
+        // Nothing to write; times stay relative to the last record actually written
+        if (!mForceKeyframe && sample.sameState(mLast))
+        {
+            return false;
+        }
+
+        if (mForceKeyframe || sample.ticks - mLastKeyframe >= kKeyframeIntervalTicks)
+        {
+            writeKeyframe(sample, out);
+            mLast = sample;
+            return true;
+        }
+
+        uint64_t delta = sample.ticks - mLast.ticks;
+
+        if (sample.connected != mLast.connected)
+        {
+            out.push_back(static_cast<uint8_t>(Kind::Connection) | (sample.connected ? kConnected : 0));
+            putVarint(out, delta);
+            delta = 0;
+        }
+
+        const uint32_t changedButtons = sample.buttons ^ mLast.buttons;
+        uint8_t changedAxes = 0;
+        for (int i = 0; i < PadState::kAxisCount; ++i)
+        {
+            if (sample.axes[i] != mLast.axes[i])
+            {
+                changedAxes |= static_cast<uint8_t>(1u << i);
+            }
+        }
+
+        if (changedButtons != 0 || changedAxes != 0)
+        {
+            // The common case -- one button going up or down -- is 3-4 bytes in total
+            const bool single = std::popcount(changedButtons) == 1;
+            uint8_t tag = static_cast<uint8_t>(Kind::Delta);
+            tag |= changedButtons ? kHasButtons : 0;
+            tag |= single ? kSingleButton : 0;
+            tag |= changedAxes ? kHasAxes : 0;
+            out.push_back(tag);
+            putVarint(out, delta);
+            if (single)
+            {
+                out.push_back(static_cast<uint8_t>(std::countr_zero(changedButtons)));
+            }
+            else if (changedButtons)
+            {
+                putVarint(out, changedButtons);
+            }
+            if (changedAxes)
+            {
+                out.push_back(changedAxes);
+                for (int i = 0; i < PadState::kAxisCount; ++i)
+                {
+                    if (changedAxes & (1u << i))
+                    {
+                        putVarint(out, zigzag(static_cast<int64_t>(sample.axes[i]) - mLast.axes[i]));
+                    }
+                }
+            }
+        }
+
+        mLast = sample;
+        return false;
+    }
+
+    //$ ----- Decoder ----- //
+
+    bool Decoder::next(Sample& state)
+    {
+        if (mPos == nullptr || mPos >= mEnd)
+        {
+            return false;
+        }
+
+        // Work on copies so a truncated record leaves state and position alone
+        const uint8_t* p = mPos;
+        Sample s{ state };
+        const uint8_t tag = *p++;
+        const Kind kind = static_cast<Kind>(tag & kKindMask);
+        uint64_t value = 0;
+
+        switch (kind)
+        {
+        case Kind::Keyframe:
+            if (!getVarint(p, mEnd, s.ticks) || mEnd - p < 1)
+            {
+                return false;
+            }
+            s.connected = *p++ != 0;
+            if (!getVarint(p, mEnd, value) || mEnd - p < PadState::kAxisCount)
+            {
+                return false;
+            }
+            s.buttons = static_cast<uint32_t>(value);
+            for (int i = 0; i < PadState::kAxisCount; ++i)
+            {
+                s.axes[i] = static_cast<int8_t>(*p++);
+            }
+            break;
+
+        case Kind::Connection:
+            if (!getVarint(p, mEnd, value))
+            {
+                return false;
+            }
+            s.ticks += value;
+            s.connected = (tag & kConnected) != 0;
+            break;
+
+        case Kind::Delta:
+            if (!getVarint(p, mEnd, value))
+            {
+                return false;
+            }
+            s.ticks += value;
+            if (tag & kSingleButton)
+            {
+                if (p == mEnd || *p >= 32)
+                {
+                    return false;
+                }
+                s.buttons ^= 1u << *p++;
+            }
+            else if (tag & kHasButtons)
+            {
+                if (!getVarint(p, mEnd, value))
+                {
+                    return false;
+                }
+                s.buttons ^= static_cast<uint32_t>(value);
+            }
+            if (tag & kHasAxes)
+            {
+                if (p == mEnd)
+                {
+                    return false;
+                }
+                const uint8_t mask = *p++;
+                for (int i = 0; i < PadState::kAxisCount; ++i)
+                {
+                    if (mask & (1u << i))
+                    {
+                        if (!getVarint(p, mEnd, value))
+                        {
+                            return false;
+                        }
+                        s.axes[i] = static_cast<int8_t>(s.axes[i] + unzigzag(value));
+                    }
+                }
+            }
+            break;
+
+        case Kind::Index:
+            // The records end here; the rest is the keyframe index
+            return false;
+
+        default:
+            // Unknown record kind: the file is from a newer version or damaged
+            return false;
+        }
+
+        state = s;
+        mPos = p;
+        mLastKind = kind;
+        return true;
+    }
+}
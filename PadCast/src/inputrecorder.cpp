@@ -0,0 +1,183 @@
+#include "inputrecorder.h"
+#include "trace.h"
+
+#include <cstdlib>
+#include <ctime>
+
+std::string InputRecorder::sessionFileName()
+{
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    char name[64];
+    std::strftime(name, sizeof(name), "padcast-%Y%m%d-%H%M%S.pcrec", &local);
+    return name;
+}
+
+bool InputRecorder::start(const std::string& path)
+{
+    stop();
+
+    mFile = std::fopen(path.c_str(), "wb");
+    if (mFile == nullptr)
+    {
+        TraceLog(LOG_WARNING, "Can't create input recording %s", path.c_str());
+        return false;
+    }
+
+    mPath = path;
+    mStart = Clock::now();
+    mHead.store(0, std::memory_order_relaxed);
+    mTail.store(0, std::memory_order_relaxed);
+    mHavePushed = false;
+    mNeedKeyframe = false;
+    mDropped.store(0, std::memory_order_relaxed);
+    mEncoder = inputlog::Encoder{};
+    mIndex = inputlog::Index{};
+    mBuffer.clear();
+    mBuffer.reserve(8192);
+
+    inputlog::Header header;
+    header.startUnixMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    header.write(mBuffer);
+    mBytesWritten.store(0, std::memory_order_relaxed);
+    flushBuffer();
+
+    mRunning.store(true, std::memory_order_release);
+    mThread = std::thread(&InputRecorder::run, this);
+    TraceLog(LOG_INFO, "Recording input to %s", path.c_str());
+    return true;
+}
+
+void InputRecorder::stop()
+{
+    if (!mThread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard lock{ mStopMutex };
+        mRunning.store(false, std::memory_order_release);
+    }
+    mStopSignal.notify_all();
+    mThread.join();
+
+    std::fclose(mFile);
+    mFile = nullptr;
+    TraceLog(LOG_INFO, "Input recording closed: %llu bytes, %llu samples dropped",
+             static_cast<unsigned long long>(getBytesWritten()),
+             static_cast<unsigned long long>(getDroppedSamples()));
+}
+
+void InputRecorder::record(const PadState& pad, bool connected)
+{
+    if (!mRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const uint64_t ticks = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mStart).count()) / inputlog::kTickUs;
+    inputlog::Sample sample = inputlog::Sample::fromPad(pad, connected, ticks);
+    if (mHavePushed && sample.connected && mLastPushed.connected)
+    {
+        for (size_t i = 0; i < sample.axes.size(); ++i)
+        {
+            const int axis = sample.axes[i];
+            if (std::abs(axis - mLastPushed.axes[i]) < kAxisStep && axis != 0 && std::abs(axis) != 127)
+            {
+                sample.axes[i] = mLastPushed.axes[i];
+            }
+        }
+    }
+    if (mHavePushed && sample.sameState(mLastPushed))
+    {
+        return;
+    }
+
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (head - mTail.load(std::memory_order_acquire) >= kRingSize)
+    {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        mNeedKeyframe = true;
+        return;
+    }
+
+    mRing[head % kRingSize] = Entry{ sample, mNeedKeyframe };
+    mHead.store(head + 1, std::memory_order_release);
+    mLastPushed = sample;
+    mHavePushed = true;
+    mNeedKeyframe = false;
+}
+
+bool InputRecorder::drainRing()
+{
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    const size_t head = mHead.load(std::memory_order_acquire);
+    if (tail == head)
+    {
+        return false;
+    }
+
+    for (; tail != head; ++tail)
+    {
+        const Entry& entry = mRing[tail % kRingSize];
+        if (entry.keyframe)
+        {
+            mEncoder.forceKeyframe();
+        }
+        const uint64_t offset = recordsOffset();
+        if (mEncoder.encode(entry.sample, mBuffer))
+        {
+            mIndex.keyframes.push_back({ mEncoder.getLastTicks(), offset });
+        }
+    }
+    mTail.store(tail, std::memory_order_release);
+    return true;
+}
+
+void InputRecorder::flushBuffer()
+{
+    if (!mBuffer.empty())
+    {
+        const size_t written = std::fwrite(mBuffer.data(), 1, mBuffer.size(), mFile);
+        mBytesWritten.fetch_add(written, std::memory_order_relaxed);
+        mBuffer.clear();
+    }
+    // Bounds what a crash can lose to about kFlushPeriod of input
+    std::fflush(mFile);
+    mLastFlush = Clock::now();
+}
+
+void InputRecorder::run()
+{
+    trace::setThreadName("InputRecorder");
+
+    std::unique_lock lock{ mStopMutex };
+    while (mRunning.load(std::memory_order_acquire))
+    {
+        mStopSignal.wait_for(lock, kWriterPeriod, [this] { return !mRunning.load(std::memory_order_acquire); });
+        lock.unlock();
+        {
+            PADCAST_TRACE_SCOPE("InputRecorder write");
+            drainRing();
+            if (mBuffer.size() >= 4096 || (!mBuffer.empty() && Clock::now() - mLastFlush >= kFlushPeriod))
+            {
+                flushBuffer();
+            }
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    // The render thread has stopped producing by now (mRunning is false)
+    drainRing();
+    mIndex.endTicks = mEncoder.getLastTicks();
+    mIndex.write(mBuffer, recordsOffset());
+    flushBuffer();
+}
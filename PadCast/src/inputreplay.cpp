@@ -0,0 +1,216 @@
+#include "inputreplay.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr double kMinSpeed{ 1.0 / 64.0 };
+    constexpr double kMaxSpeed{ 64.0 };
+}
+
+bool InputReplay::open(const std::string& path, std::string& error)
+{
+    if (!mFile.open(path))
+    {
+        error = "can't open file";
+        return false;
+    }
+    if (!inputlog::Header::read(mFile.data(), mFile.size(), mHeader))
+    {
+        error = "not a PadCast input recording, or written by a newer version";
+        return false;
+    }
+    mTickSeconds = mHeader.tickUs / 1'000'000.0;
+
+    const uint8_t* records = mFile.data() + inputlog::kHeaderSize;
+    const uint8_t* end = mFile.data() + mFile.size();
+    inputlog::Index index;
+    const bool indexed = inputlog::Index::read(records, end, index);
+    if (indexed)
+    {
+        mDecoder = inputlog::Decoder{ records, records + index.recordsSize };
+        mKeyframes = std::move(index.keyframes);
+        mEndTicks = index.endTicks;
+    }
+    else
+    {
+        mDecoder = inputlog::Decoder{ records, end };
+        scanKeyframes();
+    }
+
+    // The recorder always starts with a keyframe, but don't rely on it:
+    // decoding from the first record with a blank state is always valid
+    if (mKeyframes.empty() || mKeyframes.front().offset != 0)
+    {
+        mKeyframes.insert(mKeyframes.begin(), Keyframe{ 0, 0 });
+    }
+
+    TraceLog(LOG_INFO, "Replaying %s: %.1f s, %zu keyframes%s%s", path.c_str(), getDurationSeconds(),
+             mKeyframes.size(), indexed ? "" : " (no index, scanned)",
+             mFile.isMapped() ? "" : " (not memory-mapped)");
+    restart();
+    return true;
+}
+
+void InputReplay::scanKeyframes()
+{
+    // Only the tag and varints of each record are touched, and the pages come
+    // straight from the mapping
+    mKeyframes.clear();
+    inputlog::Sample state{};
+    while (true)
+    {
+        const size_t offset = mDecoder.offset();
+        if (!mDecoder.next(state))
+        {
+            break;
+        }
+        if (mDecoder.lastWasKeyframe())
+        {
+            mKeyframes.push_back({ state.ticks, offset });
+        }
+    }
+    mEndTicks = state.ticks;
+}
+
+void InputReplay::setSpeed(double speed)
+{
+    // Time so far counts at the old speed
+    advanceClock();
+    mSpeed = std::clamp(speed, kMinSpeed, kMaxSpeed);
+}
+
+void InputReplay::setLoop(double startSeconds, double endSeconds)
+{
+    mLoopStart = static_cast<uint64_t>(std::max(startSeconds, 0.0) / mTickSeconds);
+    mLoopEnd = static_cast<uint64_t>(std::max(endSeconds, 0.0) / mTickSeconds);
+    if (isLooping() && (mPosition < static_cast<double>(mLoopStart) || mPosition >= static_cast<double>(mLoopEnd)))
+    {
+        seekTicks(mLoopStart);
+    }
+}
+
+void InputReplay::setPaused(bool paused)
+{
+    advanceClock();
+    mPaused = paused;
+}
+
+void InputReplay::seek(double seconds)
+{
+    const double ticks = std::clamp(seconds / mTickSeconds, 0.0, static_cast<double>(mEndTicks));
+    seekTicks(static_cast<uint64_t>(ticks));
+    mLastClock = Clock::now();
+}
+
+void InputReplay::setTime(double seconds)
+{
+    const double ticks = std::max(seconds / mTickSeconds, 0.0);
+    if (ticks < mPosition)
+    {
+        seekTicks(static_cast<uint64_t>(ticks));
+    }
+    else
+    {
+        advanceTo(static_cast<uint64_t>(ticks), true);
+    }
+    mPosition = ticks;
+    mLastClock = Clock::now();
+}
+
+void InputReplay::restart()
+{
+    seekTicks(isLooping() ? mLoopStart : 0);
+    mLastClock = Clock::now();
+    mLastPressed = 0;
+}
+
+void InputReplay::update()
+{
+    mLastPressed = 0;
+    advanceClock();
+}
+
+const char* InputReplay::getName(int gamepad) const
+{
+    return isAvailable(gamepad) ? "PadCast Replay" : "";
+}
+
+PadState InputReplay::sample(int gamepad)
+{
+    // Like a real pad, the late latch sees the recording as of right now
+    advanceClock();
+    if (!isAvailable(gamepad))
+    {
+        PadState state;
+        state.gamepad = gamepad;
+        return state;
+    }
+    return mState.toPad(gamepad);
+}
+
+void InputReplay::advanceClock()
+{
+    const Clock::time_point now = Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - mLastClock).count();
+    mLastClock = now;
+    if (mPaused)
+    {
+        return;
+    }
+
+    mPosition += elapsed / mTickSeconds * mSpeed;
+    if (isLooping() && mPosition >= static_cast<double>(mLoopEnd))
+    {
+        // Land where the wrapped clock would be, keeping the fraction of a tick
+        const double length = static_cast<double>(mLoopEnd - mLoopStart);
+        const double wrapped = static_cast<double>(mLoopStart) + std::fmod(mPosition - static_cast<double>(mLoopStart), length);
+        seekTicks(static_cast<uint64_t>(wrapped));
+        mPosition = wrapped;
+        return;
+    }
+
+    advanceTo(static_cast<uint64_t>(mPosition), true);
+    if (!isLooping() && mPosition > static_cast<double>(mEndTicks))
+    {
+        // Hold the last state; a seek back starts from the end, not from "the future"
+        mPosition = static_cast<double>(mEndTicks);
+    }
+}
+
+void InputReplay::advanceTo(uint64_t ticks, bool countPresses)
+{
+    while (mHavePending && mPending.ticks <= ticks)
+    {
+        const uint32_t pressed = mPending.buttons & ~mState.buttons;
+        if (countPresses && pressed != 0 && mPending.connected)
+        {
+            mLastPressed = std::bit_width(pressed) - 1;
+        }
+        mState = mPending;
+        peek();
+    }
+}
+
+void InputReplay::seekTicks(uint64_t ticks)
+{
+    // Last keyframe at or before ticks; the first entry is always offset 0
+    const auto next = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), ticks,
+                                       [](uint64_t t, const Keyframe& keyframe) { return t < keyframe.ticks; });
+    const size_t offset = next == mKeyframes.begin() ? 0 : static_cast<size_t>(std::prev(next)->offset);
+
+    mState = inputlog::Sample{};
+    mDecoder.seek(offset);
+    peek();
+    advanceTo(ticks, false);
+    mPosition = static_cast<double>(ticks);
+}
+
+void InputReplay::peek()
+{
+    mPending = mState;
+    mHavePending = mDecoder.next(mPending);
+}
@@ -0,0 +1,59 @@
+#include "inputsource.h"
+#include "glfwbridge.h"
+
+bool RaylibInput::isAvailable(int gamepad) const
+{
+    return IsGamepadAvailable(gamepad);
+}
+
+const char* RaylibInput::getName(int gamepad) const
+{
+    return GetGamepadName(gamepad);
+}
+
+int RaylibInput::getButtonPressed() const
+{
+    return GetGamepadButtonPressed();
+}
+
+bool GlfwInput::init()
+{
+    if (!mInitialized)
+    {
+        // Let GLFW pick whichever platform the session has (3.4+; older ignores it)
+        glfwInitHint(PADCAST_GLFW_PLATFORM, PADCAST_GLFW_ANY_PLATFORM);
+        mInitialized = glfwInit() != 0;
+    }
+    return mInitialized;
+}
+
+void GlfwInput::shutdown()
+{
+    if (mInitialized)
+    {
+        glfwTerminate();
+        mInitialized = false;
+    }
+}
+
+void GlfwInput::update()
+{
+    glfwPollEvents();
+}
+
+bool GlfwInput::isAvailable(int gamepad) const
+{
+    return glfwJoystickIsGamepad(gamepad) != 0;
+}
+
+const char* GlfwInput::getName(int gamepad) const
+{
+    return glfwGetGamepadName(gamepad);
+}
+
+PadState GlfwInput::sample(int gamepad)
+{
+    // sampleNow() only falls back to raylib (which has no window here) for
+    // pads without a gamepad mapping, and isAvailable() already excludes those
+    return PadState::sampleNow(gamepad);
+}
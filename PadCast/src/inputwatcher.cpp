@@ -0,0 +1,274 @@
+#include "inputwatcher.h"
+#include "glfwbridge.h"
+#include "trace.h"
+
+#include <chrono>
+#include <iostream>
+
+#ifdef __linux__
+    #include <array>
+    #include <cerrno>
+    #include <cstring>
+    #include <filesystem>
+    #include <string>
+    #include <unordered_map>
+
+    #include <fcntl.h>
+    #include <linux/input.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+void InputWatcher::start(int heartbeatMs)
+{
+    if (mRunning.load())
+    {
+        return;
+    }
+
+    mHeartbeatMs = heartbeatMs;
+    mRunning.store(true);
+#ifdef __linux__
+    mWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#endif
+    mThread = std::thread(&InputWatcher::run, this);
+}
+
+void InputWatcher::stop()
+{
+    if (!mRunning.exchange(false))
+    {
+        return;
+    }
+
+#ifdef __linux__
+    if (mWakeFd >= 0)
+    {
+        uint64_t one = 1;
+        [[maybe_unused]] auto written = write(mWakeFd, &one, sizeof(one));
+    }
+#endif
+    {
+        std::lock_guard lock(mStopMutex);
+    }
+    mStopSignal.notify_all();
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+
+#ifdef __linux__
+    if (mWakeFd >= 0)
+    {
+        close(mWakeFd);
+        mWakeFd = -1;
+    }
+#endif
+    mWatchedDevices.store(0);
+}
+
+#ifdef __linux__
+
+namespace
+{
+    bool testBit(const unsigned long* bits, int bit)
+    {
+        constexpr int bitsPerLong = sizeof(unsigned long) * 8;
+        return (bits[bit / bitsPerLong] >> (bit % bitsPerLong)) & 1UL;
+    }
+
+    // Same idea as GLFW's joystick detection: anything with joystick/gamepad
+    // buttons counts, keyboards and mice don't
+    bool isJoystickDevice(int fd)
+    {
+        constexpr int bitsPerLong = sizeof(unsigned long) * 8;
+        std::array<unsigned long, (KEY_CNT + bitsPerLong - 1) / bitsPerLong> keyBits{};
+        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits.data()) < 0)
+        {
+            return false;
+        }
+        for (int code = BTN_JOYSTICK; code < BTN_DIGI; ++code)
+        {
+            if (testBit(keyBits.data(), code))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void InputWatcher::run()
+{
+    trace::setThreadName("InputWatcher");
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (epollFd < 0)
+    {
+        std::cerr << "InputWatcher: epoll_create1 failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    auto watchFd = [epollFd](int fd) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    };
+
+    watchFd(mWakeFd);
+    if (inotifyFd >= 0)
+    {
+        // udev creates the node first and fixes up permissions after, so ATTRIB matters too
+        inotify_add_watch(inotifyFd, "/dev/input", IN_CREATE | IN_ATTRIB | IN_DELETE);
+        watchFd(inotifyFd);
+    }
+
+    std::unordered_map<int, std::string> devices; // fd -> path
+
+    auto closeDevice = [&](int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        devices.erase(fd);
+    };
+
+    auto scanDevices = [&]() {
+        for (auto it = devices.begin(); it != devices.end();)
+        {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, it->first, nullptr);
+            close(it->first);
+            it = devices.erase(it);
+        }
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator("/dev/input", ec))
+        {
+            const std::string path = entry.path().string();
+            if (entry.path().filename().string().rfind("event", 0) != 0)
+            {
+                continue;
+            }
+            int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd < 0)
+            {
+                continue;
+            }
+            if (!isJoystickDevice(fd))
+            {
+                close(fd);
+                continue;
+            }
+            devices.emplace(fd, path);
+            watchFd(fd);
+        }
+        mWatchedDevices.store(static_cast<int>(devices.size()));
+    };
+
+    scanDevices();
+
+    auto lastPost = std::chrono::steady_clock::now();
+    std::array<epoll_event, 16> events{};
+    std::array<input_event, 64> inputBuffer{};
+
+    while (mRunning.load())
+    {
+        int count = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), mHeartbeatMs);
+        if (count < 0 && errno != EINTR)
+        {
+            std::cerr << "InputWatcher: epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        bool wake = false;
+        for (int i = 0; i < count; ++i)
+        {
+            int fd = events[i].data.fd;
+            if (fd == mWakeFd)
+            {
+                continue; // stop() -- loop condition handles it
+            }
+            if (fd == inotifyFd)
+            {
+                alignas(inotify_event) char buffer[4096];
+                while (read(inotifyFd, buffer, sizeof(buffer)) > 0) {}
+                scanDevices();
+                wake = true;
+                continue;
+            }
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+                closeDevice(fd);
+                mWatchedDevices.store(static_cast<int>(devices.size()));
+                wake = true;
+                continue;
+            }
+
+            // Drain the queue (level-triggered epoll would spin otherwise) and only
+            // count real button/axis changes, not sync or misc reports
+            ssize_t bytes;
+            while ((bytes = read(fd, inputBuffer.data(), sizeof(inputBuffer))) > 0)
+            {
+                size_t n = static_cast<size_t>(bytes) / sizeof(input_event);
+                for (size_t e = 0; e < n; ++e)
+                {
+                    if (inputBuffer[e].type == EV_KEY || inputBuffer[e].type == EV_ABS)
+                    {
+                        wake = true;
+                    }
+                }
+            }
+            if (bytes < 0 && errno == ENODEV)
+            {
+                closeDevice(fd);
+                mWatchedDevices.store(static_cast<int>(devices.size()));
+                wake = true;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!wake && now - lastPost >= std::chrono::milliseconds(mHeartbeatMs))
+        {
+            wake = true; // heartbeat
+        }
+
+        if (wake && !mPaused.load(std::memory_order_relaxed))
+        {
+            glfwPostEmptyEvent();
+            lastPost = now;
+        }
+    }
+
+    for (const auto& [fd, path] : devices)
+    {
+        close(fd);
+    }
+    if (inotifyFd >= 0)
+    {
+        close(inotifyFd);
+    }
+    close(epollFd);
+}
+
+#else
+
+void InputWatcher::run()
+{
+    trace::setThreadName("InputWatcher");
+    // No device access here, so heartbeat only
+    std::unique_lock lock(mStopMutex);
+    while (mRunning.load())
+    {
+        mStopSignal.wait_for(lock, std::chrono::milliseconds(mHeartbeatMs));
+        if (mRunning.load() && !mPaused.load(std::memory_order_relaxed))
+        {
+            glfwPostEmptyEvent();
+        }
+    }
+}
+
+#endif
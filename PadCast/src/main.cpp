@@ -8,48 +8,295 @@
 #include "PadCast.h"
 #include "config.h"
 #include "menus.h"
+#include "inputwatcher.h"
+#include "framepacer.h"
+#include "padstate.h"
+#include "startupreport.h"
+#include "taskqueue.h"
+#include "perfhud.h"
+#include "trace.h"
+#include "cmdline.h"
+#include "inputsource.h"
+#include "virtualgamepad.h"
+#include "inputrecorder.h"
+#include "inputreplay.h"
+#include "offlinerender.h"
+#include "videooutput.h"
+#include "padshm.h"
+#include "paddaemon.h"
+#include "padrelay.h"
+#include "padtui.h"
+#include "evdevinput.h"
 
 #ifdef _WIN32
     #undef NOGDI
     #undef NOUSER
 #endif
 
+#include <rlgl.h>
+
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <string>
 
-int main()
+namespace
 {
+	// Shows a replay at the given gamepad index and applies the --replay-* options
+	void startReplay(InputReplay& replay, const CommandLine& options, int gamepadIndex)
+	{
+		replay.setIndex(gamepadIndex);
+		replay.setSpeed(options.replaySpeed);
+		replay.setLoop(options.replayLoopStart, options.replayLoopEnd);
+		replay.restart();
+		if (options.replayStart > 0.0)
+		{
+			replay.seek(options.replayStart);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const CommandLine options{ CommandLine::parse(argc, argv) };
+	if (!options.valid || options.showHelp)
+	{
+		CommandLine::printUsage(argv[0]);
+		return options.valid ? 0 : 2;
+	}
+	// stdout carries the video stream; keep it clean
+	if (options.videoOutPath == "-" && options.videoFormat != CommandLine::VideoFormat::Shm)
+	{
+		VideoOutput::moveLogsToStderr();
+	}
+
+	if (options.profileStartup && options.cacheState == CommandLine::CacheState::Cold)
+	{
+		for (const std::string& path : { PathManager::getResourcePath(""), PathManager::getConfigFilePath() })
+		{
+			if (!StartupReport::evictFromFileCache(path))
+			{
+				std::cerr << "Couldn't drop " << path << " from the file cache, "
+						  << "so the cold profile may be partly warm" << std::endl;
+			}
+		}
+	}
+
+	// Gamepads come from hardware unless a script or recording was given
+	RaylibInput raylibInput;
+	VirtualGamepad virtualPad;
+	InputReplay replay;
+	InputSource* input{ &raylibInput };
+	padrelay::Receiver relayInput;
+	const int inputOptions{ static_cast<int>(!options.virtualPadScript.empty())
+		+ static_cast<int>(!options.replayPath.empty()) + static_cast<int>(!options.relayListen.empty()) };
+	if (inputOptions > 1)
+	{
+		std::cerr << "Only one of --virtual-pad, --replay and --relay-listen can be used" << std::endl;
+		return 2;
+	}
+	if (!options.virtualPadScript.empty())
+	{
+		std::string error;
+		if (!virtualPad.loadScript(options.virtualPadScript, error))
+		{
+			std::cerr << "Virtual gamepad script " << options.virtualPadScript << ": " << error << std::endl;
+			return 2;
+		}
+		input = &virtualPad;
+	}
+	if (!options.replayPath.empty())
+	{
+		std::string error;
+		if (!replay.open(options.replayPath, error))
+		{
+			std::cerr << "Replay " << options.replayPath << ": " << error << std::endl;
+			return 2;
+		}
+		input = &replay;
+	}
+	if (!options.relayListen.empty())
+	{
+		std::string error;
+		if (!relayInput.open(options.relayListen, error))
+		{
+			std::cerr << "Relay: " << error << std::endl;
+			return 2;
+		}
+		input = &relayInput;
+	}
+
+	// Offline render: no window loop at all
+	if (!options.renderPath.empty())
+	{
+		if (options.replayPath.empty())
+		{
+			std::cerr << "--render needs a recording to render (--replay <file>)" << std::endl;
+			return 2;
+		}
+		const bool looped{ options.replayLoopEnd > options.replayLoopStart };
+		OfflineRenderer::Settings settings;
+		settings.outPath = options.renderPath;
+		settings.fps = options.renderFps;
+		settings.width = options.renderWidth;
+		settings.height = options.renderHeight;
+		settings.threads = options.renderThreads;
+		settings.startSeconds = looped ? options.replayLoopStart : options.replayStart;
+		settings.endSeconds = looped ? options.replayLoopEnd : 0.0;
+		return OfflineRenderer{ settings }.run(replay);
+	}
+
 	//$ ----- Setup ----- //
+	// With --profile-startup, trace from the very start so config loading is covered
+	trace::setThreadName("Main");
+	trace::setEnabled(options.profileStartup);
+	StartupReport startup;
 	Config mainConfig{};
+	trace::setEnabled(options.profileStartup || mainConfig.getTrace() == 1);
+
+	// Daemon and terminal view: same input pipeline, no window
+	if (options.daemon && options.tui)
+	{
+		std::cerr << "Only one of --daemon and --tui can be used" << std::endl;
+		return 2;
+	}
+	if (options.tui && !options.relaySend.empty())
+	{
+		std::cerr << "--relay-send can't be used with --tui (use --daemon)" << std::endl;
+		return 2;
+	}
+	if ((options.daemon || options.tui)
+		&& (!options.recordPath.empty() || !options.sharePadName.empty() || !options.videoOutPath.empty()))
+	{
+		std::cerr << "--record, --share-pad and --video-out need the window, not --daemon or --tui" << std::endl;
+		return 2;
+	}
+	if (options.daemon || options.tui)
+	{
+		// Real pads through GLFW, or straight from evdev when there's no desktop session
+		GlfwInput glfwInput;
+		EvdevInput evdevInput;
+		InputSource* daemonInput{ input };
+		std::string inputLabel{ "GLFW" };
+		if (input == &raylibInput)
+		{
+			if (glfwInput.init())
+			{
+				daemonInput = &glfwInput;
+			}
+			else if (evdevInput.open())
+			{
+				std::cerr << "GLFW failed to initialize (no desktop session?), reading /dev/input directly" << std::endl;
+				daemonInput = &evdevInput;
+				inputLabel = "evdev (/dev/input)";
+			}
+			else
+			{
+				std::cerr << "Can't read gamepads: GLFW failed to initialize and /dev/input isn't readable" << std::endl;
+				return 1;
+			}
+		}
+		else if (input == &virtualPad)
+		{
+			inputLabel = "virtual pad " + options.virtualPadScript;
+		}
+		else if (input == &replay)
+		{
+			inputLabel = "replay " + options.replayPath;
+		}
+		else
+		{
+			inputLabel = "relay " + options.relayListen;
+		}
+		if (input == &replay)
+		{
+			startReplay(replay, options, mainConfig.getGPIndex());
+		}
+		virtualPad.restart();
+		relayInput.setIndex(mainConfig.getGPIndex());
+		if (options.tui)
+		{
+			return PadTui{}.run(mainConfig, *daemonInput, inputLabel);
+		}
+		PadDaemon::Settings settings;
+		settings.bindAddress = options.daemonBind;
+		settings.port = options.daemonPort;
+		settings.relayTarget = options.relaySend;
+		return PadDaemon{ settings }.run(mainConfig, *daemonInput);
+	}
 
 	// Window setup
 	SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+	const uint64_t windowStart = trace::now();
 	raylib::Window window {
 		mainConfig.getInitWinWidth(),
 		mainConfig.getInitWinHeight(),
 		"PadCast"
 	};
-    raylib::Image icon(PathManager::getResourcePath("padcast.png"));
-    window.SetIcon(icon);
+    trace::record("InitWindow", windowStart);
+    startup.mark(StartupReport::Phase::Window);
+    const uint64_t assetLoadStart = trace::now();
+    {
+        PADCAST_TRACE_SCOPE("Icon load");
+        raylib::Image icon(PathManager::getResourcePath("padcast.png"));
+        window.SetIcon(icon);
+    }
 
+    // raylib's own limiter stays off (target 0); FramePacer does the waiting
+    FramePacer framePacer;
+    framePacer.setLatchMargin(std::chrono::milliseconds(mainConfig.getLatchMarginMs()));
+    framePacer.setRefreshRate(GetMonitorRefreshRate(GetCurrentMonitor()));
+    framePacer.setTargetFPS(mainConfig.getFPS());
+    // A video stream needs a frame every period, so no VRR skipping with --video-out
+    framePacer.setVRR(mainConfig.getVRRMode() == 1 && options.videoOutPath.empty());
     if (mainConfig.getVSYNC())
     {
         SetWindowState(FLAG_VSYNC_HINT);
-        int currentMonitor = GetCurrentMonitor();
-        int refreshRate = GetMonitorRefreshRate(currentMonitor);
-        window.SetTargetFPS(refreshRate);
+        framePacer.setVSync(true);
     }
     else
     {
         ClearWindowState(FLAG_VSYNC_HINT);
-        window.SetTargetFPS(mainConfig.getFPS());
     }
 
 	PadCast padcast{ mainConfig };
+
+	// Raw video out: the overlay alone (no menu or HUD) at its own size
+	VideoOutput videoOut;
+	const int videoWidth{ options.videoWidth > 0 ? options.videoWidth : mainConfig.getImgCanvasWidth() };
+	const int videoHeight{ options.videoHeight > 0 ? options.videoHeight : mainConfig.getImgCanvasHeight() };
+	const ScalingInfo videoScaling{ videoWidth, videoHeight,
+		mainConfig.getImgCanvasWidth(), mainConfig.getImgCanvasHeight() };
+	if (!options.videoOutPath.empty())
+	{
+		const int pacedFps = framePacer.getPacedFPS();
+		const int refreshRate = framePacer.getRefreshRate();
+		const double videoFps = pacedFps > 0 ? pacedFps : (refreshRate > 0 ? refreshRate : 60);
+		VideoOutput::Format format{ VideoOutput::Format::Y4m };
+		std::string videoPath{ options.videoOutPath };
+		if (options.videoFormat == CommandLine::VideoFormat::Rgba)
+		{
+			format = VideoOutput::Format::Rgba;
+		}
+		else if (options.videoFormat == CommandLine::VideoFormat::Shm)
+		{
+			format = VideoOutput::Format::Shm;
+			if (videoPath == "-")
+			{
+				videoPath = shmframes::kDefaultName;
+			}
+		}
+		if (!videoOut.open(videoPath, format, videoWidth, videoHeight, videoFps))
+		{
+			return 2;
+		}
+	}
+	const uint64_t menuStart = trace::now();
 	MenuContext menu;
+	trace::record("MenuContext", menuStart);
+	startup.mark(StartupReport::Phase::Resources);
+	trace::record("Load assets", assetLoadStart);
 
-	// short pause to allow for controller detection
-	std::this_thread::sleep_for(std::chrono::milliseconds(500));
 	if (mainConfig.getDebugMode())
 	{
 		SetTraceLogLevel(LOG_ALL);
@@ -65,17 +312,183 @@ int main()
 	const int canvasWidth{ mainConfig.getImgCanvasWidth() };
 	const int canvasHeight{ mainConfig.getImgCanvasHeight() };
 	// Gamepad connection
-	static int gamepadCheckCounter = 0;
+	constexpr double gamepadCheckInterval{ 0.25 }; // seconds (15 frames at 60 FPS)
+	double lastGamepadCheck{ 0.0 };
     static int gamepadIndex{ mainConfig.getGPIndex() };
 	bool gamepadConnected{ false };
+	// The pad may be enumerated a few frames after the window opens; until it shows
+	// up (or this long passes) check every frame and hold off on "No Gamepad"
+	constexpr double gamepadDiscoveryTime{ 2.0 }; // seconds
+	bool discoveringGamepad{ true };
+	// Idle mode
+	// Nothing outside the process wakes the loop for a scripted pad, and a video
+	// stream needs every frame
+	const bool idleMode{ mainConfig.getIdleMode() == 1 && input->supportsIdle() && !videoOut.isOpen() };
+	bool eventWaiting{ false };
+	// Display -- the window can be dragged onto a monitor with another refresh rate
+	constexpr double displayCheckInterval{ 0.5 };
+	double lastDisplayCheck{ 0.0 };
+	int currentMonitor{ GetCurrentMonitor() };
+	// VRR mode -- only present when what's on screen would change
+	const bool vrrMode{ mainConfig.getVRRMode() == 1 && !videoOut.isOpen() };
+	constexpr double vrrMaxInterval{ 1.0 }; // seconds, keeps capture tools fed
+	uint32_t lastDrawnButtons{ 0 };
+	bool lastDrawnConnected{ false };
+	double lastPresentTime{ 0.0 };
+	bool forceRedraw{ true };
 	// ----- ***** ----- //
 
+	// F3 toggles it
+	PerfHUD perfHud;
+
+	// Reloads and saves triggered from the menu run here, a couple of ms per frame
+	TaskQueue deferredTasks;
+	constexpr auto deferredWorkBudget{ std::chrono::milliseconds(2) };
+
+	// Archive of every input this session, written from a background thread
+	InputRecorder inputRecorder;
+	{
+		std::string recordPath{ options.recordPath };
+		// A replay is a recording already; only --record captures it again
+		if (recordPath.empty() && mainConfig.getRecordInput() == 1 && options.replayPath.empty())
+		{
+			recordPath = (std::filesystem::path(mainConfig.getConfigFilePath()).parent_path()
+						  / "recordings" / InputRecorder::sessionFileName()).string();
+		}
+		if (!recordPath.empty())
+		{
+			std::error_code ec;
+			const auto recordDir = std::filesystem::path(recordPath).parent_path();
+			if (!recordDir.empty())
+			{
+				std::filesystem::create_directories(recordDir, ec);
+			}
+			inputRecorder.start(recordPath);
+		}
+	}
+
+	// Live pad state for other local overlays, so they don't each poll the device
+	padshm::Writer sharedPad;
+	if (!options.sharePadName.empty())
+	{
+		const std::string name{ options.sharePadName == "-" ? padshm::kDefaultName : options.sharePadName };
+		std::string error;
+		if (sharedPad.create(name, error))
+		{
+			TraceLog(LOG_INFO, "Sharing pad state as shared memory \"%s\"", name.c_str());
+		}
+		else
+		{
+			TraceLog(LOG_WARNING, "Can't share pad state as \"%s\": %s", name.c_str(), error.c_str());
+		}
+	}
+
+	// The pad for a PadCast on the streaming PC (--relay-send)
+	padrelay::Sender relaySender;
+	if (!options.relaySend.empty())
+	{
+		std::string error;
+		if (relaySender.open(options.relaySend, error))
+		{
+			TraceLog(LOG_INFO, "Relaying the pad to %s over UDP", options.relaySend.c_str());
+		}
+		else
+		{
+			TraceLog(LOG_WARNING, "Can't relay the pad: %s", error.c_str());
+		}
+	}
+
+	// Lets the loop block in event waiting between inputs instead of spinning
+	InputWatcher inputWatcher;
+	if (idleMode)
+	{
+		inputWatcher.start(mainConfig.getIdleHeartbeatMs());
+	}
+
 	ScalingInfo scaling{ window.GetWidth(), window.GetHeight(), canvasWidth, canvasHeight };
-	MenuContext::MenuParams menuParams{ menu, window, mainConfig, padcast, scaling, gamepadIndex};
+	MenuContext::MenuParams menuParams{ menu, window, mainConfig, padcast, scaling, gamepadIndex,
+		framePacer, deferredTasks, *input };
+
+	// Start the script's clock with the first frame rather than at process start
+	virtualPad.restart();
+	// A relayed pad shows up at the configured gamepad index
+	relayInput.setIndex(gamepadIndex);
+	// Same for a replay, which shows up at the configured gamepad index
+	bool replayFinishedLogged{ false };
+	if (input == &replay)
+	{
+		startReplay(replay, options, gamepadIndex);
+	}
 
 	//$ ----- Main Loop ----- //
     while (!window.ShouldClose())
     {
+        PADCAST_TRACE_SCOPE("Frame");
+
+        // F4 writes what the trace rings hold (last few seconds) next to config.ini
+        if (IsKeyPressed(KEY_F4) && trace::isEnabled())
+        {
+            const std::string tracePath = (std::filesystem::path(mainConfig.getConfigFilePath()).parent_path()
+                                           / ("padcast-trace-" + std::to_string(static_cast<long long>(GetTime() * 1000.0))
+                                              + ".json")).string();
+            if (trace::dump(tracePath))
+            {
+                TraceLog(LOG_INFO, "Trace written to %s", tracePath.c_str());
+            }
+            else
+            {
+                TraceLog(LOG_WARNING, "Couldn't write trace to %s", tracePath.c_str());
+            }
+        }
+
+        if (IsKeyPressed(KEY_F3))
+        {
+            perfHud.toggle();
+            forceRedraw = true;
+        }
+        perfHud.beginFrame();
+        perfHud.enter(PerfHUD::Phase::Input);
+        input->update();
+
+        // Replay transport: arrows seek, [ ] change speed, P pauses, Home restarts
+        if (input == &replay && menu.active == Menu::None)
+        {
+            constexpr double seekStep{ 5.0 }; // seconds
+            if (IsKeyPressed(KEY_LEFT))
+            {
+                replay.seek(replay.getPositionSeconds() - seekStep);
+            }
+            if (IsKeyPressed(KEY_RIGHT))
+            {
+                replay.seek(replay.getPositionSeconds() + seekStep);
+            }
+            if (IsKeyPressed(KEY_LEFT_BRACKET))
+            {
+                replay.setSpeed(replay.getSpeed() / 2.0);
+            }
+            if (IsKeyPressed(KEY_RIGHT_BRACKET))
+            {
+                replay.setSpeed(replay.getSpeed() * 2.0);
+            }
+            if (IsKeyPressed(KEY_P))
+            {
+                replay.setPaused(!replay.isPaused());
+            }
+            if (IsKeyPressed(KEY_HOME))
+            {
+                replay.restart();
+                replayFinishedLogged = false;
+            }
+            if (replay.isFinished() != replayFinishedLogged)
+            {
+                replayFinishedLogged = replay.isFinished();
+                if (replayFinishedLogged)
+                {
+                    TraceLog(LOG_INFO, "Replay finished at %.1f s", replay.getPositionSeconds());
+                }
+            }
+        }
+
         int currentWidth = window.GetWidth();
         int currentHeight = window.GetHeight();
 
@@ -86,9 +499,77 @@ int main()
             lastWinWidth = currentWidth;
             lastWinHeight = currentHeight;
             winDimensionsChanged = true;
+            padcast.invalidateTextCache();
+            menu.invalidateLayout();
+            forceRedraw = true;
+        }
+
+        deferredTasks.run(deferredWorkBudget);
+
+        // Check gamepad connection -- time based so it keeps the same pace when
+        // idle mode only wakes the loop a few times a second
+        if (discoveringGamepad || GetTime() - lastGamepadCheck >= gamepadCheckInterval)
+        {
+            lastGamepadCheck = GetTime();
+            gamepadConnected = padcast.updateGamepadConnection(
+                                       input->isAvailable(gamepadIndex)
+                               );
+            if (gamepadConnected)
+            {
+                startup.mark(StartupReport::Phase::GamepadReady);
+            }
+            if (discoveringGamepad && (gamepadConnected || GetTime() >= gamepadDiscoveryTime))
+            {
+                discoveringGamepad = false;
+                forceRedraw = true;
+            }
+        }
+
+        // Follow monitor and refresh rate changes so VSync latching and the VRR
+        // cap stay matched to the panel the window is actually on
+        if (GetTime() - lastDisplayCheck >= displayCheckInterval)
+        {
+            lastDisplayCheck = GetTime();
+            const int monitor = GetCurrentMonitor();
+            const int refreshRate = GetMonitorRefreshRate(monitor);
+            if (monitor != currentMonitor || refreshRate != framePacer.getRefreshRate())
+            {
+                TraceLog(LOG_INFO, "Display changed: monitor %d at %d Hz", monitor, refreshRate);
+                currentMonitor = monitor;
+                framePacer.setRefreshRate(refreshRate);
+                forceRedraw = true;
+            }
+        }
+
+        // VRR mode: if nothing visible changed there's nothing to present; poll
+        // and check again. The panel just holds the last frame.
+        if (vrrMode && !forceRedraw && menu.active == Menu::None)
+        {
+            const PadState pad = gamepadConnected ? input->sample(gamepadIndex) : PadState{};
+            inputRecorder.record(pad, gamepadConnected);
+            sharedPad.publish(gamepadConnected, gamepadIndex, padcast.getLogicalButtons(pad), pad.buttons,
+                              pad.axes, gamepadConnected ? input->getName(gamepadIndex) : nullptr);
+            relaySender.publish(gamepadConnected, pad, gamepadConnected ? input->getName(gamepadIndex) : nullptr);
+            const uint32_t buttons = pad.buttons;
+            if (buttons == lastDrawnButtons
+                && gamepadConnected == lastDrawnConnected
+                && !IsMenuTogglePressed()
+                && !perfHud.isVisible()
+                && GetTime() - lastPresentTime < vrrMaxInterval)
+            {
+                perfHud.countSkippedPresent();
+                // Event waiting blocks in PollInputEvents(); otherwise check once a refresh
+                if (!eventWaiting)
+                {
+                    framePacer.waitForNextCheck();
+                }
+                PollInputEvents();
+                continue;
+            }
         }
 
         window.BeginDrawing();
+        perfHud.beginGpu();
         window.ClearBackground(padcast.getBGColor());
 
         // Update scaling each frame
@@ -99,44 +580,166 @@ int main()
         HandleMenuInput(menuParams);
 
         // Draw base controller
-        padcast.getTextures().unpressed.Draw(
-            raylib::Vector2{ scaling.offsetX, scaling.offsetY },
-            0.0f,
-            scaling.scale,
-            raylib::WHITE
-        );
-
-        // Check gamepad connection
-        if (++gamepadCheckCounter >= 15)
+        perfHud.enter(PerfHUD::Phase::Overlay);
         {
-            gamepadCheckCounter = 0;
-            gamepadConnected = padcast.updateGamepadConnection(
-                                       raylib::Gamepad::IsAvailable(gamepadIndex)
-                               );
+            PADCAST_TRACE_SCOPE("Base draw");
+            padcast.getTextures().unpressed.Draw(
+                raylib::Vector2{ scaling.offsetX, scaling.offsetY },
+                0.0f,
+                scaling.scale,
+                raylib::WHITE
+            );
         }
 
+        // Late latch: everything above doesn't depend on the pad, so submit it,
+        // wait until LATCH_MARGIN_MS before the present, and only then read the
+        // pad and draw what depends on it. The GPU timer pauses over the wait so
+        // it isn't counted as GPU time.
+        rlDrawRenderBatchActive();
+        perfHud.endGpu();
+        perfHud.enter(PerfHUD::Phase::Wait);
+        framePacer.waitForLatch();
+        perfHud.enter(PerfHUD::Phase::Overlay);
+        perfHud.beginGpu();
+
         // Display gamepad stuff
+        PadState drawnPad{};
+        bool padDrawn{ false };
         if (gamepadConnected && (menu.active != Menu::RemapButtons))
         {
-            raylib::Gamepad gamepad(gamepadIndex);
-            padcast.drawGamepadButtons(gamepad, scaling);
+            const PadState pad = input->sample(gamepadIndex);
+            inputRecorder.record(pad, true);
+            sharedPad.publish(true, gamepadIndex, padcast.getLogicalButtons(pad), pad.buttons, pad.axes,
+                              input->getName(gamepadIndex));
+            relaySender.publish(true, pad, input->getName(gamepadIndex));
+            padcast.drawGamepadButtons(pad, scaling);
+            lastDrawnButtons = pad.buttons;
+            drawnPad = pad;
+            padDrawn = true;
         }
         else
         {
-            padcast.drawNoGamepadMessage(scaling);
+            if (!gamepadConnected)
+            {
+                inputRecorder.record(PadState{}, false);
+                sharedPad.publish(false, -1, 0, 0, {}, nullptr);
+                relaySender.publish(false, PadState{}, nullptr);
+            }
+            lastDrawnButtons = 0;
+            if (!discoveringGamepad)
+            {
+                padcast.drawNoGamepadMessage(scaling);
+            }
+        }
+
+        // Same overlay into the video stream, with the pad state the window got
+        if (videoOut.isOpen())
+        {
+            videoOut.beginFrame();
+            ClearBackground(padcast.getBGColor());
+            padcast.getTextures().unpressed.Draw(
+                raylib::Vector2{ videoScaling.offsetX, videoScaling.offsetY },
+                0.0f,
+                videoScaling.scale,
+                raylib::WHITE
+            );
+            if (padDrawn)
+            {
+                padcast.drawGamepadButtons(drawnPad, videoScaling);
+            }
+            videoOut.endFrame();
         }
 
         // Add remap screen handling here to avoid lambda insanity
+        perfHud.enter(PerfHUD::Phase::Menu);
         if (menu.active == Menu::RemapButtons)
         {
             RemapButtonScreens(menuParams);
         }
         else if (menu.active != Menu::None)
         {
-            DrawMenu(menu, scaling, mainConfig, 50, 50);
+            DrawMenu(menu, scaling, mainConfig, padcast.getTextCache());
+        }
+
+        perfHud.draw(padcast.getTextCache(), framePacer,
+                     padcast.getTextureMemory() + menu.getTextureMemory(), currentWidth);
+
+        // Idle mode: block in EndDrawing() until the watcher sees gamepad activity,
+        // a window event arrives, or the heartbeat fires. If the watcher can't see
+        // the gamepad's device we only idle while it's disconnected or minimized.
+        if (idleMode)
+        {
+            const bool minimized = IsWindowMinimized();
+            inputWatcher.setPaused(minimized);
+            const bool canIdle = (minimized || !gamepadConnected || inputWatcher.isWatchingDevices())
+                                 && deferredTasks.empty();
+            if (canIdle != eventWaiting)
+            {
+                if (canIdle)
+                {
+                    EnableEventWaiting();
+                }
+                else
+                {
+                    DisableEventWaiting();
+                }
+                eventWaiting = canIdle;
+            }
+        }
+
+        // Submit the frame's batch before waiting so the GPU works while we sleep,
+        // then present on the deadline
+        rlDrawRenderBatchActive();
+        perfHud.endGpu();
+        perfHud.enter(PerfHUD::Phase::Wait);
+        framePacer.waitForNextFrame();
+        perfHud.enter(PerfHUD::Phase::Present);
+        {
+            PADCAST_TRACE_SCOPE("EndDrawing");
+            window.EndDrawing();
+        }
+        perfHud.endFrame();
+        framePacer.markPresented();
+        startup.mark(StartupReport::Phase::FirstFrame);
+        if (options.profileStartup)
+        {
+            startup.printProfile(options.cacheState == CommandLine::CacheState::Cold ? "cold" : "warm");
+            break;
+        }
+        if (!discoveringGamepad)
+        {
+            startup.log();
+        }
+        lastPresentTime = GetTime();
+        lastDrawnConnected = gamepadConnected;
+        forceRedraw = false;
+        if (eventWaiting)
+        {
+            framePacer.resync();
         }
+    }
+
+    inputWatcher.stop();
+    inputRecorder.stop();
+    deferredTasks.drain();
+
+    if (input == &relayInput)
+    {
+        const padrelay::ReceiverStats& relayStats = relayInput.getStats();
+        TraceLog(LOG_INFO, "Relay: %llu packets, %llu states, %llu recovered from redundancy, %llu lost",
+                 static_cast<unsigned long long>(relayStats.packets),
+                 static_cast<unsigned long long>(relayStats.states),
+                 static_cast<unsigned long long>(relayStats.recovered),
+                 static_cast<unsigned long long>(relayStats.lost));
+    }
 
-        window.EndDrawing();
+    if (mainConfig.getDebugMode())
+    {
+        const FramePacer::Stats& stats = framePacer.getStats();
+        TraceLog(LOG_INFO, "Frame pacing: %llu frames, %llu missed deadlines, worst %.2f ms late",
+                 static_cast<unsigned long long>(stats.frames),
+                 static_cast<unsigned long long>(stats.missedDeadlines),
+                 stats.worstLatenessMs);
     }
 
     // If window dimensions changed from last open, update initial dimensions
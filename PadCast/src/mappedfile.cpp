@@ -0,0 +1,106 @@
+// Kept free of raylib headers so windows.h can be included here
+#include "mappedfile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view != nullptr)
+                {
+                    mFileHandle = file;
+                    mMappingHandle = mapping;
+                    mData = static_cast<const uint8_t*>(view);
+                    mSize = static_cast<size_t>(size.QuadPart);
+                    mMapped = true;
+                    return true;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#elif defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        struct stat info{};
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED)
+            {
+                // The log is read front to back, with the occasional seek
+                madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                ::close(fd);
+                mData = static_cast<const uint8_t*>(view);
+                mSize = static_cast<size_t>(info.st_size);
+                mMapped = true;
+                return true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // Not mappable (or an empty file): read it in
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        return false;
+    }
+    mFallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (mFallback.empty())
+    {
+        return false;
+    }
+    mData = mFallback.data();
+    mSize = mFallback.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mMapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(static_cast<HANDLE>(mMappingHandle));
+        CloseHandle(static_cast<HANDLE>(mFileHandle));
+        mFileHandle = nullptr;
+        mMappingHandle = nullptr;
+#elif defined(__unix__) || defined(__APPLE__)
+        munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+    }
+    mFallback.clear();
+    mFallback.shrink_to_fit();
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+}
@@ -1,432 +1,491 @@
 #include "menus.h"
 #include "debounce.h"
+#include "trace.h"
 
-#include <string>
+#include <rlgl.h>
 
-MenuItem createMenuItem(const std::string& label, std::function<void()> action)
-{
-	return { label, action };
-}
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <string_view>
 
-MenuItem createBackMenuItem(MenuContext::MenuParams& params)
-{
-	return createMenuItem("Back", [&params]() {
-		params.menu.active = Menu::Main;
-		SetupMainMenu(params);
-		});
-}
+//$ ----- Menu actions ----- //
+// Each action takes the item's arg so one function can back a whole row of
+// similar items (FPS presets, palette colors, etc.)
 
-MenuItem createCloseMenuItem(MenuContext& menu)
+namespace
 {
-	return createMenuItem("Close", [&menu]() {
-		menu.active = Menu::None;
-		});
-}
+	struct Resolution
+	{
+		int width;
+		int height;
+	};
+
+	constexpr std::array<Resolution, 4> kResolutions{ {
+		{ 1280, 720 },
+		{ 960, 540 },
+		{ 640, 360 },
+		{ 480, 270 }
+	} };
+
+	void OpenMenuAction(MenuParams& params, int target)
+	{
+		OpenMenu(params, static_cast<Menu>(target));
+	}
 
-MenuItem createSpacer()
-{
-	return createMenuItem(" ", []() {});	// lol C++
-}
+	void CloseMenuAction(MenuParams& params, int)
+	{
+		params.menu.active = Menu::None;
+	}
 
-void SetupMainMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Video",
-		[&params]() { 
-			params.menu.active = Menu::Video; 
-			SetupVideoMenu(params); 
-		}
-		});
-	params.menu.items.push_back({
-		"Visuals",
-		[&params]() { 
-			params.menu.active = Menu::Visuals; 
-			SetupVisualsMenu(params); 
+	// The values are copied in this frame; the disk write runs on a worker
+	// thread and the task only checks on it
+	DeferredTask SaveConfigTask(Config& config)
+	{
+		std::future<bool> written{ std::async(std::launch::async, [&config, ini = config.snapshot()]() mutable {
+			return config.writeSnapshot(ini);
+		}) };
+		while (written.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			co_await TaskQueue::slice();
 		}
-		});
-	params.menu.items.push_back({
-		"Controller",
-		[&params]() { 
-			params.menu.active = Menu::Controller; 
-			SetupControllerMenu(params); 
+		if (!written.get())
+		{
+			TraceLog(LOG_WARNING, "Couldn't save %s", config.getConfigFilePath().c_str());
 		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back({
-		"Reload Config File",
-		[&params]() {
-			params.config.reloadConfig();
+	}
+
+	void refreshVideoLabels(MenuParams& params);
+	void refreshFPSLabels(MenuParams& params);
+
+	// What depends on each config.ini section, redone once it's live
+	void applyReloadedSection(MenuParams& params, std::string_view section)
+	{
+		if (section == "Window")
+		{
 			params.padcast.invalidateBGCache();
+		}
+		else if (section == "Image")
+		{
 			params.padcast.invalidateTintCache();
 		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
+		else if (section == "Font")
+		{
+			params.padcast.invalidateTextCache();
+			params.menu.invalidateLayout();
+		}
+		else if (section == "ButtonMap")
+		{
+			params.padcast.loadButtonsFromConfig();
+		}
+	}
 
-	params.menu.selectedIndex = 0;
-}
+	// Reload Config File, spread over frames: each co_await ends a slice, and
+	// the queue runs about 2 ms of slices per frame. Also reloads the overlay
+	// images, so edited custom images show up without a restart.
+	DeferredTask ReloadConfigTask(MenuParams& params)
+	{
+		// Disk read into a staging copy; nothing live changes until a section is applied
+		Config::Staged staged;
+		if (!params.config.readStaged(staged))
+		{
+			TraceLog(LOG_WARNING, "Reload: couldn't read %s", params.config.getConfigFilePath().c_str());
+			co_return;
+		}
+		co_await TaskQueue::slice();
 
-void SetupVideoMenu(MenuContext::MenuParams& params)
-{
-	std::string current_vsync = (std::to_string(params.config.getValue("Window", "USE_VSYNC")) == "1") ? "On" : "Off";
-	std::string vsync_string = "Toggle VSync \n(Currently: " + current_vsync + ")";
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Resolution",
-		[&params]() { 
-			params.menu.active = Menu::Resolution; 
-			SetupResolutionMenu(params); 
+		for (size_t section = 0; section < Config::kSections.size(); ++section)
+		{
+			params.config.validateStaged(staged, section);
+			co_await TaskQueue::slice();
+		}
+		for (size_t section = 0; section < Config::kSections.size(); ++section)
+		{
+			params.config.applySection(staged, section);
+			applyReloadedSection(params, Config::kSections[section]);
+			co_await TaskQueue::slice();
 		}
-		});
-	params.menu.items.push_back({
-		"Target FPS",
-		[&params]() { 
-			params.menu.active = Menu::FPS; 
-			SetupFPSMenu(params); 
+		if (staged.needsSave)
+		{
+			params.tasks.post(SaveConfigTask(params.config));
 		}
-		});
-	params.menu.items.push_back({
-		vsync_string,
-		[&params]() { 
-			bool vsync = params.config.getVSYNC();
-			if (vsync)
+
+		// PNG decodes run on a worker thread; only the upload and swap of
+		// each texture takes a slice here
+		for (size_t i = 0; i < GamepadTextures::kCount; ++i)
+		{
+			const std::string path{ PathManager::getResourcePath(GamepadTextures::kFiles[i]) };
+			std::future<Image> decoded{ std::async(std::launch::async, [path] { return LoadImage(path.c_str()); }) };
+			while (decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
 			{
-				ClearWindowState(FLAG_VSYNC_HINT);
-				params.window.SetTargetFPS(params.config.getValue("Window", "TARGET_FPS"));
-				params.config.updateUseVSYNC(0);
-				SetupVideoMenu(params);
+				co_await TaskQueue::slice();
 			}
-			else
+			const Image image{ decoded.get() };
+			if (!IsImageValid(image) || !params.padcast.replaceTexture(i, image))
 			{
-				int currentMonitor = GetCurrentMonitor();
-				int refreshRate = GetMonitorRefreshRate(currentMonitor);
-				SetWindowState(FLAG_VSYNC_HINT);  
-				params.window.SetTargetFPS(refreshRate);
-				params.config.updateUseVSYNC(1);
-				SetupVideoMenu(params);
+				TraceLog(LOG_WARNING, "Reload: keeping the old %s", GamepadTextures::kFiles[i]);
 			}
+			UnloadImage(image);
+			co_await TaskQueue::slice();
 		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-	params.menu.selectedIndex = 0;
-}
 
-void SetupVisualsMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Background Color",
-		[&params]() { 
-			params.menu.active = Menu::BGColor; 
-			SetupBGColorMenu(params); 
-		}
-		});
-	params.menu.items.push_back({
-		"Image Tint",
-		[&params]() { 
-			params.menu.active = Menu::Tint; 
-			SetupTintMenu(params); 
-		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-	params.menu.selectedIndex = 0;
-}
+		// Labels showing config values, then the cached menu panel
+		refreshVideoLabels(params);
+		refreshFPSLabels(params);
+		params.menu.invalidateLayout();
+	}
 
-void SetupControllerMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Select Gamepad",
-		[&params]() { 
-			params.menu.active = Menu::Gamepad; 
-			SetupGamepadMenu(params); 
+	void ReloadConfigAction(MenuParams& params, int)
+	{
+		params.tasks.post(ReloadConfigTask(params));
+	}
+
+	void ToggleVSyncAction(MenuParams& params, int)
+	{
+		bool vsync = params.config.getVSYNC();
+		if (vsync)
+		{
+			ClearWindowState(FLAG_VSYNC_HINT);
+			params.pacer.setVSync(false);
+			params.config.updateUseVSYNC(0);
 		}
-		});
-	params.menu.items.push_back({
-		"Remap Buttons",
-		[&params]() { 
-			params.menu.active = Menu::RemapButtons; 
-			SetupRemapMenu(params); 
+		else
+		{
+			// The swap blocks on vblank now; pacing on top of it would only fight it
+			SetWindowState(FLAG_VSYNC_HINT);
+			params.pacer.setVSync(true);
+			params.config.updateUseVSYNC(1);
 		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-	params.menu.selectedIndex = 0;
-}
+		OpenMenu(params, Menu::Video);
+	}
 
-void SetupResolutionMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"1280x720",
-		[&params]() { params.window.SetSize(1280, 720); }
-		});
-	params.menu.items.push_back({
-		"960x540",
-		[&params]() { params.window.SetSize(960, 540); }
-		});
-	params.menu.items.push_back({
-		"640x360",
-		[&params]() { params.window.SetSize(640, 360); }
-		});
-	params.menu.items.push_back({
-		"480x270",
-		[&params]() { params.window.SetSize(480, 270); }
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-
-	params.menu.selectedIndex = 0;
-}
+	void SetResolutionAction(MenuParams& params, int index)
+	{
+		params.window.SetSize(kResolutions[index].width, kResolutions[index].height);
+	}
 
-void SetupFPSMenu(MenuContext::MenuParams& params)
-{
-	bool vsync = params.config.getVSYNC();
-	if (vsync)
-	{
-		params.menu.items.clear();
-		params.menu.items.push_back({
-			"Can't change FPS\nwhile VSync is on!",
-			[&params]() { params.menu.active = Menu::Video; SetupVideoMenu(params); }
-			});
-		params.menu.items.push_back(createSpacer());
-		params.menu.items.push_back(createSpacer());
-		params.menu.items.push_back(createBackMenuItem(params));
-		params.menu.items.push_back(createCloseMenuItem(params.menu));
-		params.menu.selectedIndex = 0;
-		return;
+	void SetFPSAction(MenuParams& params, int fps)
+	{
+		params.pacer.setTargetFPS(fps);
+		params.config.updateTargetFPS(fps);
+		OpenMenu(params, Menu::FPS);
 	}
-	else
-	{
-	std::string current_fps = std::to_string(params.config.getValue("Window", "TARGET_FPS"));
-	std::string current_string = "Current FPS: " + current_fps;
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		current_string,
-		[&params]() { params.menu.active = Menu::None; }
-		});
-	params.menu.items.push_back({
-		"30 FPS",
-		[&params]() {
-			params.window.SetTargetFPS(30);
-			params.config.updateTargetFPS(30);
-			SetupFPSMenu(params);
-		}
-		});
-	params.menu.items.push_back({
-		"60 FPS",
-		[&params]() {
-			params.window.SetTargetFPS(60);
-			params.config.updateTargetFPS(60);
-			SetupFPSMenu(params);
-		}
-		});
-	params.menu.items.push_back({
-		"90 FPS",
-		[&params]() {
-			params.window.SetTargetFPS(90);
-			params.config.updateTargetFPS(90);
-			SetupFPSMenu(params);
-		}
-		});
-	params.menu.items.push_back({
-		"120 FPS",
-		[&params]() {
-			params.window.SetTargetFPS(120);
-			params.config.updateTargetFPS(120);
-			SetupFPSMenu(params);
-		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
+
+	void SetBGColorAction(MenuParams& params, int color)
+	{
+		params.config.updateBGColor(color);
+		params.config.updateUseCustomBG(0);
+		params.padcast.invalidateBGCache();
 	}
 
-	params.menu.selectedIndex = 0;
-}
+	void SetCustomBGAction(MenuParams& params, int)
+	{
+		params.config.updateUseCustomBG(1);
+		params.padcast.invalidateBGCache();
+	}
 
-void SetupBGColorMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Black",
-		[&params]() { 
-			params.config.updateBGColor(static_cast<int>(BackgroundColor::Black));
-			params.config.updateUseCustomBG(0);
-			params.padcast.invalidateBGCache();
-		}
-		});
-	params.menu.items.push_back({
-		"White",
-		[&params]() { 
-			params.config.updateBGColor(static_cast<int>(BackgroundColor::White)); 
-			params.config.updateUseCustomBG(0);
-			params.padcast.invalidateBGCache();
-		}
-		});
-	params.menu.items.push_back({
-		"Red",
-		[&params]() { 
-			params.config.updateBGColor(static_cast<int>(BackgroundColor::Red));
-			params.config.updateUseCustomBG(0);
-			params.padcast.invalidateBGCache();
-		}
-		});
-	params.menu.items.push_back({
-		"Green",
-		[&params]() { 
-			params.config.updateBGColor(static_cast<int>(BackgroundColor::Green));
-			params.config.updateUseCustomBG(0); 
-			params.padcast.invalidateBGCache(); 
-		}
-		});
-	params.menu.items.push_back({
-		"Blue",
-		[&params]() { 
-			params.config.updateBGColor(static_cast<int>(BackgroundColor::Blue));
-			params.config.updateUseCustomBG(0); 
-			params.padcast.invalidateBGCache(); 
-		}
-		});
-	params.menu.items.push_back({
-		"Custom Color",
-		[&params]() { 
-			params.config.updateUseCustomBG(1);
-			params.padcast.invalidateBGCache();
-		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
+	void SetTintAction(MenuParams& params, int paletteIndex)
+	{
+		params.config.updateImageTintPalette(paletteIndex);
+		params.config.updateUseCustomTint(0);
+		params.padcast.invalidateTintCache();
+	}
 
-	params.menu.selectedIndex = 0;
-}
+	void SetCustomTintAction(MenuParams& params, int)
+	{
+		params.config.updateUseCustomTint(1);
+		params.padcast.invalidateTintCache();
+	}
 
-void SetupTintMenu(MenuContext::MenuParams& params)
-{
-	params.menu.items.clear();
-	params.menu.items.push_back({ 
-		"White",
-		[&params]() {
-			params.config.updateImageTintPalette(0);
-			params.config.updateUseCustomTint(0);
-			params.padcast.invalidateTintCache();
-		}
-		});
-	params.menu.items.push_back({ 
-		"Red",
-		[&params]() {
-			params.config.updateImageTintPalette(1);
-			params.config.updateUseCustomTint(0);
-			params.padcast.invalidateTintCache();
+	void StartRemapAction(MenuParams& params, int)
+	{
+		params.menu.active = Menu::RemapButtons;
+		ResetRemapState();
+	}
+
+	void ResetButtonMapAction(MenuParams& params, int)
+	{
+		params.padcast.resetButtonsToDefault();
+		params.config.resetButtonMap();
+		params.tasks.post(SaveConfigTask(params.config));
+	}
+
+	void SelectGamepadAction(MenuParams& params, int index)
+	{
+		params.padcast.setGamepadIndex(index);
+		params.gamepadIndex = index;
+	}
+
+	//$ ----- Menu tree construction ----- //
+
+	void setLabel(MenuItem& item, const char* label)
+	{
+		std::snprintf(item.label, kMenuLabelSize, "%s", label);
+	}
+
+	void addItem(MenuPage& page, const char* label, MenuAction action, int arg = 0)
+	{
+		assert(page.count < kMaxMenuItems && "raise kMaxMenuItems");
+		if (page.count >= kMaxMenuItems)
+		{
+			TraceLog(LOG_WARNING, "Menu page is full, dropping item \"%s\"", label);
+			return;
 		}
-		});
-	params.menu.items.push_back({ 
-		"Green",
-		[&params]() {
-			params.config.updateImageTintPalette(2);
-			params.config.updateUseCustomTint(0);
-			params.padcast.invalidateTintCache();
+		MenuItem& item = page.items[page.count++];
+		setLabel(item, label);
+		item.action = action;
+		item.arg = arg;
+	}
+
+	void addSpacer(MenuPage& page)
+	{
+		addItem(page, " ", nullptr);
+	}
+
+	void addSubmenu(MenuPage& page, const char* label, Menu target)
+	{
+		addItem(page, label, OpenMenuAction, static_cast<int>(target));
+	}
+
+	void addBackAndClose(MenuPage& page)
+	{
+		addSubmenu(page, "Back", Menu::Main);
+		addItem(page, "Close", CloseMenuAction);
+	}
+
+	//$ ----- Dynamic labels ----- //
+	// Only reformatted when the value they show has changed
+
+	void refreshVideoLabels(MenuParams& params)
+	{
+		int vsync = params.config.getVSYNC();
+		if (vsync != params.menu.labelVsync)
+		{
+			std::snprintf(params.menu.page(Menu::Video).items[2].label, kMenuLabelSize,
+				"Toggle VSync \n(Currently: %s)", vsync == 1 ? "On" : "Off");
+			params.menu.labelVsync = vsync;
+			params.menu.panel.dirty = true;
 		}
-		});
-	params.menu.items.push_back({
-		"Blue",
-		[&params]() {
-			params.config.updateImageTintPalette(3);
-			params.config.updateUseCustomTint(0);
-			params.padcast.invalidateTintCache();
+	}
+
+	void refreshFPSLabels(MenuParams& params)
+	{
+		int fps = params.config.getFPS();
+		if (fps != params.menu.labelFPS)
+		{
+			std::snprintf(params.menu.page(Menu::FPS).items[0].label, kMenuLabelSize,
+				"Current FPS: %d", fps);
+			params.menu.labelFPS = fps;
+			params.menu.panel.dirty = true;
 		}
-		});
-	params.menu.items.push_back({ 
-		"Custom Tint",
-		[&params]() {
-			params.config.updateUseCustomTint(1);
-			params.padcast.invalidateTintCache();
+	}
+
+	void refreshGamepadLabels(MenuParams& params)
+	{
+		MenuPage& page = params.menu.page(Menu::Gamepad);
+		for (int i = 0; i < 4; ++i)
+		{
+			MenuItem& item = page.items[i];
+			char label[kMenuLabelSize];
+			if (params.input.isAvailable(i))
+			{
+				std::snprintf(label, kMenuLabelSize, "%d > %s", i, params.input.getName(i));
+				item.action = SelectGamepadAction;
+			}
+			else
+			{
+				std::snprintf(label, kMenuLabelSize, "No Gamepads Detected");
+				item.action = nullptr;
+			}
+
+			if (std::strcmp(label, item.label) != 0)
+			{
+				std::memcpy(item.label, label, kMenuLabelSize);
+				params.menu.panel.dirty = true;
+			}
 		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-	params.menu.selectedIndex = 0;
+	}
 }
 
-void SetupRemapMenu(MenuContext::MenuParams& params)
+MenuContext::MenuContext()
 {
-	params.menu.items.clear();
-	params.menu.items.push_back({
-		"Start Remap",
-		[&params]() { 
-			params.menu.active = Menu::RemapButtons; 
-			ResetRemapState(); 
-		}
-		});
-	params.menu.items.push_back({
-		"Reset to Default",
-		[&params]() { 
-			params.padcast.resetButtonsToDefault(); 
-			params.config.resetButtonMap(); 
-		}
-		});
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
-
-	params.menu.selectedIndex = 0;
+	MenuPage& main = page(Menu::Main);
+	addSubmenu(main, "Video", Menu::Video);
+	addSubmenu(main, "Visuals", Menu::Visuals);
+	addSubmenu(main, "Controller", Menu::Controller);
+	addSpacer(main);
+	addItem(main, "Reload Config File", ReloadConfigAction);
+	addSpacer(main);
+	addItem(main, "Close", CloseMenuAction);
+
+	MenuPage& video = page(Menu::Video);
+	addSubmenu(video, "Resolution", Menu::Resolution);
+	addSubmenu(video, "Target FPS", Menu::FPS);
+	addItem(video, "Toggle VSync", ToggleVSyncAction);	// label filled in by refreshVideoLabels
+	addSpacer(video);
+	addSpacer(video);
+	addBackAndClose(video);
+
+	MenuPage& visuals = page(Menu::Visuals);
+	addSubmenu(visuals, "Background Color", Menu::BGColor);
+	addSubmenu(visuals, "Image Tint", Menu::Tint);
+	addSpacer(visuals);
+	addBackAndClose(visuals);
+
+	MenuPage& controller = page(Menu::Controller);
+	addSubmenu(controller, "Select Gamepad", Menu::Gamepad);
+	addSubmenu(controller, "Remap Buttons", Menu::RemapButtons);
+	addSpacer(controller);
+	addBackAndClose(controller);
+
+	MenuPage& resolution = page(Menu::Resolution);
+	addItem(resolution, "1280x720", SetResolutionAction, 0);
+	addItem(resolution, "960x540", SetResolutionAction, 1);
+	addItem(resolution, "640x360", SetResolutionAction, 2);
+	addItem(resolution, "480x270", SetResolutionAction, 3);
+	addSpacer(resolution);
+	addBackAndClose(resolution);
+
+	MenuPage& fps = page(Menu::FPS);
+	addItem(fps, "Current FPS", CloseMenuAction);	// label filled in by refreshFPSLabels
+	addItem(fps, "30 FPS", SetFPSAction, 30);
+	addItem(fps, "60 FPS", SetFPSAction, 60);
+	addItem(fps, "90 FPS", SetFPSAction, 90);
+	addItem(fps, "120 FPS", SetFPSAction, 120);
+	addSpacer(fps);
+	addBackAndClose(fps);
+
+	MenuPage& fpsLocked = page(Menu::FPSLocked);
+	addSubmenu(fpsLocked, "Can't change FPS\nwhile VSync is on!", Menu::Video);
+	addSpacer(fpsLocked);
+	addSpacer(fpsLocked);
+	addBackAndClose(fpsLocked);
+
+	MenuPage& bgColor = page(Menu::BGColor);
+	addItem(bgColor, "Black", SetBGColorAction, static_cast<int>(BackgroundColor::Black));
+	addItem(bgColor, "White", SetBGColorAction, static_cast<int>(BackgroundColor::White));
+	addItem(bgColor, "Red", SetBGColorAction, static_cast<int>(BackgroundColor::Red));
+	addItem(bgColor, "Green", SetBGColorAction, static_cast<int>(BackgroundColor::Green));
+	addItem(bgColor, "Blue", SetBGColorAction, static_cast<int>(BackgroundColor::Blue));
+	addItem(bgColor, "Custom Color", SetCustomBGAction);
+	addSpacer(bgColor);
+	addBackAndClose(bgColor);
+
+	MenuPage& tint = page(Menu::Tint);
+	addItem(tint, "White", SetTintAction, 0);
+	addItem(tint, "Red", SetTintAction, 1);
+	addItem(tint, "Green", SetTintAction, 2);
+	addItem(tint, "Blue", SetTintAction, 3);
+	addItem(tint, "Custom Tint", SetCustomTintAction);
+	addSpacer(tint);
+	addBackAndClose(tint);
+
+	MenuPage& remap = page(Menu::RemapButtons);
+	addItem(remap, "Start Remap", StartRemapAction);
+	addItem(remap, "Reset to Default", ResetButtonMapAction);
+	addSpacer(remap);
+	addBackAndClose(remap);
+
+	MenuPage& gamepad = page(Menu::Gamepad);
+	for (int i = 0; i < 4; ++i)
+	{
+		addItem(gamepad, "No Gamepads Detected", nullptr, i);	// refreshed on open
+	}
+	addSpacer(gamepad);
+	addBackAndClose(gamepad);
 }
 
-void SetupGamepadMenu(MenuContext::MenuParams& params)
+void OpenMenu(MenuContext::MenuParams& params, Menu target)
 {
-	params.menu.items.clear();
-	for (int i = 0; i < 4; ++i)
+	switch (target)
 	{
-		if (raylib::Gamepad::IsAvailable(i))
+	case Menu::Video:
+		refreshVideoLabels(params);
+		break;
+	case Menu::FPS:
+		if (params.config.getVSYNC())
 		{
-			std::string menuListing = std::to_string(i) + " > " + params.padcast.getGamepadName(i);
-			params.menu.items.push_back({
-				menuListing,
-				[&params, i]() { 
-					params.padcast.setGamepadIndex(i);
-					params.gamepadIndex = i;
-				}
-			});
+			target = Menu::FPSLocked;
 		}
 		else
 		{
-			params.menu.items.push_back({
-				"No Gamepads Detected",
-				[]() {}
-			});
+			refreshFPSLabels(params);
 		}
+		break;
+	case Menu::Gamepad:
+		refreshGamepadLabels(params);
+		break;
+	default:
+		break;
+	}
+
+	if (target != params.menu.active)
+	{
+		params.menu.selectedIndex = 0;
+		params.menu.invalidateLayout();
 	}
+	params.menu.active = target;
+}
+
+MenuContext::~MenuContext()
+{
+	if (panel.target.id != 0)
+	{
+		UnloadRenderTexture(panel.target);
+	}
+}
 
-	params.menu.items.push_back(createSpacer());
-	params.menu.items.push_back(createBackMenuItem(params));
-	params.menu.items.push_back(createCloseMenuItem(params.menu));
+namespace
+{
+	constexpr int kMenuBaseX{ 50 };
+	constexpr int kMenuBaseY{ 50 };
+
+	const MenuLayout& updateLayout(MenuContext& menu, const ScalingInfo& scaling, const Config& config)
+	{
+		MenuLayout& layout = menu.layout;
+		if (layout.valid)
+		{
+			return layout;
+		}
+
+		float menuScale = std::max(scaling.scale, 0.7f); // don't scale menu font/positions below 70%
+		layout.x = static_cast<int>(kMenuBaseX * menuScale + scaling.offsetX);
+		layout.y = static_cast<int>(kMenuBaseY * menuScale + scaling.offsetY);
+		layout.itemWidth = static_cast<int>(340 * menuScale);
+		layout.lineHeight = std::max(static_cast<int>(30 * menuScale), 1);
+		layout.padding = static_cast<int>(10 * menuScale);
+		layout.panelWidth = (menu.active == Menu::Gamepad) ? 470 : layout.itemWidth;
+		layout.panelHeight = static_cast<int>(menu.current().size() * layout.lineHeight + 20 * menuScale);
+		layout.fontSize = std::max(
+			static_cast<int>(config.getValue("Font", "DEFAULT_FONT_SIZE") * menuScale),
+			config.getValue("Font", "MIN_FONT_SIZE")
+		);
+		layout.valid = true;
+		menu.panel.dirty = true;
+		return layout;
+	}
+}
 
-	params.menu.selectedIndex = 0;
+bool IsMenuTogglePressed()
+{
+	return IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)
+		|| IsKeyPressed(KEY_SPACE)
+		|| IsKeyPressed(KEY_M);
 }
 
 void HandleMenuInput(MenuContext::MenuParams& params)
 {
+	PADCAST_TRACE_SCOPE("HandleMenuInput");
 	// ----- Menu open/close ----- //
 	// a right click, spacebar, or M will open/close the main menu
-	if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)
-		|| IsKeyPressed(KEY_SPACE)
-		|| IsKeyPressed(KEY_M))
+	if (IsMenuTogglePressed())
 	{
 		if (params.menu.active == Menu::None)
 		{
-			params.menu.active = Menu::Main;
-			SetupMainMenu(params);
-			params.menu.selectedIndex = 0;
+			OpenMenu(params, Menu::Main);
 		}
 		else
 		{
@@ -438,94 +497,120 @@ void HandleMenuInput(MenuContext::MenuParams& params)
 	// ----- Menu navigation ----- //
 	if (params.menu.active != Menu::None)
 	{
+		const MenuPage& items = params.menu.current();
+		const int itemCount = static_cast<int>(items.size());
+
 		// Keyboard navigation (arrow keys or W/S)
 		if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S))
 		{
-			params.menu.selectedIndex = (params.menu.selectedIndex + 1) % params.menu.items.size();
+			params.menu.selectedIndex = (params.menu.selectedIndex + 1) % itemCount;
 		}
 		else if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W))
 		{
-			params.menu.selectedIndex =
-				(params.menu.selectedIndex - 1 + params.menu.items.size()) % params.menu.items.size();
+			params.menu.selectedIndex = (params.menu.selectedIndex - 1 + itemCount) % itemCount;
 		}
 		else if (IsKeyPressed(KEY_ENTER))
 		{
-			params.menu.items[params.menu.selectedIndex].action();
+			const MenuItem& item = items[params.menu.selectedIndex];
+			if (item.action)
+			{
+				item.action(params, item.arg);
+			}
+			return;
 		}
 
-		// Mouse navigation
+		// Mouse navigation -- rows are evenly spaced, so the hovered row falls
+		// straight out of the mouse Y instead of testing every item's rectangle
+		const MenuLayout& layout = updateLayout(params.menu, params.scaling, params.config);
 		Vector2 mousePos = GetMousePosition();
-		// Scaling setup for collision box
-		float menuScale = std::max(params.scaling.scale, 0.7f); // don't scale collision box below 70%
-		int baseX = 50;
-		int baseY = 50;
-		int scaledX = static_cast<int>(baseX * menuScale + params.scaling.offsetX);
-		int scaledY = static_cast<int>(baseY * menuScale + params.scaling.offsetY);
-		int scaledWidth = static_cast<int>(340 * menuScale);
-		int scaledLineHeight = static_cast<int>(30 * menuScale);
-		for (size_t i = 0; i < params.menu.items.size(); ++i)
+		int relX = static_cast<int>(mousePos.x) - layout.x;
+		int relY = static_cast<int>(mousePos.y) - layout.y;
+		if (relX >= 0 && relX < layout.itemWidth && relY >= 0)
 		{
-			Rectangle itemRect = {
-				static_cast<float>(scaledX),
-				static_cast<float>(scaledY + static_cast<int>(i) * scaledLineHeight),
-				static_cast<float>(scaledWidth),
-				static_cast<float>(scaledLineHeight - 5) // Slight padding
-			};
-			// Detect mouse clicking menu item
-			if (CheckCollisionPointRec(mousePos, itemRect))
+			int row = relY / layout.lineHeight;
+			bool inRow = (relY % layout.lineHeight) < (layout.lineHeight - 5); // Slight padding
+			if (row < itemCount && inRow)
 			{
-				params.menu.selectedIndex = static_cast<int>(i);
-				if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+				params.menu.selectedIndex = row;
+				if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && items[row].action)
 				{
-					params.menu.items[i].action();
+					items[row].action(params, items[row].arg);
+					return;
 				}
 			}
 		}
 	}
 }
 
-void DrawMenu(const MenuContext& menu, const ScalingInfo& scaling, const Config& config,
-	int baseX, int baseY)
+void DrawMenu(MenuContext& menu, const ScalingInfo& scaling, const Config& config,
+	TextCache& textCache)
 {
+	PADCAST_TRACE_SCOPE("DrawMenu");
 	if (menu.active == Menu::None)
 	{
 		return;
 	}
 
-	// Scaling setup
-	float menuScale = std::max(scaling.scale, 0.7f); // don't scale menu font/positions below 70%
-	int scaledX = static_cast<int>(baseX * menuScale + scaling.offsetX);
-	int scaledY = static_cast<int>(baseY * menuScale + scaling.offsetY);
-	int scaledWidth = static_cast<int>(340 * menuScale);
-	int scaledLineHeight = static_cast<int>(30 * menuScale);
-	int scaledMenuHeight = static_cast<int>(menu.items.size() * scaledLineHeight + 20 * menuScale);
-	int scaledPadding = static_cast<int>(10 * menuScale);
+	const MenuLayout& layout = updateLayout(menu, scaling, config);
+	MenuPanel& panel = menu.panel;
 
-	if (menu.active == Menu::Gamepad)
+	if (panel.drawnPage != menu.active || panel.drawnSelection != menu.selectedIndex)
 	{
-		scaledWidth = 470;
+		panel.dirty = true;
 	}
 
-	// Draw semi-transparent background
-	DrawRectangle(scaledX - scaledPadding, scaledY - scaledPadding,
-		scaledWidth, scaledMenuHeight,
-		Fade(BLACK, 0.7f)); // %70 opacity
+	if (panel.dirty)
+	{
+		if (panel.target.texture.width != layout.panelWidth
+			|| panel.target.texture.height != layout.panelHeight)
+		{
+			if (panel.target.id != 0)
+			{
+				UnloadRenderTexture(panel.target);
+			}
+			panel.target = LoadRenderTexture(std::max(layout.panelWidth, 1), std::max(layout.panelHeight, 1));
+		}
+
+		const MenuPage& items = menu.current();
+
+		BeginTextureMode(panel.target);
+		// Clearing writes the 70% background straight into the texture, and the
+		// separate alpha factors keep it premultiplied as text is blended on top
+		ClearBackground(Fade(BLACK, 0.7f));
+		rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+			RL_FUNC_ADD, RL_FUNC_ADD);
+		BeginBlendMode(BLEND_CUSTOM_SEPARATE);
 
-	// Cached font sizes
-	static int defaultFontSize = config.getValue("Font", "DEFAULT_FONT_SIZE");
-	static int minFontSize = config.getValue("Font", "MIN_FONT_SIZE");
+		// Draw menu items -- one text batch for the whole list
+		textCache.begin();
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			Color color = (static_cast<int>(i) == menu.selectedIndex ? WHITE : Fade(RAYWHITE, 0.7f));
+			textCache.draw(items[i].label,
+				layout.padding, layout.padding + static_cast<int>(i) * layout.lineHeight,
+				layout.fontSize, color);
+		}
+		textCache.end();
 
-	// Scaled font size
-	int fontSize = std::max(static_cast<int>(defaultFontSize * menuScale), minFontSize);
+		EndBlendMode();
+		EndTextureMode();
 
-	// Draw menu items
-	for (size_t i = 0; i < menu.items.size(); ++i)
-	{
-		Color color = (i == menu.selectedIndex ? WHITE : Fade(RAYWHITE, 0.7f));
-		DrawText(menu.items[i].label.c_str(),
-			scaledX, scaledY + static_cast<int>(i) * scaledLineHeight,
-			fontSize, color);
+		panel.drawnPage = menu.active;
+		panel.drawnSelection = menu.selectedIndex;
+		panel.dirty = false;
 	}
+
+	// Render textures are stored upside down, so flip the source height
+	const Rectangle source{
+		0.0f, 0.0f,
+		static_cast<float>(panel.target.texture.width),
+		-static_cast<float>(panel.target.texture.height)
+	};
+	BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+	DrawTextureRec(panel.target.texture, source,
+		Vector2{ static_cast<float>(layout.x - layout.padding), static_cast<float>(layout.y - layout.padding) },
+		WHITE);
+	EndBlendMode();
 }
 
 void ResetRemapState()
@@ -538,10 +623,10 @@ void ResetRemapState()
 
 void RemapButtonScreens(MenuContext::MenuParams& params)
 {
+	PADCAST_TRACE_SCOPE("RemapButtonScreens");
 	static bool isRemapping = false;
 	static bool waitingForInput = false;
 	static int buttonPromptIndex = 0;
-	static raylib::Gamepad remapGamepad(0);
 	static DebounceTimer buttonDebounce(0.5f);
 	static float lastAttemptTime = 0.0f;
 
@@ -651,15 +736,17 @@ void RemapButtonScreens(MenuContext::MenuParams& params)
 	}
 
 	// center prompt text
-	int textWidth = MeasureText(promptText, fontSize);
+	TextCache& textCache = params.padcast.getTextCache();
+	int textWidth = textCache.measure(promptText, fontSize);
 	int textHeight = fontSize;
 	int textX = rectX + (rectWidth - textWidth) / 2;
 	int textY = rectY + (rectHeight - textHeight) / 2;
-	DrawText(promptText, textX, textY, fontSize, WHITE);
+	textCache.begin();
+	textCache.draw(promptText, textX, textY, fontSize, WHITE);
 
 	if (waitingForInput)
 	{
-		int newButtonPress = remapGamepad.GetButtonPressed();
+		int newButtonPress = params.input.getButtonPressed();
 		if (newButtonPress > 0)
 		{
 			if (buttonDebounce.CanAcceptInput())
@@ -681,10 +768,11 @@ void RemapButtonScreens(MenuContext::MenuParams& params)
 		if (timeSinceAttempt < 1.0f && lastAttemptTime > 0.0f)
 		{
 			const char* waitText = "Wait...";
-			int waitWidth = MeasureText(waitText, static_cast<int>(fontSize * 0.7f));
+			int waitFontSize = static_cast<int>(fontSize * 0.7f);
+			int waitWidth = textCache.measure(waitText, waitFontSize);
 			int waitX = rectX + (rectWidth - waitWidth) / 2;
 			int waitY = textY + static_cast<int>(fontSize * 1.2f);
-			DrawText(waitText, waitX, waitY, static_cast<int>(fontSize * 0.7f), RED);
+			textCache.draw(waitText, waitX, waitY, waitFontSize, RED);
 		}
 
 		// Escape keymap if needed
@@ -693,10 +781,10 @@ void RemapButtonScreens(MenuContext::MenuParams& params)
 			isRemapping = false;
 			waitingForInput = false;
 			buttonPromptIndex = 0;
-			params.menu.active = Menu::Main;
-			SetupMainMenu(params);
+			OpenMenu(params, Menu::Main);
 		}
 	}
+	textCache.end();
 
 	// When finished, return to main menu
 	if (buttonPromptIndex >= 12)
@@ -704,9 +792,8 @@ void RemapButtonScreens(MenuContext::MenuParams& params)
 		isRemapping = false;
 		waitingForInput = false;
 		buttonPromptIndex = 0;
-		params.menu.active = Menu::Main;
-		params.config.saveConfig();
-		SetupMainMenu(params);
+		params.tasks.post(SaveConfigTask(params.config));
+		OpenMenu(params, Menu::Main);
 		return;
 	}
 }
\ No newline at end of file
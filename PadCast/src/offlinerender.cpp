@@ -0,0 +1,261 @@
+#include "offlinerender.h"
+#include "PadCast.h"
+#include "config.h"
+#include "inputreplay.h"
+#include "workpool.h"
+#include "glfwbridge.h"
+#include "trace.h"
+#include "y4m.h"
+
+#include <rlgl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #define PADCAST_GLAPI __stdcall
+#else
+    #define PADCAST_GLAPI
+#endif
+
+namespace
+{
+    constexpr unsigned int GL_RGBA_ID{ 0x1908 };
+    constexpr unsigned int GL_UNSIGNED_BYTE_ID{ 0x1401 };
+
+    using ReadPixelsFn = void (PADCAST_GLAPI*)(int, int, int, int, unsigned int, unsigned int, void*);
+
+    struct FrameSlot
+    {
+        std::vector<uint8_t> rgba;		// bottom-up rows, as glReadPixels returns them
+        std::vector<uint8_t> encoded;	// Y4M frame, written by the main thread
+        int64_t frame{ -1 };
+        std::atomic<bool> busy{ false };
+    };
+
+    void waitFor(const FrameSlot& slot)
+    {
+        slot.busy.wait(true, std::memory_order_acquire);
+    }
+
+    void flipRows(std::vector<uint8_t>& rgba, int width, int height)
+    {
+        const size_t stride = static_cast<size_t>(width) * 4;
+        for (int y = 0; y < height / 2; ++y)
+        {
+            uint8_t* top = rgba.data() + static_cast<size_t>(y) * stride;
+            uint8_t* bottom = rgba.data() + static_cast<size_t>(height - 1 - y) * stride;
+            std::swap_ranges(top, top + stride, bottom);
+        }
+    }
+
+}
+
+OfflineRenderer::OfflineRenderer(Settings settings)
+    : mSettings(std::move(settings))
+    , mFormat(formatFor(mSettings.outPath))
+{
+}
+
+OfflineRenderer::Format OfflineRenderer::formatFor(const std::string& outPath)
+{
+    std::string extension = std::filesystem::path(outPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".y4m" ? Format::Y4m : Format::Png;
+}
+
+int OfflineRenderer::run(InputReplay& replay)
+{
+    // Per-file "saved" messages from ExportImage would drown the progress lines
+    SetTraceLogLevel(LOG_WARNING);
+    Config config;
+
+    // The window only provides the GL context; nothing is drawn to it
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(320, 180, "PadCast render");
+    if (!IsWindowReady())
+    {
+        std::cerr << "Offline render needs an OpenGL 3.3 context (on a headless box, try xvfb-run)" << std::endl;
+        return 1;
+    }
+
+    const auto glReadPixelsPtr = reinterpret_cast<ReadPixelsFn>(glfwGetProcAddress("glReadPixels"));
+    if (glReadPixelsPtr == nullptr)
+    {
+        std::cerr << "glReadPixels isn't available" << std::endl;
+        CloseWindow();
+        return 1;
+    }
+
+    const int canvasWidth = config.getImgCanvasWidth();
+    const int canvasHeight = config.getImgCanvasHeight();
+    int width = mSettings.width > 0 ? mSettings.width : canvasWidth;
+    int height = mSettings.height > 0 ? mSettings.height : canvasHeight;
+    if (mFormat == Format::Y4m)
+    {
+        // 4:2:0 needs even dimensions
+        width += width & 1;
+        height += height & 1;
+    }
+
+    // Output
+    std::FILE* y4mFile{ nullptr };
+    const std::filesystem::path outDir{ mSettings.outPath };
+    if (mFormat == Format::Y4m)
+    {
+        y4mFile = std::fopen(mSettings.outPath.c_str(), "wb");
+        if (y4mFile == nullptr)
+        {
+            std::cerr << "Can't create " << mSettings.outPath << std::endl;
+            CloseWindow();
+            return 1;
+        }
+        std::fputs(y4m::header(width, height, mSettings.fps).c_str(), y4mFile);
+    }
+    else
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec)
+        {
+            std::cerr << "Can't create " << mSettings.outPath << ": " << ec.message() << std::endl;
+            CloseWindow();
+            return 1;
+        }
+    }
+
+    const double start = std::clamp(mSettings.startSeconds, 0.0, replay.getDurationSeconds());
+    const double end = mSettings.endSeconds > start ? mSettings.endSeconds : replay.getDurationSeconds();
+    const int64_t frameCount = static_cast<int64_t>(std::floor((end - start) * mSettings.fps)) + 1;
+
+    const int gamepadIndex = config.getGPIndex();
+    replay.setIndex(gamepadIndex);
+    replay.setPaused(true);
+    replay.seek(start);
+
+    bool writeFailed{ false };
+    std::atomic<int64_t> pngFailures{ 0 };
+    size_t steals{ 0 };
+    const auto renderStart = std::chrono::steady_clock::now();
+    {
+        PADCAST_TRACE_SCOPE("Offline render");
+        auto padcast = std::make_unique<PadCast>(config);
+        const ScalingInfo scaling{ width, height, canvasWidth, canvasHeight };
+        RenderTexture2D target = LoadRenderTexture(width, height);
+
+        WorkStealingPool pool{ mSettings.threads };
+        // Enough in flight to keep every worker busy while the next frames render
+        std::vector<FrameSlot> slots(static_cast<size_t>(pool.size()) * 2);
+        for (FrameSlot& slot : slots)
+        {
+            slot.rgba.resize(static_cast<size_t>(width) * height * 4);
+        }
+
+        // Main thread only; slots come back around in frame order, so the stream stays ordered
+        auto writeOut = [&](FrameSlot& slot) {
+            if (slot.frame >= 0 && y4mFile != nullptr && !writeFailed)
+            {
+                writeFailed = std::fwrite(slot.encoded.data(), 1, slot.encoded.size(), y4mFile) != slot.encoded.size();
+            }
+            slot.frame = -1;
+        };
+
+        auto lastProgress = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < frameCount && !writeFailed; ++i)
+        {
+            replay.setTime(start + static_cast<double>(i) / mSettings.fps);
+            const bool connected = padcast->updateGamepadConnection(replay.isAvailable(gamepadIndex));
+
+            FrameSlot& slot = slots[static_cast<size_t>(i) % slots.size()];
+            waitFor(slot);
+            writeOut(slot);
+
+            BeginTextureMode(target);
+            ClearBackground(padcast->getBGColor());
+            padcast->getTextures().unpressed.Draw(
+                raylib::Vector2{ scaling.offsetX, scaling.offsetY },
+                0.0f,
+                scaling.scale,
+                raylib::WHITE
+            );
+            if (connected)
+            {
+                padcast->drawGamepadButtons(replay.sample(gamepadIndex), scaling);
+            }
+            else
+            {
+                padcast->drawNoGamepadMessage(scaling);
+            }
+            rlDrawRenderBatchActive();
+            glReadPixelsPtr(0, 0, width, height, GL_RGBA_ID, GL_UNSIGNED_BYTE_ID, slot.rgba.data());
+            EndTextureMode();
+
+            slot.frame = i;
+            slot.busy.store(true, std::memory_order_relaxed);
+            pool.submit([&, i, slotPtr = &slot] {
+                FrameSlot& job = *slotPtr;
+                if (mFormat == Format::Y4m)
+                {
+                    const ptrdiff_t stride = static_cast<ptrdiff_t>(width) * 4;
+                    y4m::encodeFrame(job.rgba.data() + stride * (height - 1), -stride, width, height, job.encoded);
+                }
+                else
+                {
+                    flipRows(job.rgba, width, height);
+                    char name[32];
+                    std::snprintf(name, sizeof(name), "frame_%06lld.png", static_cast<long long>(i));
+                    const Image image{ job.rgba.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+                    if (!ExportImage(image, (outDir / name).string().c_str()))
+                    {
+                        pngFailures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                job.busy.store(false, std::memory_order_release);
+                job.busy.notify_all();
+            });
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastProgress >= std::chrono::seconds(1))
+            {
+                lastProgress = now;
+                std::cout << "Rendered " << i + 1 << " / " << frameCount << " frames" << std::endl;
+            }
+        }
+
+        // The frames still in flight, oldest first
+        pool.waitIdle();
+        for (size_t n = 0; n < slots.size(); ++n)
+        {
+            writeOut(slots[static_cast<size_t>(frameCount + static_cast<int64_t>(n)) % slots.size()]);
+        }
+        steals = pool.getSteals();
+        UnloadRenderTexture(target);
+    }
+    CloseWindow();
+
+    if (y4mFile != nullptr)
+    {
+        writeFailed = std::fclose(y4mFile) != 0 || writeFailed;
+    }
+    if (writeFailed || pngFailures.load() > 0)
+    {
+        std::cerr << "Writing " << mSettings.outPath << " failed" << std::endl;
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+    std::printf("Rendered %lld frames (%dx%d at %.3g FPS, %.1f s of input) in %.1f s: %.1fx real time, %zu steals\n",
+                static_cast<long long>(frameCount), width, height, mSettings.fps, end - start, seconds,
+                seconds > 0.0 ? (end - start) / seconds : 0.0, steals);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#ifdef _WIN32
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+#endif
+
+#include "paddaemon.h"
+#include "config.h"
+#include "inputsource.h"
+#include "padmapper.h"
+#include "padrelay.h"
+#include "pathmanager.h"
+#include "wsserver.h"
+
+#ifdef _WIN32
+    #undef NOGDI
+    #undef NOUSER
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+    std::atomic<bool> gStopRequested{ false };
+
+    void requestStop(int)
+    {
+        gStopRequested.store(true);
+    }
+
+    std::string jsonEscape(const char* text)
+    {
+        std::string out;
+        for (const char* p = text; p != nullptr && *p != '\0'; ++p)
+        {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(static_cast<char>(c));
+            }
+            else if (c < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out.push_back(static_cast<char>(c));
+            }
+        }
+        return out;
+    }
+
+    template <typename T>
+    void putLE(uint8_t* out, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            out[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+        }
+    }
+}
+
+PadDaemon::PadDaemon(Settings settings)
+    : mSettings{ std::move(settings) }
+{
+}
+
+int PadDaemon::run(Config& config, InputSource& input)
+{
+    WebSocketServer server;
+    WebSocketServer::Settings serverSettings;
+    serverSettings.bindAddress = mSettings.bindAddress;
+    serverSettings.port = mSettings.port;
+    serverSettings.webRoot = PathManager::getResourcePath("web");
+    serverSettings.imageRoot = PathManager::getResourcePath("images");
+    std::string error;
+    if (!server.start(serverSettings, error))
+    {
+        std::cerr << "Daemon: " << error << std::endl;
+        return 1;
+    }
+    std::cerr << "Serving pad state on http://" << mSettings.bindAddress << ":" << mSettings.port
+              << "/ (WebSocket at /ws)" << std::endl;
+
+    gStopRequested.store(false);
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // --relay-send: the same polling loop feeds a streaming PC's PadCast
+    padrelay::Sender relay;
+    if (!mSettings.relayTarget.empty())
+    {
+        if (!relay.open(mSettings.relayTarget, error))
+        {
+            std::cerr << "Relay: " << error << std::endl;
+            return 1;
+        }
+        std::cerr << "Relaying the pad to " << mSettings.relayTarget << " over UDP" << std::endl;
+    }
+
+    PadMapper mapper{ config };
+    const int gamepad{ config.getGPIndex() };
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start{ Clock::now() };
+
+    bool connected{ false };
+    bool sentConnected{ false };
+    uint32_t sentLogical{ 0 };
+    uint32_t sentRaw{ 0 };
+    uint32_t sequence{ 0 };
+    size_t lastClientCount{ 0 };
+
+    while (!gStopRequested.load())
+    {
+        input.update();
+        connected = mapper.pollGamepadConnection(input, gamepad);
+
+        uint32_t logical{ 0 };
+        uint32_t raw{ 0 };
+        PadState pad{};
+        if (connected)
+        {
+            pad = input.sample(gamepad);
+            logical = mapper.getLogicalButtons(pad);
+            raw = pad.buttons;
+        }
+        relay.publish(connected, pad, connected ? input.getName(gamepad) : nullptr);
+
+        // The first event goes out even if nothing changed so new clients have a state
+        if (sequence == 0 || connected != sentConnected || logical != sentLogical || raw != sentRaw)
+        {
+            ++sequence;
+            sentConnected = connected;
+            sentLogical = logical;
+            sentRaw = raw;
+            const uint64_t micros = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+
+            char json[512];
+            std::snprintf(json, sizeof(json),
+                          "{\"type\":\"state\",\"seq\":%u,\"t\":%.3f,\"connected\":%s,\"gamepad\":%d,"
+                          "\"name\":\"%s\",\"buttons\":%u,\"raw\":%u}",
+                          sequence, micros / 1000.0, connected ? "true" : "false", connected ? gamepad : -1,
+                          connected ? jsonEscape(input.getName(gamepad)).c_str() : "", logical, raw);
+
+            uint8_t binary[kBinaryEventBytes]{};
+            binary[0] = kBinaryVersion;
+            binary[1] = connected ? 1 : 0;
+            putLE(binary + 2, static_cast<int16_t>(connected ? gamepad : -1));
+            putLE(binary + 4, sequence);
+            putLE(binary + 8, logical);
+            putLE(binary + 12, raw);
+            putLE(binary + 16, micros);
+
+            server.broadcast(json, std::string_view{ reinterpret_cast<const char*>(binary), sizeof(binary) });
+        }
+
+        if (server.getClientCount() != lastClientCount)
+        {
+            lastClientCount = server.getClientCount();
+            std::cerr << "Daemon: " << lastClientCount << " client(s) connected" << std::endl;
+        }
+
+        // Sleeps in epoll_wait, so client traffic is handled the moment it arrives
+        server.poll(1);
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::cerr << "Daemon stopped after " << sequence << " updates, " << server.getMessagesSent()
+              << " messages sent" << std::endl;
+    return 0;
+}
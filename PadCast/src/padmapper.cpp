@@ -0,0 +1,223 @@
+#include "padmapper.h"
+#include "padshm.h"
+
+void CachedButtons::refreshCache(const ButtonMap& buttonMap)
+{
+    // reset each
+    dpadUp = dpadRight = dpadDown = dpadLeft = 0;
+    xButton = aButton = bButton = yButton = 0;
+    leftTrigger = rightTrigger = selectButton = startButton = 0;
+    for (const auto& [raylibButton, displayIndex] : buttonMap.buttonIndex)
+    {
+        switch (raylibButton)
+        {
+        case 1: // D-pad UP display
+            dpadUp = displayIndex;
+            break;
+        case 2: // D-pad RIGHT display
+            dpadRight = displayIndex;
+            break;
+        case 3: // D-pad DOWN display
+            dpadDown = displayIndex;
+            break;
+        case 4: // D-pad LEFT display
+            dpadLeft = displayIndex;
+            break;
+        case 5: // X button display
+            xButton = displayIndex;
+            break;
+        case 6: // A button display
+            aButton = displayIndex;
+            break;
+        case 7: // B button display
+            bButton = displayIndex;
+            break;
+        case 8: // Y button display
+            yButton = displayIndex;
+            break;
+        case 9: // Left shoulder display
+            leftTrigger = displayIndex;
+            break;
+        /* For future non-SNES controller use:
+        case 10: // Left trigger display
+            leftTrigger2 = displayIndex;
+            break;
+            */
+        case 11: // Right shoulder display
+            rightTrigger = displayIndex;
+            break;
+        /* For future non-SNES controller use:
+        case 12: // Left trigger display
+            leftTrigger2 = displayIndex;
+            break;
+            */
+        case 13: // Select display
+            selectButton = displayIndex;
+            break;
+        case 15: // Start display
+            startButton = displayIndex;
+            break;
+        }
+    }
+}
+
+//$ ----- PadMapper ----- //
+
+PadMapper::PadMapper(Config& config)
+    : mConfig{ config }
+{
+    loadButtonsFromConfig();
+}
+
+bool PadMapper::updateGamepadConnection(bool currentlyAvailable)
+{
+    // Cache stability threshold
+    if (mCachedStabilityThreshold == -1)
+    {
+        mCachedStabilityThreshold = mConfig.getValue("Gamepad", "STABILITY_THRESHOLD");
+    }
+
+    if (currentlyAvailable == mGamepadWasConnected)
+    {
+        mStabilityCounter = 0;
+    }
+    else if (currentlyAvailable)
+    {
+        // Show the overlay as soon as the pad is ready; only disconnects are
+        // debounced, so a flaky connection can't make the message flicker
+        mGamepadWasConnected = true;
+        mStabilityCounter = 0;
+    }
+    else
+    {
+        ++mStabilityCounter;
+        if (mStabilityCounter >= mCachedStabilityThreshold)
+        {
+            mGamepadWasConnected = currentlyAvailable;
+            mStabilityCounter = 0;
+        }
+    }
+    return mGamepadWasConnected;
+}
+
+bool PadMapper::pollGamepadConnection(const InputSource& input, int gamepad)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (!mGamepadWasConnected || now >= mNextConnectionCheck)
+    {
+        mNextConnectionCheck = now + kConnectionCheckInterval;
+        return updateGamepadConnection(input.isAvailable(gamepad));
+    }
+    return mGamepadWasConnected;
+}
+
+uint32_t PadMapper::getLogicalButtons(const PadState& pad) const
+{
+    uint32_t buttons{ 0 };
+    const auto add = [&](int mapped, padshm::Button bit) {
+        if (pad.isDown(mapped))
+        {
+            buttons |= bit;
+        }
+    };
+    add(mButtonCache.dpadUp, padshm::Up);
+    add(mButtonCache.dpadRight, padshm::Right);
+    add(mButtonCache.dpadDown, padshm::Down);
+    add(mButtonCache.dpadLeft, padshm::Left);
+    add(mButtonCache.xButton, padshm::X);
+    add(mButtonCache.aButton, padshm::A);
+    add(mButtonCache.bButton, padshm::B);
+    add(mButtonCache.yButton, padshm::Y);
+    add(mButtonCache.leftTrigger, padshm::L);
+    add(mButtonCache.rightTrigger, padshm::R);
+    add(mButtonCache.selectButton, padshm::Select);
+    add(mButtonCache.startButton, padshm::Start);
+    return buttons;
+}
+
+void PadMapper::loadButtonsFromConfig()
+{
+    // Clear the index
+    mButtonMap.buttonIndex.clear();
+
+    if (!mConfig.getIni().has("ButtonMap"))
+    {
+        mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
+        mButtonCache.refreshCache(mButtonMap);
+        return;
+    }
+
+    const auto& buttonSection = mConfig.getIni().get("ButtonMap");
+
+    for (const auto& [key, value_str] : buttonSection)
+    {
+        int value = 0;
+        try {
+            value = std::stoi(value_str);
+        }
+        catch (...) {
+            TraceLog(LOG_WARNING, "ButtonMap: %s=%s isn't a button number, ignoring it", key.c_str(), value_str.c_str());
+            continue;
+        }
+
+        // Map INI keys to raylib button constants
+        if (key == "DPAD_UP") 
+        {
+            mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_UP] = value;
+        }
+        else if (key == "DPAD_RIGHT") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = value;
+        }
+        else if (key == "DPAD_DOWN") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_DOWN] = value;
+        }
+        else if (key == "DPAD_LEFT") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_FACE_LEFT] = value;
+        }
+        else if (key == "X_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_UP] = value;
+        }
+        else if (key == "A_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_RIGHT] = value;
+        }
+        else if (key == "B_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_DOWN] = value;
+        }
+        else if (key == "Y_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_FACE_LEFT] = value;
+        }
+        else if (key == "L_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_LEFT_TRIGGER_1] = value;
+        }
+        else if (key == "R_BUTTON") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_RIGHT_TRIGGER_1] = value;
+        }
+        else if (key == "SELECT") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_MIDDLE_LEFT] = value;
+        }
+        else if (key == "START") 
+        {
+                mButtonMap.buttonIndex[GAMEPAD_BUTTON_MIDDLE_RIGHT] = value;
+        }
+    }
+
+    // Safety check - if somehow buttonIndex is still empty, use defaults
+    if (mButtonMap.buttonIndex.empty())
+    {
+        TraceLog(LOG_WARNING, "ButtonMap: no buttons loaded, using the default SNES map");
+        mButtonMap.buttonIndex = mButtonMap.defaultSNESIndex;
+    }
+
+    // Refresh the cache after loading
+    mButtonCache.refreshCache(mButtonMap);
+}
@@ -0,0 +1,443 @@
+#include "padrelay.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <type_traits>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/ip.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace padrelay
+{
+    namespace
+    {
+        // Axis moves smaller than this don't count as a change, so stick noise
+        // doesn't turn into a packet per poll
+        constexpr float kAxisStep{ 1.0f / 128.0f };
+
+        template <typename T>
+        void put(uint8_t*& out, T value)
+        {
+            using U = std::make_unsigned_t<T>;
+            const U bits = static_cast<U>(value);
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                *out++ = static_cast<uint8_t>(static_cast<uint64_t>(bits) >> (8 * i));
+            }
+        }
+
+        template <typename T>
+        T get(const uint8_t*& in)
+        {
+            using U = std::make_unsigned_t<T>;
+            uint64_t bits = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                bits |= static_cast<uint64_t>(*in++) << (8 * i);
+            }
+            return static_cast<T>(static_cast<U>(bits));
+        }
+
+#ifdef __linux__
+        // host:port, or just port when defaultHost is given
+        bool parseEndpoint(const std::string& text, const char* defaultHost, sockaddr_in& address, std::string& error)
+        {
+            const size_t colon = text.rfind(':');
+            if (colon == std::string::npos && defaultHost == nullptr)
+            {
+                error = "expected <host>:<port>, got \"" + text + "\"";
+                return false;
+            }
+            const std::string host = colon == std::string::npos ? defaultHost : text.substr(0, colon);
+            const std::string port = colon == std::string::npos ? text : text.substr(colon + 1);
+            char* end = nullptr;
+            const long number = std::strtol(port.c_str(), &end, 10);
+            address = sockaddr_in{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(number));
+            if (port.empty() || *end != '\0' || number < 1 || number > 65535)
+            {
+                error = "bad port in \"" + text + "\"";
+                return false;
+            }
+            if (inet_pton(AF_INET, host.empty() ? "0.0.0.0" : host.c_str(), &address.sin_addr) == 1)
+            {
+                return true;
+            }
+            // A host name, e.g. the streaming PC's
+            addrinfo hints{};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_DGRAM;
+            addrinfo* found = nullptr;
+            if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || found == nullptr)
+            {
+                error = "can't resolve " + host;
+                return false;
+            }
+            address.sin_addr = reinterpret_cast<const sockaddr_in*>(found->ai_addr)->sin_addr;
+            freeaddrinfo(found);
+            return true;
+        }
+#endif
+    }
+
+    uint64_t nowUs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //$ ----- Wire format ----- //
+
+    size_t encode(const Packet& packet, uint8_t* out)
+    {
+        uint8_t* p = out;
+        std::memcpy(p, kMagic.data(), kMagic.size());
+        p += kMagic.size();
+        const size_t nameLength = std::min(packet.name.size(), kMaxNameBytes);
+        *p++ = kVersion;
+        *p++ = static_cast<uint8_t>(std::min(packet.stateCount, kRedundancy));
+        *p++ = static_cast<uint8_t>(nameLength);
+        *p++ = 0;
+        put(p, packet.session);
+        std::memcpy(p, packet.name.data(), nameLength);
+        p += nameLength;
+        for (size_t i = 0; i < std::min(packet.stateCount, kRedundancy); ++i)
+        {
+            const State& state = packet.states[i];
+            put(p, state.sequence);
+            put(p, state.timeUs);
+            *p++ = state.connected ? 1 : 0;
+            *p++ = 0;
+            put(p, state.buttons);
+            for (float axis : state.axes)
+            {
+                put(p, static_cast<int16_t>(std::lround(std::clamp(axis, -1.0f, 1.0f) * 32767.0f)));
+            }
+        }
+        return static_cast<size_t>(p - out);
+    }
+
+    bool decode(const uint8_t* data, size_t size, Packet& out)
+    {
+        if (size < kHeaderBytes || std::memcmp(data, kMagic.data(), kMagic.size()) != 0 || data[4] != kVersion)
+        {
+            return false;
+        }
+        const size_t count = data[5];
+        const size_t nameLength = data[6];
+        if (count == 0 || count > kRedundancy || nameLength > kMaxNameBytes
+            || size != kHeaderBytes + nameLength + count * kStateBytes)
+        {
+            return false;
+        }
+        const uint8_t* p = data + 8;
+        out.session = get<uint32_t>(p);
+        out.name.assign(reinterpret_cast<const char*>(p), nameLength);
+        p += nameLength;
+        out.stateCount = count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            State& state = out.states[i];
+            state.sequence = get<uint32_t>(p);
+            state.timeUs = get<uint64_t>(p);
+            state.connected = (*p++ & 1) != 0;
+            ++p;
+            state.buttons = get<uint32_t>(p);
+            for (float& axis : state.axes)
+            {
+                axis = get<int16_t>(p) / 32767.0f;
+            }
+        }
+        return true;
+    }
+
+    //$ ----- Sender ----- //
+
+    void Sender::publish(bool connected, const PadState& pad, const char* name)
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+        const uint32_t buttons = connected ? pad.buttons : 0;
+        const std::array<float, PadState::kAxisCount> axes = connected ? pad.axes : std::array<float, PadState::kAxisCount>{};
+        const State& last = mPacket.states[0];
+        bool changed = mPacket.stateCount == 0 || connected != last.connected || buttons != last.buttons;
+        for (size_t i = 0; i < axes.size() && !changed; ++i)
+        {
+            changed = std::fabs(axes[i] - last.axes[i]) >= kAxisStep;
+        }
+
+        const uint64_t now = nowUs();
+        if (changed)
+        {
+            // Newest first; the oldest falls off the end
+            std::copy_backward(mPacket.states.begin(), mPacket.states.end() - 1, mPacket.states.end());
+            State& state = mPacket.states[0];
+            state.sequence = mPacket.states[1].sequence + 1;
+            state.timeUs = now;
+            state.connected = connected;
+            state.buttons = buttons;
+            state.axes = axes;
+            mPacket.stateCount = std::min(mPacket.stateCount + 1, kRedundancy);
+
+            const std::string_view newName{ connected && name != nullptr ? name : "" };
+            if (mPacket.name != newName.substr(0, kMaxNameBytes))
+            {
+                mPacket.name = newName.substr(0, kMaxNameBytes);
+            }
+            mRepeatsLeft = kRepeats;
+            send();
+        }
+        else if (mRepeatsLeft > 0)
+        {
+            --mRepeatsLeft;
+            send();
+        }
+        else if (now - mLastSendUs >= static_cast<uint64_t>(kHeartbeatMs) * 1000)
+        {
+            send();
+        }
+    }
+
+#ifdef __linux__
+
+    bool Sender::open(const std::string& target, std::string& error)
+    {
+        close();
+        sockaddr_in address{};
+        const std::string endpoint{ target.find(':') == std::string::npos
+                                    ? target + ":" + std::to_string(kDefaultPort) : target };
+        if (!parseEndpoint(endpoint, nullptr, address, error))
+        {
+            return false;
+        }
+        mSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (mSocket < 0 || connect(mSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            error = "can't send to " + target + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+        // Expedited Forwarding, for switches and routers that honour DSCP
+        const int tos = IPTOS_DSCP_EF;
+        setsockopt(mSocket, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+
+        mPacket = Packet{};
+        mPacket.session = std::random_device{}();
+        mLastSendUs = 0;
+        mRepeatsLeft = 0;
+        mPacketsSent = 0;
+        return true;
+    }
+
+    void Sender::close()
+    {
+        if (mSocket >= 0)
+        {
+            ::close(mSocket);
+            mSocket = -1;
+        }
+    }
+
+    void Sender::send()
+    {
+        uint8_t buffer[kMaxPacketBytes];
+        const size_t size = encode(mPacket, buffer);
+        // ECONNREFUSED just means nobody is listening yet; the next packet tries again
+        if (::send(mSocket, buffer, size, MSG_DONTWAIT) == static_cast<ssize_t>(size))
+        {
+            ++mPacketsSent;
+        }
+        mLastSendUs = nowUs();
+    }
+
+    //$ ----- Receiver ----- //
+
+    bool Receiver::open(const std::string& listen, std::string& error)
+    {
+        close();
+        sockaddr_in address{};
+        const std::string endpoint{ listen == "-" ? std::to_string(kDefaultPort) : listen };
+        if (!parseEndpoint(endpoint, "0.0.0.0", address, error))
+        {
+            return false;
+        }
+        mSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (mSocket < 0 || bind(mSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            error = "can't listen on " + listen + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+        mSession = 0;
+        mLastSequence = 0;
+        mConnected = false;
+        mButtons = 0;
+        mLatched = 0;
+        mLatchedSampled = 0;
+        mStats = ReceiverStats{};
+        return true;
+    }
+
+    void Receiver::close()
+    {
+        if (mSocket >= 0)
+        {
+            ::close(mSocket);
+            mSocket = -1;
+        }
+        mConnected = false;
+    }
+
+    void Receiver::receive()
+    {
+        if (mSocket < 0)
+        {
+            return;
+        }
+        uint8_t buffer[kMaxPacketBytes + 1];
+        Packet packet;
+        while (true)
+        {
+            const ssize_t size = recv(mSocket, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (size < 0)
+            {
+                return;	// EAGAIN: drained
+            }
+            if (!decode(buffer, static_cast<size_t>(size), packet))
+            {
+                ++mStats.rejected;
+                continue;
+            }
+            ++mStats.packets;
+            mLastPacket = std::chrono::steady_clock::now();
+            if (packet.session != mSession)
+            {
+                // The sender restarted; its sequence numbers start over
+                mSession = packet.session;
+                mLastSequence = 0;
+            }
+            if (mName != packet.name)
+            {
+                mName = packet.name;
+            }
+
+            // Oldest first, skipping what's already applied
+            for (size_t i = packet.stateCount; i-- > 0;)
+            {
+                const State& state = packet.states[i];
+                if (mLastSequence != 0 && static_cast<int32_t>(state.sequence - mLastSequence) <= 0)
+                {
+                    continue;
+                }
+                if (mLastSequence != 0 && state.sequence != mLastSequence + 1)
+                {
+                    mStats.lost += state.sequence - mLastSequence - 1;
+                }
+                if (i > 0)
+                {
+                    ++mStats.recovered;
+                }
+                apply(state);
+                mLastSequence = state.sequence;
+                ++mStats.states;
+            }
+            mStats.lastTransitUs = static_cast<int64_t>(nowUs() - packet.states[0].timeUs);
+        }
+    }
+
+#else
+
+    bool Sender::open(const std::string& target, std::string& error)
+    {
+        (void)target;
+        error = "the pad relay is only supported on Linux";
+        return false;
+    }
+
+    void Sender::close() {}
+    void Sender::send() {}
+
+    bool Receiver::open(const std::string& listen, std::string& error)
+    {
+        (void)listen;
+        error = "the pad relay is only supported on Linux";
+        return false;
+    }
+
+    void Receiver::close() {}
+    void Receiver::receive() {}
+
+#endif
+
+    void Receiver::apply(const State& state)
+    {
+        const uint32_t pressed = state.connected ? state.buttons & ~mButtons : 0;
+        mLatched |= pressed;
+        if (pressed != 0 && mLastPressed == 0)
+        {
+            mLastPressed = std::countr_zero(pressed);
+        }
+        mConnected = state.connected;
+        mButtons = state.connected ? state.buttons : 0;
+        mAxes = state.axes;
+    }
+
+    void Receiver::update()
+    {
+        mLastPressed = 0;
+        // A frame may sample more than once (VRR's change check, then the late
+        // latch), so a latched press is only dropped once a frame has gone by
+        mLatched &= ~mLatchedSampled;
+        mLatchedSampled = 0;
+        receive();
+        // Sender gone (or the network is): heartbeats stopped
+        if (mConnected && std::chrono::steady_clock::now() - mLastPacket > std::chrono::milliseconds(kTimeoutMs))
+        {
+            mConnected = false;
+            mButtons = 0;
+            mLatched = 0;
+            mLatchedSampled = 0;
+        }
+    }
+
+    bool Receiver::isAvailable(int gamepad) const
+    {
+        return mConnected && gamepad == mIndex;
+    }
+
+    const char* Receiver::getName(int gamepad) const
+    {
+        (void)gamepad;
+        return mName.empty() ? "PadCast relay" : mName.c_str();
+    }
+
+    PadState Receiver::sample(int gamepad)
+    {
+        receive();
+        PadState pad;
+        pad.gamepad = gamepad;
+        if (mConnected && gamepad == mIndex)
+        {
+            // A press that was released before this frame still shows for one
+            pad.buttons = mButtons | mLatched;
+            pad.axes = mAxes;
+            mLatchedSampled |= mLatched;
+        }
+        return pad;
+    }
+}
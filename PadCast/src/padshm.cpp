@@ -0,0 +1,224 @@
+#include "padshm.h"
+#include "shmframes.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace padshm
+{
+    namespace
+    {
+        std::string objectName(const std::string& name)
+        {
+            return name.starts_with('/') ? name : "/" + name;
+        }
+    }
+
+    //$ ----- Writer ----- //
+
+    bool Writer::create(const std::string& name, std::string& error)
+    {
+        close();
+#ifdef __linux__
+        mName = objectName(name);
+        static_assert(std::is_standard_layout_v<Segment>);
+        const int fd = shmframes::createObject(mName, offsetof(Segment, writerPid), error);
+        if (fd < 0)
+        {
+            return false;
+        }
+        // A new object, so it starts zeroed
+        if (ftruncate(fd, sizeof(Segment)) != 0)
+        {
+            error = "can't size " + mName + ": " + std::strerror(errno);
+            ::close(fd);
+            shm_unlink(mName.c_str());
+            return false;
+        }
+        void* base = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "can't map " + mName + ": " + std::strerror(errno);
+            shm_unlink(mName.c_str());
+            return false;
+        }
+
+        mSegment = new (base) Segment{};
+        mSegment->version = kVersion;
+        mSegment->snapshotBytes = sizeof(Snapshot);
+        mSegment->writerPid = static_cast<uint32_t>(getpid());
+        mSnapshot = Snapshot{};
+        mSnapshot.gamepad = -1;
+        publish(false, -1, 0, 0, {}, nullptr);
+        // Magic last: a reader that sees it sees a complete segment
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(mSegment->magic.data(), kMagic.data(), kMagic.size());
+        return true;
+#else
+        (void)name;
+        error = "shared pad state is only supported on Linux";
+        return false;
+#endif
+    }
+
+    void Writer::close()
+    {
+#ifdef __linux__
+        if (mSegment == nullptr)
+        {
+            return;
+        }
+        mSegment->closed.store(1, std::memory_order_release);
+        munmap(mSegment, sizeof(Segment));
+        shm_unlink(mName.c_str());
+        mSegment = nullptr;
+#endif
+    }
+
+    void Writer::publish(bool connected, int gamepad, uint32_t logicalButtons, uint32_t rawButtons,
+                         const std::array<float, kAxisCount>& axes, const char* name)
+    {
+        if (mSegment == nullptr)
+        {
+            return;
+        }
+        if (!connected)
+        {
+            logicalButtons = 0;
+            rawButtons = 0;
+        }
+        const uint64_t now = shmframes::monotonicNs();
+        if (connected != (mSnapshot.connected != 0) || rawButtons != mSnapshot.rawButtons
+            || logicalButtons != mSnapshot.logicalButtons || mSnapshot.changedNs == 0)
+        {
+            mSnapshot.changedNs = now;
+        }
+        mSnapshot.sampleNs = now;
+        ++mSnapshot.updates;
+        mSnapshot.connected = connected ? 1 : 0;
+        mSnapshot.gamepad = connected ? gamepad : -1;
+        mSnapshot.logicalButtons = logicalButtons;
+        mSnapshot.rawButtons = rawButtons;
+        mSnapshot.axes = connected ? axes : std::array<float, kAxisCount>{};
+        // Only rewritten when it changes, which is about never
+        const std::string_view newName{ name != nullptr ? name : "" };
+        const size_t nameLength = std::min(newName.size(), kNameBytes - 1);
+        if (std::string_view{ mSnapshot.name.data() } != newName.substr(0, nameLength))
+        {
+            mSnapshot.name.fill('\0');
+            std::memcpy(mSnapshot.name.data(), newName.data(), nameLength);
+        }
+
+        std::array<uint64_t, kSnapshotWords> words;
+        std::memcpy(words.data(), &mSnapshot, sizeof(Snapshot));
+
+        // Single writer, so a relaxed read of our own sequence is fine
+        const uint64_t sequence = mSegment->sequence.load(std::memory_order_relaxed);
+        mSegment->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kSnapshotWords; ++i)
+        {
+            mSegment->words[i].store(words[i], std::memory_order_relaxed);
+        }
+        mSegment->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    //$ ----- Reader ----- //
+
+    bool Reader::open(const std::string& name, std::string& error)
+    {
+        close();
+#ifdef __linux__
+        const std::string object = objectName(name);
+        const int fd = shm_open(object.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            error = "no pad state called " + object + " (is PadCast running with --share-pad?)";
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Segment))
+        {
+            ::close(fd);
+            error = "pad state isn't set up yet";
+            return false;
+        }
+        void* base = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "can't map the pad state";
+            return false;
+        }
+
+        const auto* segment = static_cast<const Segment*>(base);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->magic != kMagic || segment->version != kVersion || segment->snapshotBytes != sizeof(Snapshot))
+        {
+            munmap(base, sizeof(Segment));
+            error = "not PadCast pad state, or from another version";
+            return false;
+        }
+        mSegment = segment;
+        return true;
+#else
+        (void)name;
+        error = "shared pad state is only supported on Linux";
+        return false;
+#endif
+    }
+
+    void Reader::close()
+    {
+#ifdef __linux__
+        if (mSegment != nullptr)
+        {
+            munmap(const_cast<Segment*>(mSegment), sizeof(Segment));
+        }
+#endif
+        mSegment = nullptr;
+    }
+
+    bool Reader::read(Snapshot& out) const
+    {
+        std::array<uint64_t, kSnapshotWords> words;
+        for (int attempt = 0; attempt < 1000; ++attempt)
+        {
+            const uint64_t before = mSegment->sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+            {
+                // Mid-write; the writer is done within nanoseconds unless it was preempted
+                if (attempt % 64 == 63)
+                {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            for (size_t i = 0; i < kSnapshotWords; ++i)
+            {
+                words[i] = mSegment->words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (mSegment->sequence.load(std::memory_order_relaxed) == before)
+            {
+                std::memcpy(&out, words.data(), sizeof(Snapshot));
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,77 @@
+#include "padstate.h"
+#include "glfwbridge.h"
+
+namespace
+{
+    // GLFW_GAMEPAD_BUTTON_* order -> raylib GamepadButton, same table raylib uses
+    constexpr std::array<int, 15> kGLFWToRaylib{
+        GAMEPAD_BUTTON_RIGHT_FACE_DOWN,     // A
+        GAMEPAD_BUTTON_RIGHT_FACE_RIGHT,    // B
+        GAMEPAD_BUTTON_RIGHT_FACE_LEFT,     // X
+        GAMEPAD_BUTTON_RIGHT_FACE_UP,       // Y
+        GAMEPAD_BUTTON_LEFT_TRIGGER_1,      // Left bumper
+        GAMEPAD_BUTTON_RIGHT_TRIGGER_1,     // Right bumper
+        GAMEPAD_BUTTON_MIDDLE_LEFT,         // Back
+        GAMEPAD_BUTTON_MIDDLE_RIGHT,        // Start
+        GAMEPAD_BUTTON_MIDDLE,              // Guide
+        GAMEPAD_BUTTON_LEFT_THUMB,
+        GAMEPAD_BUTTON_RIGHT_THUMB,
+        GAMEPAD_BUTTON_LEFT_FACE_UP,        // D-pad
+        GAMEPAD_BUTTON_LEFT_FACE_RIGHT,
+        GAMEPAD_BUTTON_LEFT_FACE_DOWN,
+        GAMEPAD_BUTTON_LEFT_FACE_LEFT
+    };
+
+    // raylib reports the analog triggers as buttons past this much travel
+    constexpr float kTriggerThreshold{ 0.1f };
+}
+
+PadState PadState::fromRaylib(int gamepad)
+{
+    PadState state;
+    state.gamepad = gamepad;
+    for (int button = GAMEPAD_BUTTON_LEFT_FACE_UP; button <= GAMEPAD_BUTTON_RIGHT_THUMB; ++button)
+    {
+        if (IsGamepadButtonDown(gamepad, button))
+        {
+            state.buttons |= 1u << button;
+        }
+    }
+    for (int axis = 0; axis < kAxisCount; ++axis)
+    {
+        state.axes[axis] = GetGamepadAxisMovement(gamepad, axis);
+    }
+    return state;
+}
+
+PadState PadState::sampleNow(int gamepad)
+{
+    GLFWgamepadstate raw{};
+    if (!glfwGetGamepadState(gamepad, &raw))
+    {
+        return fromRaylib(gamepad);
+    }
+
+    PadState state;
+    state.gamepad = gamepad;
+    for (size_t i = 0; i < kGLFWToRaylib.size(); ++i)
+    {
+        if (raw.buttons[i])
+        {
+            state.buttons |= 1u << kGLFWToRaylib[i];
+        }
+    }
+    for (int axis = 0; axis < kAxisCount; ++axis)
+    {
+        state.axes[axis] = raw.axes[axis];
+    }
+    if (state.axes[GAMEPAD_AXIS_LEFT_TRIGGER] > kTriggerThreshold)
+    {
+        state.buttons |= 1u << GAMEPAD_BUTTON_LEFT_TRIGGER_2;
+    }
+    if (state.axes[GAMEPAD_AXIS_RIGHT_TRIGGER] > kTriggerThreshold)
+    {
+        state.buttons |= 1u << GAMEPAD_BUTTON_RIGHT_TRIGGER_2;
+    }
+    return state;
+}
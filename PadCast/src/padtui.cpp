@@ -0,0 +1,584 @@
+#ifdef _WIN32
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+#endif
+
+#include "padtui.h"
+#include "config.h"
+#include "inputsource.h"
+#include "padmapper.h"
+#include "padshm.h"
+
+#ifdef _WIN32
+    #undef NOGDI
+    #undef NOUSER
+#endif
+
+#include <iostream>
+
+#ifndef _WIN32
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <cerrno>
+    #include <climits>
+    #include <csignal>
+    #include <cstdint>
+    #include <string_view>
+    #include <vector>
+
+    #include <poll.h>
+    #include <sys/ioctl.h>
+    #include <termios.h>
+    #include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+    std::atomic<bool> gStopRequested{ false };
+    std::atomic<bool> gResized{ false };
+
+    void requestStop(int)
+    {
+        gStopRequested.store(true);
+    }
+
+    void requestResize(int)
+    {
+        gResized.store(true);
+    }
+
+    //$ ----- Layout ----- //
+    // Colours are xterm-256 indices; kDefault is the terminal's own
+    constexpr int kDefault{ -1 };
+    constexpr int kBodyColor{ 250 };
+    constexpr int kDpadColor{ 237 };
+    constexpr int kLitColor{ 45 };
+    constexpr int kCaptionColor{ 242 };
+
+    // The pad in half-block pixels: one cell is two, so pixels are about square
+    constexpr int kCanvasWidth{ 60 };
+    constexpr int kCanvasHeight{ 26 };
+    constexpr int kCanvasRows{ kCanvasHeight / 2 };
+    constexpr int kStatusLines{ 5 };
+
+    enum class Shape
+    {
+        Rect,	// x, y, size w x h
+        Circle	// centre x, y, radius w
+    };
+
+    struct Element
+    {
+        int displayIndex;	// as in ButtonMap::defaultSNESIndex
+        uint32_t bit;		// padshm::Button
+        Shape shape;
+        float x, y, w, h;
+        int color;
+        int pressedColor;
+        char label;
+        int labelColumn;	// cell, relative to the canvas
+        int labelRow;
+    };
+
+    constexpr std::array<Element, 12> kElements{ {
+        { 1, padshm::Up, Shape::Rect, 12, 7, 4, 5, kDpadColor, kLitColor, '^', 13, 4 },
+        { 2, padshm::Right, Shape::Rect, 16, 12, 5, 4, kDpadColor, kLitColor, '>', 18, 7 },
+        { 3, padshm::Down, Shape::Rect, 12, 16, 4, 5, kDpadColor, kLitColor, 'v', 13, 9 },
+        { 4, padshm::Left, Shape::Rect, 7, 12, 5, 4, kDpadColor, kLitColor, '<', 9, 7 },
+        { 5, padshm::X, Shape::Circle, 46, 8, 2.9f, 0, 27, 117, 'X', 46, 4 },
+        { 6, padshm::A, Shape::Circle, 52, 14, 2.9f, 0, 160, 210, 'A', 52, 7 },
+        { 7, padshm::B, Shape::Circle, 46, 20, 2.9f, 0, 178, 228, 'B', 46, 10 },
+        { 8, padshm::Y, Shape::Circle, 40, 14, 2.9f, 0, 28, 120, 'Y', 40, 7 },
+        { 9, padshm::L, Shape::Rect, 5, 0, 16, 4, 244, kLitColor, 'L', 12, 0 },
+        { 11, padshm::R, Shape::Rect, 39, 0, 16, 4, 244, kLitColor, 'R', 47, 0 },
+        { 13, padshm::Select, Shape::Rect, 23, 16, 5, 2, 240, kLitColor, '\0', 0, 0 },
+        { 15, padshm::Start, Shape::Rect, 32, 16, 5, 2, 240, kLitColor, '\0', 0, 0 },
+    } };
+
+    // padshm::Button order
+    constexpr std::array<const char*, 12> kButtonNames{ "Up", "Right", "Down", "Left", "X", "A",
+                                                        "B", "Y", "L", "R", "Select", "Start" };
+
+    bool covers(Shape shape, float x, float y, float w, float h, int px, int py)
+    {
+        const float cx = px + 0.5f;
+        const float cy = py + 0.5f;
+        if (shape == Shape::Circle)
+        {
+            return (cx - x) * (cx - x) + (cy - y) * (cy - y) <= w * w;
+        }
+        return cx >= x && cx < x + w && cy >= y && cy < y + h;
+    }
+
+    //$ ----- Cells ----- //
+    struct Cell
+    {
+        char32_t glyph{ U' ' };
+        int fg{ kDefault };
+        int bg{ kDefault };
+
+        bool operator==(const Cell&) const = default;
+    };
+
+    void appendUtf8(std::string& out, char32_t c)
+    {
+        if (c < 0x80)
+        {
+            out.push_back(static_cast<char>(c));
+        }
+        else if (c < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+
+    // What the terminal shows (front) and what it should (back); flush()
+    // writes only the cells that differ
+    class CellBuffer
+    {
+    public:
+        void resize(int columns, int rows)
+        {
+            mColumns = std::max(columns, 1);
+            mRows = std::max(rows, 1);
+            mBack.assign(static_cast<size_t>(mColumns * mRows), Cell{});
+            // Matches nothing, so the next flush writes every cell
+            mFront.assign(mBack.size(), Cell{ 0, kDefault, kDefault });
+        }
+
+        int getColumns() const { return mColumns; }
+        int getRows() const { return mRows; }
+
+        void clear() { std::fill(mBack.begin(), mBack.end(), Cell{}); }
+
+        void set(int column, int row, const Cell& cell)
+        {
+            if (column >= 0 && column < mColumns && row >= 0 && row < mRows)
+            {
+                mBack[static_cast<size_t>(row * mColumns + column)] = cell;
+            }
+        }
+
+        const Cell& get(int column, int row) const
+        {
+            static const Cell kOutside{};
+            if (column >= 0 && column < mColumns && row >= 0 && row < mRows)
+            {
+                return mBack[static_cast<size_t>(row * mColumns + column)];
+            }
+            return kOutside;
+        }
+
+        // ASCII only; anything else shows as '?'
+        void text(int column, int row, std::string_view text, int fg = kDefault, int bg = kDefault)
+        {
+            for (const char c : text)
+            {
+                const bool printable = c >= 0x20 && c < 0x7F;
+                set(column++, row, Cell{ printable ? static_cast<char32_t>(c) : U'?', fg, bg });
+            }
+        }
+
+        // Appends the escapes for the changed cells to out; returns how many
+        size_t flush(std::string& out)
+        {
+            size_t written = 0;
+            size_t cursor = SIZE_MAX;	// where the next glyph would land without a move
+            int penFg = INT_MIN;
+            int penBg = INT_MIN;
+            for (size_t i = 0; i < mBack.size(); ++i)
+            {
+                const Cell& cell = mBack[i];
+                if (cell == mFront[i])
+                {
+                    continue;
+                }
+                if (i != cursor)
+                {
+                    out += "\x1b[" + std::to_string(i / mColumns + 1) + ";" + std::to_string(i % mColumns + 1) + "H";
+                }
+                if (cell.fg != penFg || cell.bg != penBg)
+                {
+                    out += "\x1b[0";
+                    if (cell.fg != kDefault)
+                    {
+                        out += ";38;5;" + std::to_string(cell.fg);
+                    }
+                    if (cell.bg != kDefault)
+                    {
+                        out += ";48;5;" + std::to_string(cell.bg);
+                    }
+                    out += "m";
+                    penFg = cell.fg;
+                    penBg = cell.bg;
+                }
+                appendUtf8(out, cell.glyph);
+                mFront[i] = cell;
+                ++written;
+                // Past the last column the terminal's wrap is pending; move explicitly
+                cursor = (i + 1) % mColumns == 0 ? SIZE_MAX : i + 1;
+            }
+            if (written > 0)
+            {
+                out += "\x1b[0m";
+            }
+            return written;
+        }
+
+    private:
+        int mColumns{ 1 };
+        int mRows{ 1 };
+        std::vector<Cell> mBack;
+        std::vector<Cell> mFront;
+    };
+
+    //$ ----- Terminal ----- //
+    bool writeAll(const std::string& data)
+    {
+        size_t done = 0;
+        while (done < data.size())
+        {
+            const ssize_t n = ::write(STDOUT_FILENO, data.data() + done, data.size() - done);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Alternate screen, no cursor, keys read one at a time without echo;
+    // everything is put back on destruction
+    class TerminalMode
+    {
+    public:
+        ~TerminalMode()
+        {
+            if (mActive)
+            {
+                writeAll("\x1b[0m\x1b[?25h\x1b[?1049l");
+                tcsetattr(STDIN_FILENO, TCSANOW, &mSaved);
+            }
+        }
+
+        bool enter()
+        {
+            if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &mSaved) != 0)
+            {
+                return false;
+            }
+            termios raw{ mSaved };
+            raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);	// ISIG stays, so Ctrl+C still stops
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0)
+            {
+                return false;
+            }
+            mActive = true;
+            writeAll("\x1b[?1049h\x1b[?25l\x1b[2J");
+            return true;
+        }
+
+    private:
+        termios mSaved{};
+        bool mActive{ false };
+    };
+
+    void querySize(int& columns, int& rows)
+    {
+        winsize size{};
+        const bool known = ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0;
+        columns = known ? size.ws_col : 80;
+        rows = known ? size.ws_row : 24;
+    }
+
+    // Drains stdin; true if q was pressed
+    bool quitPressed()
+    {
+        char keys[32];
+        bool quit = false;
+        ssize_t n;
+        while ((n = ::read(STDIN_FILENO, keys, sizeof(keys))) > 0)
+        {
+            quit = quit || std::find_if(keys, keys + n, [](char c) { return c == 'q' || c == 'Q'; }) != keys + n;
+        }
+        return quit;
+    }
+
+    //$ ----- Frame ----- //
+    struct View
+    {
+        bool connected{ false };
+        int gamepad{ 0 };
+        const char* name{ "" };
+        uint32_t logical{ 0 };
+        uint32_t raw{ 0 };
+    };
+
+    std::string buttonList(uint32_t logical)
+    {
+        std::string list;
+        for (size_t bit = 0; bit < kButtonNames.size(); ++bit)
+        {
+            if ((logical & (1u << bit)) != 0)
+            {
+                list += list.empty() ? "" : " ";
+                list += kButtonNames[bit];
+            }
+        }
+        return list.empty() ? "-" : list;
+    }
+
+    std::string rawList(uint32_t raw)
+    {
+        std::string list;
+        for (int button = 0; button < 32; ++button)
+        {
+            if ((raw & (1u << button)) != 0)
+            {
+                list += list.empty() ? "" : " ";
+                list += std::to_string(button);
+            }
+        }
+        return list.empty() ? "-" : list;
+    }
+
+    std::string mappingLine(const CachedButtons& buttons)
+    {
+        const std::array<int, 12> mapped{ buttons.dpadUp, buttons.dpadRight, buttons.dpadDown, buttons.dpadLeft,
+                                          buttons.xButton, buttons.aButton, buttons.bButton, buttons.yButton,
+                                          buttons.leftTrigger, buttons.rightTrigger, buttons.selectButton,
+                                          buttons.startButton };
+        std::string line{ "Map:  " };
+        for (size_t i = 0; i < mapped.size(); ++i)
+        {
+            line += std::string{ kButtonNames[i] } + "=" + std::to_string(mapped[i]) + (i + 1 < mapped.size() ? " " : "");
+        }
+        return line;
+    }
+
+    void compose(CellBuffer& cells, const std::vector<const Element*>& layout, const View& view,
+                 const std::string& mapping, const std::string& inputLabel)
+    {
+        cells.clear();
+        const int needRows = kCanvasRows + kStatusLines + 2;
+        if (cells.getColumns() < kCanvasWidth || cells.getRows() < needRows)
+        {
+            cells.text(0, 0, "Terminal too small for the pad (needs " + std::to_string(kCanvasWidth) + "x"
+                             + std::to_string(needRows) + "), q quits");
+            return;
+        }
+
+        // Pixels: shoulders behind the body, buttons on top
+        std::array<int, kCanvasWidth * kCanvasHeight> pixels;
+        pixels.fill(kDefault);
+        const auto paint = [&](Shape shape, float x, float y, float w, float h, int color) {
+            for (int py = 0; py < kCanvasHeight; ++py)
+            {
+                for (int px = 0; px < kCanvasWidth; ++px)
+                {
+                    if (covers(shape, x, y, w, h, px, py))
+                    {
+                        pixels[static_cast<size_t>(py * kCanvasWidth + px)] = color;
+                    }
+                }
+            }
+        };
+        const auto isPressed = [&](const Element& element) { return (view.logical & element.bit) != 0; };
+        for (const Element* element : layout)
+        {
+            if (element->bit == padshm::L || element->bit == padshm::R)
+            {
+                paint(element->shape, element->x, element->y, element->w, element->h,
+                      isPressed(*element) ? element->pressedColor : element->color);
+            }
+        }
+        paint(Shape::Circle, 14, 14, 11.5f, 0, kBodyColor);
+        paint(Shape::Circle, 46, 14, 11.5f, 0, kBodyColor);
+        paint(Shape::Rect, 14, 5, 32, 18, kBodyColor);
+        paint(Shape::Rect, 12, 12, 4, 4, kDpadColor);
+        for (const Element* element : layout)
+        {
+            if (element->bit != padshm::L && element->bit != padshm::R)
+            {
+                paint(element->shape, element->x, element->y, element->w, element->h,
+                      isPressed(*element) ? element->pressedColor : element->color);
+            }
+        }
+
+        // Two pixels to a cell: "▀" in the top one's colour over the bottom one's
+        const int left = (cells.getColumns() - kCanvasWidth) / 2;
+        const int top = 1;
+        for (int row = 0; row < kCanvasRows; ++row)
+        {
+            for (int column = 0; column < kCanvasWidth; ++column)
+            {
+                const int upper = pixels[static_cast<size_t>(2 * row * kCanvasWidth + column)];
+                const int lower = pixels[static_cast<size_t>((2 * row + 1) * kCanvasWidth + column)];
+                Cell cell;
+                if (upper == lower)
+                {
+                    cell = upper == kDefault ? Cell{} : Cell{ U'█', upper, kDefault };
+                }
+                else if (upper == kDefault)
+                {
+                    cell = Cell{ U'▄', lower, kDefault };
+                }
+                else
+                {
+                    cell = Cell{ U'▀', upper, lower };
+                }
+                cells.set(left + column, top + row, cell);
+            }
+        }
+
+        for (const Element* element : layout)
+        {
+            if (element->label != '\0')
+            {
+                const int color = pixels[static_cast<size_t>(2 * element->labelRow * kCanvasWidth + element->labelColumn)];
+                cells.set(left + element->labelColumn, top + element->labelRow,
+                          Cell{ static_cast<char32_t>(element->label), isPressed(*element) ? 16 : 255, color });
+            }
+        }
+        cells.text(left + 22, top + 9, "SELECT", kCaptionColor, kBodyColor);
+        cells.text(left + 32, top + 9, "START", kCaptionColor, kBodyColor);
+
+        // Status
+        int line = top + kCanvasRows + 1;
+        const std::string pad = view.connected
+            ? "Gamepad " + std::to_string(view.gamepad) + ": " + view.name
+            : "No Gamepad Connected (gamepad " + std::to_string(view.gamepad) + ")";
+        cells.text(0, line++, pad);
+        cells.text(0, line++, "Held: " + buttonList(view.logical));
+        cells.text(0, line++, "Raw:  " + rawList(view.raw));
+        cells.text(0, line++, mapping);
+        cells.text(0, line++, "Input: " + inputLabel + "    q quits", kCaptionColor);
+    }
+}
+
+int PadTui::run(Config& config, InputSource& input, const std::string& inputLabel)
+{
+    PadMapper mapper{ config };
+    const int gamepad{ config.getGPIndex() };
+    const std::string mapping{ mappingLine(mapper.getButtons()) };
+
+    // The layout comes from the default SNES map: each display index there
+    // is one element of the pad
+    std::vector<const Element*> layout;
+    for (const auto& [button, displayIndex] : ButtonMap{}.defaultSNESIndex)
+    {
+        const auto element = std::find_if(kElements.begin(), kElements.end(),
+                                          [&](const Element& e) { return e.displayIndex == displayIndex; });
+        if (element != kElements.end())
+        {
+            layout.push_back(&*element);
+        }
+    }
+
+    uint64_t frames{ 0 };
+    uint64_t cellsWritten{ 0 };
+    {
+        TerminalMode terminal;
+        if (!terminal.enter())
+        {
+            std::cerr << "--tui needs a terminal on stdin and stdout" << std::endl;
+            return 1;
+        }
+
+        gStopRequested.store(false);
+        gResized.store(true);
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        std::signal(SIGWINCH, requestResize);
+
+        CellBuffer cells;
+        View shown;
+        bool composed{ false };
+        bool connected{ false };
+        std::string out;
+
+        while (!gStopRequested.load())
+        {
+            input.update();
+            connected = mapper.pollGamepadConnection(input, gamepad);
+
+            View view;
+            view.connected = connected;
+            view.gamepad = gamepad;
+            if (connected)
+            {
+                const PadState pad = input.sample(gamepad);
+                view.name = input.getName(gamepad);
+                view.logical = mapper.getLogicalButtons(pad);
+                view.raw = pad.buttons;
+            }
+
+            bool redraw = !composed || view.connected != shown.connected || view.logical != shown.logical
+                          || view.raw != shown.raw;
+            if (gResized.exchange(false))
+            {
+                int columns;
+                int rows;
+                querySize(columns, rows);
+                cells.resize(columns, rows);
+                out += "\x1b[0m\x1b[2J";
+                redraw = true;
+            }
+            if (redraw)
+            {
+                compose(cells, layout, view, mapping, inputLabel);
+                cellsWritten += cells.flush(out);
+                ++frames;
+                writeAll(out);
+                out.clear();
+                shown = view;
+                composed = true;
+            }
+
+            // Wait for a key for up to 1 ms; the pad is read again either way
+            pollfd keys{ STDIN_FILENO, POLLIN, 0 };
+            if (poll(&keys, 1, 1) > 0 && quitPressed())
+            {
+                break;
+            }
+        }
+
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        std::signal(SIGWINCH, SIG_DFL);
+    }
+    std::cerr << "TUI drew " << frames << " frames, " << cellsWritten << " cells written" << std::endl;
+    return 0;
+}
+
+#else
+
+int PadTui::run(Config& config, InputSource& input, const std::string& inputLabel)
+{
+    (void)config;
+    (void)input;
+    (void)inputLabel;
+    std::cerr << "--tui isn't supported on Windows" << std::endl;
+    return 1;
+}
+
+#endif
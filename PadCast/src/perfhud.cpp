@@ -0,0 +1,156 @@
+#include "perfhud.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr int kFontSize{ 16 };
+    constexpr int kLineHeight{ 20 };
+    constexpr int kPadding{ 8 };
+    constexpr int kPanelWidth{ 340 };
+    constexpr int kGraphHeight{ 60 };
+    constexpr int kTextLines{ 5 };
+    constexpr double kSmoothing{ 0.05 };    // weight of the newest frame in the averages
+
+    float percentile(std::array<float, FramePacer::kHistorySize>& values, size_t count, double p)
+    {
+        const size_t rank = static_cast<size_t>(p * static_cast<double>(count - 1));
+        std::nth_element(values.begin(), values.begin() + rank, values.begin() + count);
+        return values[rank];
+    }
+}
+
+void PerfHUD::toggle()
+{
+    mVisible = !mVisible;
+    mAverageMs.fill(0.0);
+    mPhase = Phase::Count;
+}
+
+void PerfHUD::beginFrame()
+{
+    if (!mVisible)
+    {
+        return;
+    }
+    mFrameMs.fill(0.0);
+    mPhase = Phase::Count;
+}
+
+void PerfHUD::closePhase(Clock::time_point now)
+{
+    if (mPhase != Phase::Count)
+    {
+        mFrameMs[static_cast<size_t>(mPhase)] += std::chrono::duration<double, std::milli>(now - mPhaseStart).count();
+    }
+}
+
+void PerfHUD::enter(Phase phase)
+{
+    if (!mVisible)
+    {
+        return;
+    }
+    const Clock::time_point now = Clock::now();
+    closePhase(now);
+    mPhase = phase;
+    mPhaseStart = now;
+}
+
+void PerfHUD::endFrame()
+{
+    mGpuTimer.endFrame();
+    if (!mVisible)
+    {
+        return;
+    }
+    closePhase(Clock::now());
+    mPhase = Phase::Count;
+    for (size_t i = 0; i < kPhaseCount; ++i)
+    {
+        mAverageMs[i] += (mFrameMs[i] - mAverageMs[i]) * kSmoothing;
+    }
+}
+
+void PerfHUD::draw(TextCache& textCache, const FramePacer& pacer, size_t textureBytes, int screenWidth)
+{
+    if (!mVisible)
+    {
+        return;
+    }
+
+    const auto& history = pacer.getHistory();
+    const uint64_t intervals = pacer.getStats().frames > 0 ? pacer.getStats().frames - 1 : 0;
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(intervals, FramePacer::kHistorySize));
+
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float worst = 0.0f;
+    if (count > 0)
+    {
+        // Unfilled history entries sit after the newest one; only the filled ones count
+        const size_t start = count < FramePacer::kHistorySize ? 0 : pacer.getHistoryStart();
+        for (size_t i = 0; i < count; ++i)
+        {
+            mSorted[i] = history[(start + i) % FramePacer::kHistorySize];
+        }
+        worst = *std::max_element(mSorted.begin(), mSorted.begin() + count);
+        p99 = percentile(mSorted, count, 0.99);
+        p50 = percentile(mSorted, count, 0.50);
+    }
+
+    const int panelHeight = kPadding * 3 + kTextLines * kLineHeight + kGraphHeight;
+    const int x = screenWidth - kPanelWidth - kPadding;
+    const int y = kPadding;
+    DrawRectangle(x, y, kPanelWidth, panelHeight, Fade(BLACK, 0.75f));
+
+    auto ms = [this](Phase phase) { return mAverageMs[static_cast<size_t>(phase)]; };
+    char lines[kTextLines][96];
+    std::snprintf(lines[0], sizeof(lines[0]), "Frame  p50 %.2f  p99 %.2f  max %.2f ms", p50, p99, worst);
+    std::snprintf(lines[1], sizeof(lines[1]), "CPU  input %.2f  overlay %.2f  menu %.2f ms",
+                  ms(Phase::Input), ms(Phase::Overlay), ms(Phase::Menu));
+    if (mGpuTimer.isSupported())
+    {
+        std::snprintf(lines[2], sizeof(lines[2]), "Present %.2f  wait %.2f  GPU %.2f ms",
+                      ms(Phase::Present), ms(Phase::Wait), mGpuTimer.getLastMs());
+    }
+    else
+    {
+        std::snprintf(lines[2], sizeof(lines[2]), "Present %.2f  wait %.2f ms  GPU n/a",
+                      ms(Phase::Present), ms(Phase::Wait));
+    }
+    std::snprintf(lines[3], sizeof(lines[3]), "Missed deadlines %llu  skipped presents %llu",
+                  static_cast<unsigned long long>(pacer.getStats().missedDeadlines),
+                  static_cast<unsigned long long>(mSkippedPresents));
+    std::snprintf(lines[4], sizeof(lines[4]), "Textures %.1f MB",
+                  static_cast<double>(textureBytes) / (1024.0 * 1024.0));
+
+    // Graph: one bar per frame, oldest on the left. Full height is two frame
+    // periods at the paced rate (or 33 ms unpaced); the line marks one period.
+    const int graphX = x + kPadding;
+    const int graphY = y + kPadding * 2 + kTextLines * kLineHeight;
+    const int graphWidth = kPanelWidth - kPadding * 2;
+    const float periodMs = pacer.getPacedFPS() > 0 ? 1000.0f / static_cast<float>(pacer.getPacedFPS())
+                         : (pacer.getRefreshRate() > 0 ? 1000.0f / static_cast<float>(pacer.getRefreshRate()) : 16.67f);
+    const float scaleMs = periodMs * 2.0f;
+    const float barWidth = static_cast<float>(graphWidth) / static_cast<float>(FramePacer::kHistorySize);
+
+    DrawRectangle(graphX, graphY, graphWidth, kGraphHeight, Fade(DARKGRAY, 0.5f));
+    for (size_t i = 0; i < FramePacer::kHistorySize; ++i)
+    {
+        const float value = history[(pacer.getHistoryStart() + i) % FramePacer::kHistorySize];
+        const float height = std::min(value / scaleMs, 1.0f) * kGraphHeight;
+        const Color color = value > periodMs * 1.1f ? RED : LIME;
+        DrawRectangleRec(Rectangle{ graphX + barWidth * static_cast<float>(i), graphY + kGraphHeight - height,
+                                    std::max(barWidth, 1.0f), height }, color);
+    }
+    DrawLine(graphX, graphY + kGraphHeight / 2, graphX + graphWidth, graphY + kGraphHeight / 2, YELLOW);
+
+    textCache.begin();
+    for (int i = 0; i < kTextLines; ++i)
+    {
+        textCache.draw(lines[i], x + kPadding, y + kPadding + i * kLineHeight, kFontSize, WHITE);
+    }
+    textCache.end();
+}
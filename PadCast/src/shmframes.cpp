@@ -0,0 +1,355 @@
+#include "shmframes.h"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <csignal>
+    #include <linux/futex.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+#endif
+
+namespace shmframes
+{
+    namespace
+    {
+        std::string objectName(const std::string& name)
+        {
+            return name.starts_with('/') ? name : "/" + name;
+        }
+
+        size_t pageAlign(size_t bytes)
+        {
+            constexpr size_t kPage{ 4096 };
+            return (bytes + kPage - 1) / kPage * kPage;
+        }
+
+#ifdef __linux__
+        // Shared (not FUTEX_PRIVATE) ops: the word lives in a mapping other processes have too
+        long futexWait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* timeout)
+        {
+            return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+        }
+
+        void futexWakeAll(std::atomic<uint32_t>* word)
+        {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+#endif
+    }
+
+    uint64_t monotonicNs()
+    {
+#ifdef __linux__
+        timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(now.tv_nsec);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    int createObject(const std::string& object, size_t pidOffset, std::string& error)
+    {
+#ifdef __linux__
+        for (int attempt = 0; attempt < 2; ++attempt)
+        {
+            const int fd = shm_open(object.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+            if (fd >= 0)
+            {
+                return fd;
+            }
+            if (errno != EEXIST)
+            {
+                error = "can't create " + object + ": " + std::strerror(errno);
+                return -1;
+            }
+
+            // Someone has the name. If its writer is still running, leave it be.
+            uint32_t pid = 0;
+            const int existing = shm_open(object.c_str(), O_RDONLY | O_CLOEXEC, 0);
+            if (existing >= 0)
+            {
+                if (pread(existing, &pid, sizeof(pid), static_cast<off_t>(pidOffset)) != sizeof(pid))
+                {
+                    pid = 0;
+                }
+                ::close(existing);
+            }
+            const bool alive = pid != 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+            if (alive || attempt > 0)
+            {
+                error = object + " is in use by another writer (pid " + std::to_string(pid) + ")";
+                return -1;
+            }
+            // Left behind by a writer that crashed. Readers still mapping it
+            // keep the old copy; new ones get the fresh object.
+            shm_unlink(object.c_str());
+        }
+        return -1;
+#else
+        (void)object; (void)pidOffset;
+        error = "shared memory is only supported on Linux";
+        return -1;
+#endif
+    }
+
+    //$ ----- Writer ----- //
+
+    bool Writer::create(const std::string& name, uint32_t width, uint32_t height,
+                        uint32_t fpsNumerator, uint32_t fpsDenominator, std::string& error, uint32_t slots)
+    {
+        close();
+#ifdef __linux__
+        const uint32_t stride = width * 4;
+        const size_t slotBytes = pageAlign(kSlotHeaderBytes + static_cast<size_t>(stride) * height);
+        const size_t size = kHeaderBytes + slotBytes * slots;
+
+        mName = objectName(name);
+        static_assert(std::is_standard_layout_v<Header>);
+        const int fd = createObject(mName, offsetof(Header, writerPid), error);
+        if (fd < 0)
+        {
+            return false;
+        }
+        // A new object, so it starts zeroed
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            error = "can't size " + mName + ": " + std::strerror(errno);
+            ::close(fd);
+            shm_unlink(mName.c_str());
+            return false;
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "can't map " + mName + ": " + std::strerror(errno);
+            shm_unlink(mName.c_str());
+            return false;
+        }
+
+        mBase = static_cast<uint8_t*>(base);
+        mSize = size;
+        mHeader = new (mBase) Header{};
+        mHeader->version = kVersion;
+        mHeader->headerBytes = static_cast<uint32_t>(kHeaderBytes);
+        mHeader->width = width;
+        mHeader->height = height;
+        mHeader->stride = stride;
+        mHeader->slotCount = slots;
+        mHeader->slotBytes = slotBytes;
+        mHeader->fpsNumerator = fpsNumerator;
+        mHeader->fpsDenominator = fpsDenominator;
+        mHeader->writerPid = static_cast<uint32_t>(getpid());
+        for (uint32_t i = 0; i < slots; ++i)
+        {
+            new (mBase + kHeaderBytes + slotBytes * i) SlotHeader{};
+        }
+        // Magic last: a reader that sees it sees a complete header
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(mHeader->magic.data(), kMagic.data(), kMagic.size());
+        return true;
+#else
+        (void)name; (void)width; (void)height; (void)fpsNumerator; (void)fpsDenominator; (void)slots;
+        error = "shared-memory frames are only supported on Linux";
+        return false;
+#endif
+    }
+
+    void Writer::close()
+    {
+#ifdef __linux__
+        if (mHeader == nullptr)
+        {
+            return;
+        }
+        mHeader->closed.store(1, std::memory_order_release);
+        mHeader->futex.fetch_add(1);
+        futexWakeAll(&mHeader->futex);
+        munmap(mBase, mSize);
+        // Readers keep their mapping; the name is free for the next run
+        shm_unlink(mName.c_str());
+        mHeader = nullptr;
+        mBase = nullptr;
+        mSize = 0;
+        mCurrent = nullptr;
+#endif
+    }
+
+    uint8_t* Writer::beginFrame()
+    {
+        const uint64_t frame = mHeader->published.load(std::memory_order_relaxed);
+        uint8_t* slot = mBase + kHeaderBytes + mHeader->slotBytes * (frame % mHeader->slotCount);
+        mCurrent = reinterpret_cast<SlotHeader*>(slot);
+        mCurrent->sequence.store(2 * frame + 1, std::memory_order_relaxed);
+        // Odd before any pixel changes
+        std::atomic_thread_fence(std::memory_order_release);
+        return slot + kSlotHeaderBytes;
+    }
+
+    void Writer::endFrame()
+    {
+#ifdef __linux__
+        const uint64_t frame = mHeader->published.load(std::memory_order_relaxed);
+        mCurrent->frame = frame;
+        mCurrent->timestampNs = monotonicNs();
+        mCurrent->sequence.store(2 * frame + 2, std::memory_order_release);
+        mHeader->published.store(frame + 1, std::memory_order_release);
+
+        // seq_cst pairs with the reader's waiters increment: either we see it
+        // waiting, or its FUTEX_WAIT sees the new value and doesn't sleep
+        mHeader->futex.fetch_add(1);
+        if (mHeader->waiters.load() > 0)
+        {
+            futexWakeAll(&mHeader->futex);
+        }
+#endif
+    }
+
+    //$ ----- Reader ----- //
+
+    bool Reader::open(const std::string& name, std::string& error)
+    {
+        close();
+#ifdef __linux__
+        const std::string object = objectName(name);
+        const int fd = shm_open(object.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            error = "no frame ring called " + object + " (is PadCast running with --video-format shm --video-out "
+                    + name + "?)";
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kHeaderBytes)
+        {
+            ::close(fd);
+            error = "frame ring isn't set up yet";
+            return false;
+        }
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "can't map the frame ring";
+            return false;
+        }
+
+        auto* header = static_cast<Header*>(base);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->magic != kMagic || header->version != kVersion
+            || size < kHeaderBytes + header->slotBytes * header->slotCount)
+        {
+            munmap(base, size);
+            error = "not a PadCast frame ring, or from another version";
+            return false;
+        }
+        mHeader = header;
+        mBase = static_cast<const uint8_t*>(base);
+        mSize = size;
+        return true;
+#else
+        (void)name;
+        error = "shared-memory frames are only supported on Linux";
+        return false;
+#endif
+    }
+
+    void Reader::close()
+    {
+#ifdef __linux__
+        if (mHeader != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(mBase), mSize);
+        }
+#endif
+        mHeader = nullptr;
+        mBase = nullptr;
+        mSize = 0;
+    }
+
+    bool Reader::waitForFrame(uint64_t after, int timeoutMs)
+    {
+#ifdef __linux__
+        const uint64_t deadline = timeoutMs < 0 ? 0 : monotonicNs() + static_cast<uint64_t>(timeoutMs) * 1'000'000ull;
+        while (true)
+        {
+            // Futex value first: if a frame lands after this load, the wait returns at once
+            const uint32_t seen = mHeader->futex.load(std::memory_order_acquire);
+            if (mHeader->published.load(std::memory_order_acquire) > after)
+            {
+                return true;
+            }
+            if (writerClosed())
+            {
+                return false;
+            }
+
+            timespec timeout{};
+            if (timeoutMs >= 0)
+            {
+                const uint64_t now = monotonicNs();
+                if (now >= deadline)
+                {
+                    return false;
+                }
+                timeout.tv_sec = static_cast<time_t>((deadline - now) / 1'000'000'000ull);
+                timeout.tv_nsec = static_cast<long>((deadline - now) % 1'000'000'000ull);
+            }
+            mHeader->waiters.fetch_add(1);
+            futexWait(&mHeader->futex, seen, timeoutMs < 0 ? nullptr : &timeout);
+            mHeader->waiters.fetch_sub(1);
+        }
+#else
+        (void)after; (void)timeoutMs;
+        return false;
+#endif
+    }
+
+    bool Reader::latest(Frame& frame) const
+    {
+        // A few tries in case the writer laps us between the two loads
+        for (int attempt = 0; attempt < 4; ++attempt)
+        {
+            const uint64_t published = mHeader->published.load(std::memory_order_acquire);
+            if (published == 0)
+            {
+                return false;
+            }
+            const uint64_t newest = published - 1;
+            const uint8_t* slot = mBase + kHeaderBytes + mHeader->slotBytes * (newest % mHeader->slotCount);
+            const auto* slotHeader = reinterpret_cast<const SlotHeader*>(slot);
+            const uint64_t sequence = slotHeader->sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * newest + 2)
+            {
+                continue;
+            }
+            frame.pixels = slot + kSlotHeaderBytes;
+            frame.frame = slotHeader->frame;
+            frame.timestampNs = slotHeader->timestampNs;
+            frame.sequence = sequence;
+            frame.slot = slotHeader;
+            return true;
+        }
+        return false;
+    }
+
+    bool Reader::stillValid(const Frame& frame) const
+    {
+        // Reads of the pixels happen before the recheck
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return frame.slot->sequence.load(std::memory_order_relaxed) == frame.sequence;
+    }
+}
@@ -0,0 +1,224 @@
+#ifdef _WIN32
+    #define NOGDI
+    #define NOUSER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+#endif
+
+#include <raylib.h>
+
+#ifdef _WIN32
+    #undef NOGDI
+    #undef NOUSER
+#endif
+
+#include "startupreport.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#ifdef __linux__
+    #include <charconv>
+    #include <fcntl.h>
+    #include <fstream>
+    #include <sstream>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    // Process start to now, from /proc/self/stat (clock-tick resolution, ~10 ms);
+    // -1 if it can't be read
+    double msSinceProcessStart()
+    {
+        std::ifstream stat("/proc/self/stat");
+        std::string contents;
+        std::getline(stat, contents);
+        // comm (field 2) can contain spaces; fields after it start past the last ')'
+        const size_t commEnd = contents.rfind(')');
+        if (commEnd == std::string::npos)
+        {
+            return -1.0;
+        }
+        std::istringstream fields(contents.substr(commEnd + 1));
+        std::string field;
+        // starttime is field 22 overall, the 20th after comm
+        int read = 0;
+        while (read < 20 && fields >> field)
+        {
+            ++read;
+        }
+        unsigned long long startTicks = 0;
+        const auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), startTicks);
+        const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+        if (read != 20 || ec != std::errc{} || end != field.data() + field.size() || ticksPerSecond <= 0)
+        {
+            return -1.0;
+        }
+        const double startSeconds = static_cast<double>(startTicks) / static_cast<double>(ticksPerSecond);
+
+        timespec now{};
+        if (clock_gettime(CLOCK_BOOTTIME, &now) != 0)
+        {
+            return -1.0;
+        }
+        const double nowSeconds = static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1.0e9;
+        return (nowSeconds - startSeconds) * 1000.0;
+    }
+#endif
+
+    struct Span
+    {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+}
+
+StartupReport::StartupReport()
+    : mStart(Clock::now())
+    , mStartTraceNs(trace::now())
+{
+}
+
+void StartupReport::mark(Phase phase)
+{
+    const size_t i = static_cast<size_t>(phase);
+    if (!mMarked[i])
+    {
+        mTimes[i] = Clock::now();
+        mTraceNs[i] = trace::now();
+        mMarked[i] = true;
+    }
+}
+
+double StartupReport::elapsedMs(Phase phase) const
+{
+    const size_t i = static_cast<size_t>(phase);
+    if (!mMarked[i])
+    {
+        return 0.0;
+    }
+    return std::chrono::duration<double, std::milli>(mTimes[i] - mStart).count();
+}
+
+void StartupReport::log()
+{
+    if (mLogged)
+    {
+        return;
+    }
+    mLogged = true;
+
+    char gamepad[32] = "not found";
+    if (isMarked(Phase::GamepadReady))
+    {
+        std::snprintf(gamepad, sizeof(gamepad), "%.1f ms", elapsedMs(Phase::GamepadReady));
+    }
+    TraceLog(LOG_INFO, "Startup: window %.1f ms, resources %.1f ms, first frame %.1f ms, gamepad %s",
+             elapsedMs(Phase::Window), elapsedMs(Phase::Resources), elapsedMs(Phase::FirstFrame), gamepad);
+}
+
+void StartupReport::printProfile(const char* cacheState) const
+{
+    const uint64_t endNs = isMarked(Phase::FirstFrame) ? mTraceNs[static_cast<size_t>(Phase::FirstFrame)] : trace::now();
+
+    std::vector<Span> spans;
+    trace::visitThisThread([&](const char* name, uint64_t startNs, uint64_t spanEndNs) {
+        if (startNs >= mStartTraceNs && spanEndNs <= endNs)
+        {
+            spans.push_back(Span{ name, startNs, spanEndNs });
+        }
+    });
+    // Parents start first; on a tie the longer one is the parent
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+        return a.startNs != b.startNs ? a.startNs < b.startNs : a.endNs > b.endNs;
+    });
+
+    auto ms = [this](uint64_t ns) { return static_cast<double>(ns - mStartTraceNs) / 1.0e6; };
+
+    std::printf("Startup profile (%s cache)\n", cacheState);
+#ifdef __linux__
+    // Measured now, so subtract what main() has taken so far
+    const double sinceProcessStart = msSinceProcessStart();
+    if (sinceProcessStart >= 0.0)
+    {
+        const double beforeMain = sinceProcessStart - ms(trace::now());
+        std::printf("  %-44s %9.1f ms  (approx.)\n", "process start -> main()", std::max(beforeMain, 0.0));
+    }
+#endif
+    std::printf("  %-44s %9s  %9s\n", "", "at", "took");
+
+    std::vector<uint64_t> open;
+    for (const Span& span : spans)
+    {
+        while (!open.empty() && span.startNs >= open.back())
+        {
+            open.pop_back();
+        }
+        char label[64];
+        std::snprintf(label, sizeof(label), "%*s%s", static_cast<int>(open.size() * 2), "", span.name);
+        std::printf("  %-44s %9.2f  %9.2f ms\n", label, ms(span.startNs),
+                    static_cast<double>(span.endNs - span.startNs) / 1.0e6);
+        open.push_back(span.endNs);
+    }
+
+    std::printf("  %-44s %9.2f ms\n", "first frame presented", ms(endNs));
+    if (isMarked(Phase::GamepadReady))
+    {
+        std::printf("  %-44s %9.2f ms\n", "gamepad ready", elapsedMs(Phase::GamepadReady));
+    }
+    std::fflush(stdout);
+}
+
+bool StartupReport::evictFromFileCache(const std::string& path)
+{
+#ifdef __linux__
+    std::error_code error;
+    size_t evicted{ 0 };
+    size_t failed{ 0 };
+    auto evict = [&](const std::filesystem::path& file) {
+        const int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            ++failed;
+            return;
+        }
+        // Only clean pages can be dropped; these files are only ever read.
+        // posix_fadvise returns the error rather than setting errno.
+        if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0)
+        {
+            ++evicted;
+        }
+        else
+        {
+            ++failed;
+        }
+        close(fd);
+    };
+
+    if (std::filesystem::is_directory(path, error))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+        {
+            if (entry.is_regular_file(error))
+            {
+                evict(entry.path());
+            }
+        }
+    }
+    else if (std::filesystem::is_regular_file(path, error))
+    {
+        evict(path);
+    }
+    return evicted > 0 && failed == 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
@@ -0,0 +1,34 @@
+#include "taskqueue.h"
+#include "trace.h"
+
+void TaskQueue::run(Clock::duration budget)
+{
+    const Clock::time_point start = Clock::now();
+    do
+    {
+        if (mTasks.empty())
+        {
+            return;
+        }
+
+        DeferredTask task = std::move(mTasks.front());
+        mTasks.pop_front();
+        {
+            PADCAST_TRACE_SCOPE("Deferred task slice");
+            task.resume();
+        }
+        // Tasks posted from inside the slice land behind this one
+        if (!task.done())
+        {
+            mTasks.push_back(std::move(task));
+        }
+    } while (Clock::now() - start < budget);
+}
+
+void TaskQueue::drain()
+{
+    while (!mTasks.empty())
+    {
+        run(Clock::duration::max());
+    }
+}
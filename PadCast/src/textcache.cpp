@@ -0,0 +1,31 @@
+#include "textcache.h"
+
+const TextCache::Entry& TextCache::getEntry(const char* text, int fontSize)
+{
+    auto it = mEntries.find(KeyView{ text, fontSize });
+    if (it != mEntries.end())
+    {
+        return it->second;
+    }
+
+    if (mEntries.size() >= kMaxEntries)
+    {
+        clear();
+    }
+
+    const Vector2 size = mFont.measure(text, static_cast<float>(fontSize));
+    Entry entry{ static_cast<int>(size.x), static_cast<int>(size.y) };
+
+    return mEntries.emplace(std::pair{ std::string{ text }, fontSize }, entry).first->second;
+}
+
+void TextCache::draw(const char* text, int posX, int posY, int fontSize, Color tint) const
+{
+    mFont.draw(text, Vector2{ static_cast<float>(posX), static_cast<float>(posY) },
+               static_cast<float>(fontSize), tint);
+}
+
+int TextCache::measure(const char* text, int fontSize)
+{
+    return getEntry(text, fontSize).width;
+}
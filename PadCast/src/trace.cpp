@@ -0,0 +1,257 @@
+#include "trace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace
+{
+    namespace
+    {
+        struct Event
+        {
+            const char* name;
+            uint64_t startNs;
+            uint64_t endNs;
+        };
+
+        // ~10 s of main loop at 240 FPS with a dozen markers per frame
+        constexpr size_t kRingSize{ 32768 };
+
+        struct ThreadRing
+        {
+            std::array<Event, kRingSize> events{};
+            // Total ever written; the writer publishes with release so a
+            // dump only reads complete events
+            std::atomic<uint64_t> written{ 0 };
+            char threadName[32]{};
+            int tid{ 0 };
+            bool inUse{ false };
+        };
+
+        // Events of a thread that has exited, copied out of its ring so the
+        // ring can go to the next thread
+        struct RetiredThread
+        {
+            char threadName[32]{};
+            int tid{ 0 };
+            std::vector<Event> events;
+        };
+
+        // Exited threads keep at most this many events in all, oldest threads dropped first
+        constexpr size_t kRetiredEventLimit{ kRingSize };
+
+        std::mutex gRegistryMutex;
+        std::vector<std::unique_ptr<ThreadRing>> gRings;	// in use or free for the next thread
+        std::deque<RetiredThread> gRetired;
+        size_t gRetiredEvents{ 0 };
+        int gNextTid{ 1 };
+        const std::chrono::steady_clock::time_point gEpoch{ std::chrono::steady_clock::now() };
+
+        // Set before or after the ring exists; the ring picks it up either way
+        thread_local char tThreadName[32]{};
+        thread_local ThreadRing* tRing{ nullptr };
+
+        // Hands the thread's ring back when the thread exits. Short-lived
+        // threads (e.g. each config save's std::async) would otherwise each
+        // keep a ring forever.
+        struct RingReturn
+        {
+            ~RingReturn()
+            {
+                if (!tRing)
+                {
+                    return;
+                }
+                std::lock_guard lock(gRegistryMutex);
+                const uint64_t written = tRing->written.load(std::memory_order_relaxed);
+                const uint64_t available = written < kRingSize ? written : kRingSize;
+                if (available > 0)
+                {
+                    RetiredThread retired;
+                    std::snprintf(retired.threadName, sizeof(retired.threadName), "%s", tRing->threadName);
+                    retired.tid = tRing->tid;
+                    retired.events.reserve(static_cast<size_t>(available));
+                    for (uint64_t i = written - available; i < written; ++i)
+                    {
+                        retired.events.push_back(tRing->events[i % kRingSize]);
+                    }
+                    gRetiredEvents += retired.events.size();
+                    gRetired.push_back(std::move(retired));
+                    while (gRetiredEvents > kRetiredEventLimit && gRetired.size() > 1)
+                    {
+                        gRetiredEvents -= gRetired.front().events.size();
+                        gRetired.pop_front();
+                    }
+                }
+                tRing->inUse = false;
+                tRing = nullptr;
+            }
+        };
+        thread_local RingReturn tRingReturn;
+
+        ThreadRing& threadRing()
+        {
+            // Taken on the thread's first event: a free ring if there is
+            // one, else a new one. Given back by RingReturn at thread exit.
+            if (!tRing)
+            {
+                (void)tRingReturn;	// first use registers its destructor for this thread
+                std::lock_guard lock(gRegistryMutex);
+                ThreadRing* ring{ nullptr };
+                for (const auto& candidate : gRings)
+                {
+                    if (!candidate->inUse)
+                    {
+                        ring = candidate.get();
+                        break;
+                    }
+                }
+                if (!ring)
+                {
+                    gRings.push_back(std::make_unique<ThreadRing>());
+                    ring = gRings.back().get();
+                }
+                ring->inUse = true;
+                ring->written.store(0, std::memory_order_relaxed);
+                ring->tid = gNextTid++;
+                if (tThreadName[0] != '\0')
+                {
+                    std::snprintf(ring->threadName, sizeof(ring->threadName), "%s", tThreadName);
+                }
+                else
+                {
+                    std::snprintf(ring->threadName, sizeof(ring->threadName), "thread %d", ring->tid);
+                }
+                tRing = ring;
+            }
+            return *tRing;
+        }
+
+        void writeEscaped(std::FILE* file, const char* text)
+        {
+            for (const char* c = text; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    std::fputc('\\', file);
+                }
+                std::fputc(*c, file);
+            }
+        }
+
+        void writeThreadName(std::FILE* file, bool first, int tid, const char* threadName)
+        {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                         first ? "" : ",\n", tid);
+            writeEscaped(file, threadName);
+            std::fputs("\"}}", file);
+        }
+
+        void writeEvent(std::FILE* file, int tid, const Event& event)
+        {
+            std::fputs(",\n{\"name\":\"", file);
+            writeEscaped(file, event.name);
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         tid, static_cast<double>(event.startNs) / 1000.0,
+                         static_cast<double>(event.endNs - event.startNs) / 1000.0);
+        }
+    }
+
+    namespace detail
+    {
+        std::atomic<bool> gEnabled{ false };
+
+        uint64_t now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - gEpoch).count());
+        }
+
+        void record(const char* name, uint64_t startNs, uint64_t endNs)
+        {
+            ThreadRing& ring = threadRing();
+            const uint64_t index = ring.written.load(std::memory_order_relaxed);
+            ring.events[index % kRingSize] = Event{ name, startNs, endNs };
+            ring.written.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    void setEnabled(bool enabled)
+    {
+        detail::gEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void setThreadName(const char* name)
+    {
+        std::snprintf(tThreadName, sizeof(tThreadName), "%s", name);
+        if (tRing)
+        {
+            std::lock_guard lock(gRegistryMutex);
+            std::snprintf(tRing->threadName, sizeof(tRing->threadName), "%s", name);
+        }
+    }
+
+    void visitThisThread(const Visitor& visitor)
+    {
+        if (!tRing)
+        {
+            return;
+        }
+        const uint64_t written = tRing->written.load(std::memory_order_relaxed);
+        const uint64_t available = written < kRingSize ? written : kRingSize;
+        for (uint64_t i = written - available; i < written; ++i)
+        {
+            const Event& event = tRing->events[i % kRingSize];
+            visitor(event.name, event.startNs, event.endNs);
+        }
+    }
+
+    bool dump(const std::string& path)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file)
+        {
+            return false;
+        }
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+        bool first = true;
+
+        std::lock_guard lock(gRegistryMutex);
+        for (const RetiredThread& retired : gRetired)
+        {
+            writeThreadName(file, first, retired.tid, retired.threadName);
+            first = false;
+            for (const Event& event : retired.events)
+            {
+                writeEvent(file, retired.tid, event);
+            }
+        }
+        for (const auto& ring : gRings)
+        {
+            if (!ring->inUse)
+            {
+                continue;
+            }
+            writeThreadName(file, first, ring->tid, ring->threadName);
+            first = false;
+
+            // Other threads may keep recording meanwhile; only the oldest
+            // entries can be overwritten under us, so skip a margin of them
+            const uint64_t written = ring->written.load(std::memory_order_acquire);
+            const uint64_t available = written < kRingSize ? written : kRingSize - 64;
+            for (uint64_t i = written - available; i < written; ++i)
+            {
+                writeEvent(file, ring->tid, ring->events[i % kRingSize]);
+            }
+        }
+
+        std::fputs("\n]}\n", file);
+        return std::fclose(file) == 0;
+    }
+}
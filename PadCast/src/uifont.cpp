@@ -0,0 +1,103 @@
+#include "uifont.h"
+#include "pathmanager.h"
+#include "trace.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Default vertex shader is fine, only the fragment stage needs to know about SDFs
+    constexpr const char* kSDFFragmentShader = R"(
+#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+
+void main()
+{
+    float distanceFromOutline = texture(texture0, fragTexCoord).a - 0.5;
+    float distanceChangePerFragment = max(length(vec2(dFdx(distanceFromOutline), dFdy(distanceFromOutline))), 0.0001);
+    float alpha = smoothstep(-distanceChangePerFragment, distanceChangePerFragment, distanceFromOutline);
+    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
+)";
+}
+
+UIFont::UIFont()
+{
+    PADCAST_TRACE_SCOPE("UIFont load");
+    const std::string fontPath = PathManager::getResourcePath("fonts/Lato-Regular.ttf");
+
+    int fileSize = 0;
+    unsigned char* fileData = LoadFileData(fontPath.c_str(), &fileSize);
+    if (fileData == nullptr)
+    {
+        TraceLog(LOG_WARNING, "UI font not found at %s, using default font", fontPath.c_str());
+        mFont = GetFontDefault();
+        return;
+    }
+
+    mFont.baseSize = kAtlasFontSize;
+    mFont.glyphCount = kGlyphCount;
+    mFont.glyphs = LoadFontData(fileData, fileSize, kAtlasFontSize, nullptr, 0, FONT_SDF);
+    UnloadFileData(fileData);
+
+    if (mFont.glyphs == nullptr)
+    {
+        TraceLog(LOG_WARNING, "Failed to generate SDF glyphs from %s, using default font", fontPath.c_str());
+        mFont = GetFontDefault();
+        return;
+    }
+
+    Image atlas = GenImageFontAtlas(mFont.glyphs, &mFont.recs, kGlyphCount, kAtlasFontSize, 0, 1);
+    mFont.texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    SetTextureFilter(mFont.texture, TEXTURE_FILTER_BILINEAR);
+
+    mShader = LoadShaderFromMemory(nullptr, kSDFFragmentShader);
+    mIsSDF = IsShaderValid(mShader);
+    if (!mIsSDF)
+    {
+        TraceLog(LOG_WARNING, "SDF shader failed to compile, using default font");
+        UnloadFont(mFont);
+        mFont = GetFontDefault();
+    }
+}
+
+UIFont::~UIFont()
+{
+    // The default font belongs to raylib, only unload what we generated
+    if (mIsSDF)
+    {
+        UnloadShader(mShader);
+        UnloadFont(mFont);
+    }
+}
+
+void UIFont::begin() const
+{
+    if (mIsSDF)
+    {
+        BeginShaderMode(mShader);
+    }
+}
+
+void UIFont::end() const
+{
+    if (mIsSDF)
+    {
+        EndShaderMode();
+    }
+}
+
+void UIFont::draw(const char* text, Vector2 position, float fontSize, Color tint) const
+{
+    DrawTextEx(mFont, text, position, fontSize, spacingFor(fontSize), tint);
+}
+
+Vector2 UIFont::measure(const char* text, float fontSize) const
+{
+    return MeasureTextEx(mFont, text, fontSize, spacingFor(fontSize));
+}
@@ -0,0 +1,456 @@
+#include "videooutput.h"
+#include "glfwbridge.h"
+#include "trace.h"
+#include "y4m.h"
+
+#include <rlgl.h>
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #define PADCAST_GLAPI __stdcall
+#else
+    #include <csignal>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define PADCAST_GLAPI
+#endif
+
+namespace
+{
+    constexpr unsigned int GL_RGBA_ID{ 0x1908 };
+    constexpr unsigned int GL_UNSIGNED_BYTE_ID{ 0x1401 };
+    constexpr unsigned int GL_PIXEL_PACK_BUFFER_ID{ 0x88EB };
+    constexpr unsigned int GL_STREAM_READ_ID{ 0x88E1 };
+    constexpr unsigned int GL_MAP_READ_BIT_ID{ 0x0001 };
+
+    using ReadPixelsFn = void (PADCAST_GLAPI*)(int, int, int, int, unsigned int, unsigned int, void*);
+    using GenBuffersFn = void (PADCAST_GLAPI*)(int, unsigned int*);
+    using DeleteBuffersFn = void (PADCAST_GLAPI*)(int, const unsigned int*);
+    using BindBufferFn = void (PADCAST_GLAPI*)(unsigned int, unsigned int);
+    using BufferDataFn = void (PADCAST_GLAPI*)(unsigned int, ptrdiff_t, const void*, unsigned int);
+    using MapBufferRangeFn = void* (PADCAST_GLAPI*)(unsigned int, ptrdiff_t, ptrdiff_t, unsigned int);
+    using UnmapBufferFn = unsigned char (PADCAST_GLAPI*)(unsigned int);
+
+    ReadPixelsFn glReadPixelsPtr{ nullptr };
+    GenBuffersFn glGenBuffersPtr{ nullptr };
+    DeleteBuffersFn glDeleteBuffersPtr{ nullptr };
+    BindBufferFn glBindBufferPtr{ nullptr };
+    BufferDataFn glBufferDataPtr{ nullptr };
+    MapBufferRangeFn glMapBufferRangePtr{ nullptr };
+    UnmapBufferFn glUnmapBufferPtr{ nullptr };
+
+    template <typename Fn>
+    bool load(Fn& fn, const char* name)
+    {
+        fn = reinterpret_cast<Fn>(glfwGetProcAddress(name));
+        return fn != nullptr;
+    }
+
+    void putLE32(uint8_t* out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void logToStderr(int logLevel, const char* text, va_list args)
+    {
+        const char* prefix = "";
+        switch (logLevel)
+        {
+        case LOG_TRACE: prefix = "TRACE: "; break;
+        case LOG_DEBUG: prefix = "DEBUG: "; break;
+        case LOG_INFO: prefix = "INFO: "; break;
+        case LOG_WARNING: prefix = "WARNING: "; break;
+        case LOG_ERROR: prefix = "ERROR: "; break;
+        case LOG_FATAL: prefix = "FATAL: "; break;
+        default: break;
+        }
+        std::fputs(prefix, stderr);
+        std::vfprintf(stderr, text, args);
+        std::fputc('\n', stderr);
+    }
+}
+
+void VideoOutput::moveLogsToStderr()
+{
+    SetTraceLogCallback(logToStderr);
+    std::cout.rdbuf(std::cerr.rdbuf());
+}
+
+bool VideoOutput::open(const std::string& path, Format format, int width, int height, double fps)
+{
+    close();
+
+    if (!load(glReadPixelsPtr, "glReadPixels"))
+    {
+        TraceLog(LOG_WARNING, "Video output: glReadPixels isn't available");
+        return false;
+    }
+    mUsePbo = load(glGenBuffersPtr, "glGenBuffers")
+        && load(glDeleteBuffersPtr, "glDeleteBuffers")
+        && load(glBindBufferPtr, "glBindBuffer")
+        && load(glBufferDataPtr, "glBufferData")
+        && load(glMapBufferRangePtr, "glMapBufferRange")
+        && load(glUnmapBufferPtr, "glUnmapBuffer");
+
+    mPath = path;
+    mFormat = format;
+    mFps = fps;
+    // 4:2:0 needs even dimensions; keep both formats the same size
+    mWidth = width + (width & 1);
+    mHeight = height + (height & 1);
+    mTarget = LoadRenderTexture(mWidth, mHeight);
+    if (mTarget.id == 0)
+    {
+        TraceLog(LOG_WARNING, "Video output: can't create a %dx%d render target", mWidth, mHeight);
+        return false;
+    }
+
+    const size_t frameBytes = static_cast<size_t>(mWidth) * mHeight * 4;
+    if (mUsePbo)
+    {
+        glGenBuffersPtr(2, mPbo.data());
+        for (unsigned int pbo : mPbo)
+        {
+            glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, pbo);
+            glBufferDataPtr(GL_PIXEL_PACK_BUFFER_ID, static_cast<ptrdiff_t>(frameBytes), nullptr, GL_STREAM_READ_ID);
+        }
+        glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, 0);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "Video output: no pixel buffer objects, reading frames back synchronously");
+        mSyncPixels.resize(frameBytes);
+    }
+    mPboPending = {};
+    mFrameIndex = 0;
+
+    mWritten.store(0, std::memory_order_relaxed);
+    mDropped.store(0, std::memory_order_relaxed);
+
+    if (mFormat == Format::Shm)
+    {
+        long long numerator = 0;
+        long long denominator = 1;
+        y4m::frameRate(mFps, numerator, denominator);
+        std::string error;
+        if (!mShared.create(mPath, static_cast<uint32_t>(mWidth), static_cast<uint32_t>(mHeight),
+                            static_cast<uint32_t>(numerator), static_cast<uint32_t>(denominator), error))
+        {
+            TraceLog(LOG_WARNING, "Video output: can't create shared-memory frames \"%s\": %s", mPath.c_str(),
+                     error.c_str());
+            close();
+            return false;
+        }
+        // Readers come and go on their own; the ring is always live
+        mStreaming.store(true, std::memory_order_release);
+        TraceLog(LOG_INFO, "Video output: %dx%d RGBA at %.3g FPS to shared memory \"%s\"", mWidth, mHeight,
+                 mFps, mPath.c_str());
+        return true;
+    }
+
+    mFree.clear();
+    mReady.clear();
+    for (size_t i = 0; i < kBufferCount; ++i)
+    {
+        mBuffers[i].resize(frameBytes);
+        mFree.push_back(i);
+    }
+
+    if (mPath == "-")
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+#ifndef _WIN32
+    // A reader that goes away should end the stream, not the process
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    mStopping = false;
+    mFinished.store(false, std::memory_order_relaxed);
+    mThread = std::thread(&VideoOutput::run, this);
+    TraceLog(LOG_INFO, "Video output: %dx%d %s at %.3g FPS to %s", mWidth, mHeight,
+             mFormat == Format::Y4m ? "Y4M" : "RGBA", mFps, mPath == "-" ? "stdout" : mPath.c_str());
+    return true;
+}
+
+void VideoOutput::close()
+{
+    if (mThread.joinable())
+    {
+        {
+            std::lock_guard lock{ mMutex };
+            mStopping = true;
+        }
+        mWake.notify_all();
+#ifndef _WIN32
+        // The writer may be blocked opening a FIFO nobody reads; connecting to
+        // it ourselves for a moment lets that open return
+        while (!mFinished.load(std::memory_order_acquire))
+        {
+            if (mOpening.load(std::memory_order_acquire))
+            {
+                const int fd = ::open(mPath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+                while (fd >= 0 && mOpening.load(std::memory_order_acquire))
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+#endif
+        mThread.join();
+        TraceLog(LOG_INFO, "Video output closed: %llu frames written, %llu dropped",
+                 static_cast<unsigned long long>(getFramesWritten()),
+                 static_cast<unsigned long long>(getFramesDropped()));
+    }
+    if (mShared.isOpen())
+    {
+        mShared.close();
+        TraceLog(LOG_INFO, "Video output closed: %llu frames published",
+                 static_cast<unsigned long long>(getFramesWritten()));
+    }
+    if (mUsePbo && mPbo[0] != 0)
+    {
+        glDeleteBuffersPtr(2, mPbo.data());
+        mPbo = {};
+    }
+    if (mTarget.id != 0)
+    {
+        UnloadRenderTexture(mTarget);
+        mTarget = RenderTexture2D{};
+    }
+    mStreaming.store(false, std::memory_order_relaxed);
+}
+
+void VideoOutput::beginFrame()
+{
+    BeginTextureMode(mTarget);
+}
+
+void VideoOutput::endFrame()
+{
+    PADCAST_TRACE_SCOPE("Video readback");
+    rlDrawRenderBatchActive();
+
+    // Nobody reading yet (or any more): don't spend GPU bandwidth on it
+    if (!mStreaming.load(std::memory_order_acquire))
+    {
+        EndTextureMode();
+        return;
+    }
+
+    if (!mUsePbo)
+    {
+        glReadPixelsPtr(0, 0, mWidth, mHeight, GL_RGBA_ID, GL_UNSIGNED_BYTE_ID, mSyncPixels.data());
+        EndTextureMode();
+        queueFrame(mSyncPixels.data());
+        return;
+    }
+
+    // Start this frame's copy; with a pack buffer bound it returns immediately
+    const size_t current = mFrameIndex % 2;
+    glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, mPbo[current]);
+    glReadPixelsPtr(0, 0, mWidth, mHeight, GL_RGBA_ID, GL_UNSIGNED_BYTE_ID, nullptr);
+    glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, 0);
+    mPboPending[current] = true;
+    EndTextureMode();
+
+    // ...and take the previous one, which has had a frame to land
+    collect(1 - current);
+    ++mFrameIndex;
+}
+
+void VideoOutput::collect(size_t pbo)
+{
+    if (!mPboPending[pbo])
+    {
+        return;
+    }
+    mPboPending[pbo] = false;
+
+    const size_t frameBytes = static_cast<size_t>(mWidth) * mHeight * 4;
+    glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, mPbo[pbo]);
+    const void* pixels = glMapBufferRangePtr(GL_PIXEL_PACK_BUFFER_ID, 0, static_cast<ptrdiff_t>(frameBytes),
+                                             GL_MAP_READ_BIT_ID);
+    if (pixels != nullptr)
+    {
+        queueFrame(static_cast<const uint8_t*>(pixels));
+        glUnmapBufferPtr(GL_PIXEL_PACK_BUFFER_ID);
+    }
+    glBindBufferPtr(GL_PIXEL_PACK_BUFFER_ID, 0);
+}
+
+void VideoOutput::queueFrame(const uint8_t* pixels)
+{
+    if (mShared.isOpen())
+    {
+        publishFrame(pixels);
+        return;
+    }
+
+    size_t index = 0;
+    {
+        std::lock_guard lock{ mMutex };
+        if (mFree.empty())
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        index = mFree.front();
+        mFree.pop_front();
+    }
+    std::memcpy(mBuffers[index].data(), pixels, mBuffers[index].size());
+    {
+        std::lock_guard lock{ mMutex };
+        mReady.push_back(index);
+    }
+    mWake.notify_one();
+}
+
+void VideoOutput::publishFrame(const uint8_t* pixels)
+{
+    PADCAST_TRACE_SCOPE("Video publish");
+    // The one copy: from the mapped buffer into the ring, flipped to top-down
+    const size_t stride = static_cast<size_t>(mWidth) * 4;
+    const uint8_t* lastRow = pixels + stride * static_cast<size_t>(mHeight - 1);
+    uint8_t* out = mShared.beginFrame();
+    for (int y = 0; y < mHeight; ++y)
+    {
+        std::memcpy(out + stride * static_cast<size_t>(y), lastRow - stride * static_cast<size_t>(y), stride);
+    }
+    mShared.endFrame();
+    mWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool VideoOutput::writeHeader()
+{
+    if (mFormat == Format::Y4m)
+    {
+        const std::string header = y4m::header(mWidth, mHeight, mFps);
+        return std::fwrite(header.data(), 1, header.size(), mFile) == header.size();
+    }
+
+    long long numerator = 0;
+    long long denominator = 1;
+    y4m::frameRate(mFps, numerator, denominator);
+    std::array<uint8_t, kRgbaHeaderSize> header{};
+    std::memcpy(header.data(), "PCRAWVID", 8);
+    putLE32(header.data() + 8, static_cast<uint32_t>(mWidth));
+    putLE32(header.data() + 12, static_cast<uint32_t>(mHeight));
+    putLE32(header.data() + 16, static_cast<uint32_t>(numerator));
+    putLE32(header.data() + 20, static_cast<uint32_t>(denominator));
+    putLE32(header.data() + 24, 4);
+    return std::fwrite(header.data(), 1, header.size(), mFile) == header.size();
+}
+
+bool VideoOutput::writeFrame(const std::vector<uint8_t>& pixels)
+{
+    // GL rows are bottom-up; both formats go top-down
+    const ptrdiff_t stride = static_cast<ptrdiff_t>(mWidth) * 4;
+    const uint8_t* lastRow = pixels.data() + stride * (mHeight - 1);
+    if (mFormat == Format::Y4m)
+    {
+        y4m::encodeFrame(lastRow, -stride, mWidth, mHeight, mEncoded);
+        return std::fwrite(mEncoded.data(), 1, mEncoded.size(), mFile) == mEncoded.size();
+    }
+
+    for (int y = 0; y < mHeight; ++y)
+    {
+        if (std::fwrite(lastRow - stride * y, 1, static_cast<size_t>(stride), mFile) != static_cast<size_t>(stride))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void VideoOutput::run()
+{
+    trace::setThreadName("VideoOutput");
+
+    // Opening a FIFO blocks until a reader shows up, which is why it happens here
+    mOpening.store(true, std::memory_order_release);
+    mFile = mPath == "-" ? stdout : std::fopen(mPath.c_str(), "wb");
+    mOpening.store(false, std::memory_order_release);
+    if (mFile == nullptr)
+    {
+        TraceLog(LOG_WARNING, "Video output: can't open %s", mPath.c_str());
+        mFinished.store(true, std::memory_order_release);
+        return;
+    }
+    if (mFile != stdout)
+    {
+        // Frames are big; write them in few syscalls
+        mFileBuffer.resize(1 << 20);
+        std::setvbuf(mFile, mFileBuffer.data(), _IOFBF, mFileBuffer.size());
+    }
+
+    bool ok{ false };
+    bool cancelled{ false };
+    {
+        std::lock_guard lock{ mMutex };
+        // close() while we were waiting for a reader
+        cancelled = mStopping;
+        ok = !cancelled && writeHeader() && std::fflush(mFile) == 0;
+    }
+    mStreaming.store(ok, std::memory_order_release);
+
+    std::unique_lock lock{ mMutex };
+    while (ok)
+    {
+        mWake.wait(lock, [this] { return mStopping || !mReady.empty(); });
+        if (mReady.empty())
+        {
+            break;	// stopping, and everything queued is written
+        }
+        const size_t index = mReady.front();
+        mReady.pop_front();
+        lock.unlock();
+
+        {
+            PADCAST_TRACE_SCOPE("Video write");
+            // Flushed per frame so a pipe reader sees each frame as soon as it's done
+            ok = writeFrame(mBuffers[index]) && std::fflush(mFile) == 0;
+        }
+        if (ok)
+        {
+            mWritten.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        lock.lock();
+        mFree.push_back(index);
+    }
+    lock.unlock();
+
+    if (!ok && !cancelled)
+    {
+        TraceLog(LOG_WARNING, "Video output: writing to %s failed (reader closed?), stream stopped",
+                 mPath == "-" ? "stdout" : mPath.c_str());
+    }
+    mStreaming.store(false, std::memory_order_release);
+    if (mFile != stdout)
+    {
+        std::fclose(mFile);
+    }
+    else
+    {
+        std::fflush(mFile);
+    }
+    mFile = nullptr;
+    mFinished.store(true, std::memory_order_release);
+}
@@ -0,0 +1,392 @@
+#include "virtualgamepad.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    constexpr std::array<std::pair<std::string_view, int>, 17> kButtonNames{ {
+        { "UP", GAMEPAD_BUTTON_LEFT_FACE_UP },
+        { "RIGHT", GAMEPAD_BUTTON_LEFT_FACE_RIGHT },
+        { "DOWN", GAMEPAD_BUTTON_LEFT_FACE_DOWN },
+        { "LEFT", GAMEPAD_BUTTON_LEFT_FACE_LEFT },
+        { "X", GAMEPAD_BUTTON_RIGHT_FACE_UP },
+        { "A", GAMEPAD_BUTTON_RIGHT_FACE_RIGHT },
+        { "B", GAMEPAD_BUTTON_RIGHT_FACE_DOWN },
+        { "Y", GAMEPAD_BUTTON_RIGHT_FACE_LEFT },
+        { "L", GAMEPAD_BUTTON_LEFT_TRIGGER_1 },
+        { "L2", GAMEPAD_BUTTON_LEFT_TRIGGER_2 },
+        { "R", GAMEPAD_BUTTON_RIGHT_TRIGGER_1 },
+        { "R2", GAMEPAD_BUTTON_RIGHT_TRIGGER_2 },
+        { "SELECT", GAMEPAD_BUTTON_MIDDLE_LEFT },
+        { "GUIDE", GAMEPAD_BUTTON_MIDDLE },
+        { "START", GAMEPAD_BUTTON_MIDDLE_RIGHT },
+        { "L3", GAMEPAD_BUTTON_LEFT_THUMB },
+        { "R3", GAMEPAD_BUTTON_RIGHT_THUMB },
+    } };
+
+    // Same threshold PadState::sampleNow() uses for the analog triggers
+    constexpr float kTriggerThreshold{ 0.1f };
+
+    bool parseNumber(const std::string& text, double& out)
+    {
+        if (text.empty())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        out = std::strtod(text.c_str(), &end);
+        return end == text.c_str() + text.size() && std::isfinite(out);
+    }
+}
+
+VirtualGamepad::VirtualGamepad()
+{
+    restart();
+}
+
+int VirtualGamepad::parseButton(const std::string& name)
+{
+    std::string upper{ name };
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    for (const auto& [buttonName, button] : kButtonNames)
+    {
+        if (upper == buttonName)
+        {
+            return button;
+        }
+    }
+
+    double number = 0.0;
+    if (parseNumber(name, number) && number == std::floor(number)
+        && number >= static_cast<int>(GAMEPAD_BUTTON_LEFT_FACE_UP)
+        && number <= static_cast<int>(GAMEPAD_BUTTON_RIGHT_THUMB))
+    {
+        return static_cast<int>(number);
+    }
+    return -1;
+}
+
+bool VirtualGamepad::loadScript(const std::string& path, std::string& error)
+{
+    std::ifstream file{ path };
+    if (!file)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return parseScript(text.str(), error);
+}
+
+bool VirtualGamepad::parseScript(const std::string& text, std::string& error)
+{
+    VirtualGamepad staging;	// storms expand through addStorm()
+
+    std::istringstream lines{ text };
+    std::string line;
+    int lineNumber = 0;
+    auto fail = [&](const std::string& what) {
+        error = "line " + std::to_string(lineNumber) + ": " + what;
+        return false;
+    };
+
+    int index = 0;
+    double loopMs = 0.0;
+    double fixedStepMs = 0.0;
+
+    while (std::getline(lines, line))
+    {
+        ++lineNumber;
+        if (const size_t hash = line.find('#'); hash != std::string::npos)
+        {
+            line.erase(hash);
+        }
+
+        std::istringstream words{ line };
+        std::vector<std::string> tokens;
+        for (std::string word; words >> word;)
+        {
+            tokens.push_back(word);
+        }
+        if (tokens.empty())
+        {
+            continue;
+        }
+
+        double number = 0.0;
+        if (tokens[0] == "index" || tokens[0] == "loop" || tokens[0] == "fixed_step")
+        {
+            if (tokens.size() != 2 || !parseNumber(tokens[1], number) || number < 0.0)
+            {
+                return fail("expected '" + tokens[0] + " <non-negative number>'");
+            }
+            if (tokens[0] == "index")
+            {
+                index = static_cast<int>(number);
+            }
+            else if (tokens[0] == "loop")
+            {
+                loopMs = number;
+            }
+            else
+            {
+                fixedStepMs = number;
+            }
+            continue;
+        }
+
+        double timeMs = 0.0;
+        if (!parseNumber(tokens[0], timeMs) || timeMs < 0.0)
+        {
+            return fail("expected a time in ms, got '" + tokens[0] + "'");
+        }
+        if (tokens.size() < 2)
+        {
+            return fail("missing command after the time");
+        }
+
+        const std::string& command = tokens[1];
+        if (command == "press" || command == "release")
+        {
+            if (tokens.size() != 3)
+            {
+                return fail("expected '" + command + " <button>'");
+            }
+            const int button = parseButton(tokens[2]);
+            if (button < 0)
+            {
+                return fail("unknown button '" + tokens[2] + "'");
+            }
+            staging.add({ timeMs, command == "press" ? EventType::Press : EventType::Release, button, 0.0f });
+        }
+        else if (command == "axis")
+        {
+            double axis = 0.0;
+            double value = 0.0;
+            if (tokens.size() != 4 || !parseNumber(tokens[2], axis) || !parseNumber(tokens[3], value)
+                || axis < 0.0 || axis >= PadState::kAxisCount)
+            {
+                return fail("expected 'axis <0-5> <value>'");
+            }
+            staging.add({ timeMs, EventType::Axis, static_cast<int>(axis), static_cast<float>(value) });
+        }
+        else if (command == "connect" || command == "disconnect")
+        {
+            staging.add({ timeMs, command == "connect" ? EventType::Connect : EventType::Disconnect, 0, 0.0f });
+        }
+        else if (command == "glitch")
+        {
+            double durationMs = 0.0;
+            if (tokens.size() != 3 || !parseNumber(tokens[2], durationMs) || durationMs < 0.0)
+            {
+                return fail("expected 'glitch <duration ms>'");
+            }
+            staging.add({ timeMs, EventType::Disconnect, 0, 0.0f });
+            staging.add({ timeMs + durationMs, EventType::Connect, 0, 0.0f });
+        }
+        else if (command == "storm")
+        {
+            double durationMs = 0.0;
+            double rateHz = 0.0;
+            if (tokens.size() < 5 || !parseNumber(tokens[2], durationMs) || !parseNumber(tokens[3], rateHz)
+                || durationMs < 0.0 || rateHz <= 0.0)
+            {
+                return fail("expected 'storm <duration ms> <rate Hz> <button> [button...]'");
+            }
+            std::vector<int> buttons;
+            for (size_t i = 4; i < tokens.size(); ++i)
+            {
+                const int button = parseButton(tokens[i]);
+                if (button < 0)
+                {
+                    return fail("unknown button '" + tokens[i] + "'");
+                }
+                buttons.push_back(button);
+            }
+            staging.addStorm(timeMs, durationMs, rateHz, buttons);
+        }
+        else
+        {
+            return fail("unknown command '" + command + "'");
+        }
+    }
+
+    mEvents = std::move(staging.mEvents);
+    mSorted = false;
+    mIndex = index;
+    mLoopMs = loopMs;
+    mFixedStepMs = fixedStepMs;
+    restart();
+    return true;
+}
+
+void VirtualGamepad::add(const Event& event)
+{
+    mEvents.push_back(event);
+    mSorted = false;
+}
+
+void VirtualGamepad::addStorm(double startMs, double durationMs, double rateHz, const std::vector<int>& buttons)
+{
+    if (buttons.empty() || rateHz <= 0.0)
+    {
+        return;
+    }
+    // Each tick presses the next button and releases it half a period later
+    const double periodMs = 1000.0 / rateHz;
+    size_t tick = 0;
+    for (double t = startMs; t < startMs + durationMs; t = startMs + periodMs * static_cast<double>(++tick))
+    {
+        const int button = buttons[tick % buttons.size()];
+        add({ t, EventType::Press, button, 0.0f });
+        add({ t + periodMs / 2.0, EventType::Release, button, 0.0f });
+    }
+}
+
+void VirtualGamepad::restart()
+{
+    mStart = Clock::now();
+    mNowMs = 0.0;
+    mLoopBaseMs = 0.0;
+    mNext = 0;
+    mConnected = false;
+    mButtons = 0;
+    mAxes = {};
+    mLastPressed = 0;
+}
+
+void VirtualGamepad::sortEvents()
+{
+    // Stable so same-time events keep script order (a press then release at t stays a tap)
+    std::stable_sort(mEvents.begin(), mEvents.end(),
+                     [](const Event& a, const Event& b) { return a.timeMs < b.timeMs; });
+    mSorted = true;
+}
+
+void VirtualGamepad::update()
+{
+    mLastPressed = 0;
+    if (mFixedStepMs > 0.0)
+    {
+        advanceTo(mNowMs + mFixedStepMs);
+    }
+    else
+    {
+        advanceTo(std::chrono::duration<double, std::milli>(Clock::now() - mStart).count());
+    }
+}
+
+const char* VirtualGamepad::getName(int gamepad) const
+{
+    return isAvailable(gamepad) ? "PadCast Virtual Gamepad" : "";
+}
+
+PadState VirtualGamepad::sample(int gamepad)
+{
+    // In wall-time mode the late latch should see events up to now, like a real pad
+    if (mFixedStepMs <= 0.0)
+    {
+        advanceTo(std::chrono::duration<double, std::milli>(Clock::now() - mStart).count());
+    }
+
+    PadState state;
+    state.gamepad = gamepad;
+    if (!isAvailable(gamepad))
+    {
+        return state;
+    }
+
+    state.buttons = mButtons;
+    state.axes = mAxes;
+    if (state.axes[GAMEPAD_AXIS_LEFT_TRIGGER] > kTriggerThreshold)
+    {
+        state.buttons |= 1u << GAMEPAD_BUTTON_LEFT_TRIGGER_2;
+    }
+    if (state.axes[GAMEPAD_AXIS_RIGHT_TRIGGER] > kTriggerThreshold)
+    {
+        state.buttons |= 1u << GAMEPAD_BUTTON_RIGHT_TRIGGER_2;
+    }
+    return state;
+}
+
+void VirtualGamepad::advanceTo(double timeMs)
+{
+    if (!mSorted)
+    {
+        sortEvents();
+    }
+    if (timeMs < mNowMs)
+    {
+        return;
+    }
+
+    // After a long stall don't replay every missed loop, just the last one
+    if (mLoopMs > 0.0 && timeMs - mLoopBaseMs > 2.0 * mLoopMs)
+    {
+        mLoopBaseMs += std::floor((timeMs - mLoopBaseMs) / mLoopMs - 1.0) * mLoopMs;
+        mNext = 0;
+        mButtons = 0;
+        mAxes = {};
+    }
+
+    while (true)
+    {
+        while (mNext < mEvents.size() && mLoopBaseMs + mEvents[mNext].timeMs <= timeMs
+               && (mLoopMs <= 0.0 || mEvents[mNext].timeMs < mLoopMs))
+        {
+            apply(mEvents[mNext]);
+            ++mNext;
+        }
+
+        if (mLoopMs > 0.0 && timeMs >= mLoopBaseMs + mLoopMs)
+        {
+            // Each iteration starts from released buttons and centered axes;
+            // the connection state carries over
+            mLoopBaseMs += mLoopMs;
+            mNext = 0;
+            mButtons = 0;
+            mAxes = {};
+            continue;
+        }
+        break;
+    }
+    mNowMs = timeMs;
+}
+
+void VirtualGamepad::apply(const Event& event)
+{
+    switch (event.type)
+    {
+    case EventType::Press:
+        if ((mButtons & (1u << event.code)) == 0 && mConnected)
+        {
+            mButtons |= 1u << event.code;
+            mLastPressed = event.code;
+        }
+        break;
+    case EventType::Release:
+        mButtons &= ~(1u << event.code);
+        break;
+    case EventType::Axis:
+        mAxes[event.code] = event.value;
+        break;
+    case EventType::Connect:
+        mConnected = true;
+        break;
+    case EventType::Disconnect:
+        mConnected = false;
+        mButtons = 0;
+        mAxes = {};
+        break;
+    }
+}
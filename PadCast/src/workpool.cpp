@@ -0,0 +1,134 @@
+#include "workpool.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    // Which pool and worker the current thread is, so tasks that submit more
+    // tasks keep them local
+    thread_local const WorkStealingPool* tlsPool{ nullptr };
+    thread_local unsigned int tlsWorker{ 0 };
+}
+
+WorkStealingPool::WorkStealingPool(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        mThreads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    waitIdle();
+    {
+        std::lock_guard lock{ mSleepMutex };
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    const unsigned int index = tlsPool == this
+        ? tlsWorker
+        : static_cast<unsigned int>(mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size());
+
+    mUnfinished.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock{ mQueues[index]->mutex };
+        mQueues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Counted under the sleep mutex so a worker can't miss it between its
+        // last look at the queues and going to sleep
+        std::lock_guard lock{ mSleepMutex };
+        mQueued.fetch_add(1, std::memory_order_relaxed);
+    }
+    mWake.notify_one();
+}
+
+void WorkStealingPool::waitIdle()
+{
+    std::unique_lock lock{ mSleepMutex };
+    mIdle.wait(lock, [this] { return mUnfinished.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::popLocal(unsigned int index, Task& task)
+{
+    Queue& queue = *mQueues[index];
+    std::lock_guard lock{ queue.mutex };
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned int thief, Task& task)
+{
+    const size_t count = mQueues.size();
+    for (size_t i = 1; i < count; ++i)
+    {
+        Queue& queue = *mQueues[(thief + i) % count];
+        // Don't queue up behind a worker that's busy with its own deque
+        std::unique_lock lock{ queue.mutex, std::try_to_lock };
+        if (!lock.owns_lock() || queue.tasks.empty())
+        {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        mSteals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned int index)
+{
+    tlsPool = this;
+    tlsWorker = index;
+    trace::setThreadName(("Worker " + std::to_string(index)).c_str());
+
+    Task task;
+    while (true)
+    {
+        if (popLocal(index, task) || steal(index, task))
+        {
+            mQueued.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr;
+            if (mUnfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard lock{ mSleepMutex };
+                mIdle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock{ mSleepMutex };
+        mWake.wait(lock, [this] { return mStopping || mQueued.load(std::memory_order_relaxed) > 0; });
+        if (mStopping && mQueued.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,636 @@
+#include "wsserver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/epoll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace
+{
+    constexpr uint8_t kOpText{ 0x1 };
+    constexpr uint8_t kOpBinary{ 0x2 };
+    constexpr uint8_t kOpClose{ 0x8 };
+    constexpr uint8_t kOpPing{ 0x9 };
+    constexpr uint8_t kOpPong{ 0xA };
+
+    constexpr std::string_view kHandshakeGuid{ "258EAFA5-E914-47DA-95CA-C5AB0DC85B11" };
+
+    // Only for the handshake's Sec-WebSocket-Accept; not for anything secret
+    std::array<uint8_t, 20> sha1(std::string_view text)
+    {
+        std::array<uint32_t, 5> h{ 0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u };
+        std::string message{ text };
+        const uint64_t bitLength = static_cast<uint64_t>(text.size()) * 8;
+        message.push_back(static_cast<char>(0x80));
+        while (message.size() % 64 != 56)
+        {
+            message.push_back('\0');
+        }
+        for (int i = 7; i >= 0; --i)
+        {
+            message.push_back(static_cast<char>(bitLength >> (8 * i)));
+        }
+
+        const auto rotl = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+        for (size_t chunk = 0; chunk < message.size(); chunk += 64)
+        {
+            std::array<uint32_t, 80> w{};
+            for (int i = 0; i < 16; ++i)
+            {
+                const auto* p = reinterpret_cast<const uint8_t*>(message.data() + chunk + 4 * i);
+                w[i] = (uint32_t{ p[0] } << 24) | (uint32_t{ p[1] } << 16) | (uint32_t{ p[2] } << 8) | p[3];
+            }
+            for (int i = 16; i < 80; ++i)
+            {
+                w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            }
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; ++i)
+            {
+                uint32_t f = 0;
+                uint32_t k = 0;
+                if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999u; }
+                else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1u; }
+                else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDCu; }
+                else { f = b ^ c ^ d; k = 0xCA62C1D6u; }
+                const uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotl(b, 30);
+                b = a;
+                a = temp;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+
+        std::array<uint8_t, 20> digest{};
+        for (int i = 0; i < 20; ++i)
+        {
+            digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+        }
+        return digest;
+    }
+
+    std::string base64(const uint8_t* data, size_t size)
+    {
+        static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < size; i += 3)
+        {
+            const uint32_t chunk = (uint32_t{ data[i] } << 16)
+                | (i + 1 < size ? uint32_t{ data[i + 1] } << 8 : 0)
+                | (i + 2 < size ? uint32_t{ data[i + 2] } : 0);
+            out.push_back(kAlphabet[(chunk >> 18) & 63]);
+            out.push_back(kAlphabet[(chunk >> 12) & 63]);
+            out.push_back(i + 1 < size ? kAlphabet[(chunk >> 6) & 63] : '=');
+            out.push_back(i + 2 < size ? kAlphabet[chunk & 63] : '=');
+        }
+        return out;
+    }
+
+    std::string lower(std::string_view text)
+    {
+        std::string out{ text };
+        std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return out;
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // Plain relative file names only: no "..", no absolute paths, no odd characters
+    bool isSafeRelativePath(std::string_view path)
+    {
+        if (path.empty() || path.front() == '/' || path.find("..") != std::string_view::npos)
+        {
+            return false;
+        }
+        return std::all_of(path.begin(), path.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_' || c == '-' || c == '/';
+        });
+    }
+
+    std::string_view contentType(const std::filesystem::path& path)
+    {
+        const std::string extension = lower(path.extension().string());
+        if (extension == ".html") return "text/html; charset=utf-8";
+        if (extension == ".js") return "text/javascript; charset=utf-8";
+        if (extension == ".css") return "text/css; charset=utf-8";
+        if (extension == ".png") return "image/png";
+        return "application/octet-stream";
+    }
+
+    std::string_view statusText(int status)
+    {
+        switch (status)
+        {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        default: return "Error";
+        }
+    }
+}
+
+std::string WebSocketServer::frame(uint8_t opcode, std::string_view payload)
+{
+    std::string out;
+    out.reserve(payload.size() + 10);
+    out.push_back(static_cast<char>(0x80 | opcode));	// FIN, never fragmented
+    if (payload.size() < 126)
+    {
+        out.push_back(static_cast<char>(payload.size()));
+    }
+    else if (payload.size() <= 0xFFFF)
+    {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>(payload.size() >> 8));
+        out.push_back(static_cast<char>(payload.size()));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(127));
+        for (int i = 7; i >= 0; --i)
+        {
+            out.push_back(static_cast<char>(static_cast<uint64_t>(payload.size()) >> (8 * i)));
+        }
+    }
+    out.append(payload);
+    return out;
+}
+
+#ifdef __linux__
+
+bool WebSocketServer::start(const Settings& settings, std::string& error)
+{
+    stop();
+    mSettings = settings;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(settings.port));
+    if (inet_pton(AF_INET, settings.bindAddress.c_str(), &address.sin_addr) != 1)
+    {
+        error = "not an IPv4 address: " + settings.bindAddress;
+        return false;
+    }
+
+    mListen = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int reuse = 1;
+    if (mListen < 0
+        || setsockopt(mListen, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+        || bind(mListen, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(mListen, SOMAXCONN) != 0)
+    {
+        error = "can't listen on " + settings.bindAddress + ":" + std::to_string(settings.port) + ": "
+            + std::strerror(errno);
+        stop();
+        return false;
+    }
+
+    mEpoll = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = mListen;
+    if (mEpoll < 0 || epoll_ctl(mEpoll, EPOLL_CTL_ADD, mListen, &event) != 0)
+    {
+        error = std::string{ "epoll: " } + std::strerror(errno);
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void WebSocketServer::stop()
+{
+    for (auto& [fd, connection] : mConnections)
+    {
+        ::close(fd);
+    }
+    mConnections.clear();
+    mClosing.clear();
+    mClients = 0;
+    if (mListen >= 0)
+    {
+        ::close(mListen);
+        mListen = -1;
+    }
+    if (mEpoll >= 0)
+    {
+        ::close(mEpoll);
+        mEpoll = -1;
+    }
+}
+
+void WebSocketServer::poll(int timeoutMs)
+{
+    std::array<epoll_event, 64> events;
+    const int count = epoll_wait(mEpoll, events.data(), static_cast<int>(events.size()), timeoutMs);
+    for (int i = 0; i < count; ++i)
+    {
+        const int fd = events[i].data.fd;
+        if (fd == mListen)
+        {
+            acceptClients();
+            continue;
+        }
+        auto it = mConnections.find(fd);
+        if (it == mConnections.end())
+        {
+            continue;
+        }
+        Connection& connection = it->second;
+        if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0)
+        {
+            drop(connection);
+            continue;
+        }
+        if ((events[i].events & EPOLLOUT) != 0)
+        {
+            flush(connection);
+        }
+        if ((events[i].events & EPOLLIN) != 0)
+        {
+            onReadable(connection);
+        }
+    }
+
+    for (int fd : mClosing)
+    {
+        auto it = mConnections.find(fd);
+        if (it != mConnections.end())
+        {
+            if (it->second.upgraded)
+            {
+                --mClients;
+            }
+            ::close(fd);
+            mConnections.erase(it);
+        }
+    }
+    mClosing.clear();
+}
+
+void WebSocketServer::acceptClients()
+{
+    while (true)
+    {
+        const int fd = accept4(mListen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;	// EAGAIN: that's everyone
+        }
+        // Updates are tiny and latency is the point
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            ::close(fd);
+            continue;
+        }
+        mConnections[fd].fd = fd;
+    }
+}
+
+void WebSocketServer::onReadable(Connection& connection)
+{
+    char buffer[4096];
+    while (true)
+    {
+        const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0)
+        {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            drop(connection);
+            return;
+        }
+        break;
+    }
+
+    if (connection.upgraded)
+    {
+        handleFrames(connection);
+        return;
+    }
+    const size_t end = connection.input.find("\r\n\r\n");
+    if (end == std::string::npos)
+    {
+        if (connection.input.size() > kMaxRequestBytes)
+        {
+            drop(connection);
+        }
+        return;
+    }
+    const std::string request = connection.input.substr(0, end);
+    connection.input.erase(0, end + 4);
+    handleRequest(connection, request);
+}
+
+void WebSocketServer::handleRequest(Connection& connection, std::string_view request)
+{
+    const size_t lineEnd = request.find("\r\n");
+    const std::string_view requestLine = request.substr(0, lineEnd);
+    const size_t methodEnd = requestLine.find(' ');
+    const size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+    if (methodEnd == std::string_view::npos || targetEnd == std::string_view::npos)
+    {
+        respond(connection, 400, "text/plain", "bad request\n");
+        return;
+    }
+    const std::string_view method = requestLine.substr(0, methodEnd);
+    const std::string_view target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    if (method != "GET")
+    {
+        respond(connection, 405, "text/plain", "GET only\n");
+        return;
+    }
+
+    std::unordered_map<std::string, std::string> headers;
+    std::string_view rest = lineEnd == std::string_view::npos ? std::string_view{} : request.substr(lineEnd + 2);
+    while (!rest.empty())
+    {
+        const size_t end = rest.find("\r\n");
+        const std::string_view line = rest.substr(0, end);
+        const size_t colon = line.find(':');
+        if (colon != std::string_view::npos)
+        {
+            headers[lower(trim(line.substr(0, colon)))] = std::string{ trim(line.substr(colon + 1)) };
+        }
+        rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 2);
+    }
+
+    const size_t query = target.find('?');
+    const std::string_view path = target.substr(0, query);
+    const std::string_view parameters = query == std::string_view::npos ? std::string_view{} : target.substr(query + 1);
+    // Only origin-form targets ("/path?query"); anything else would break the path handling below
+    if (!path.starts_with('/'))
+    {
+        respond(connection, 400, "text/plain", "bad request\n");
+        return;
+    }
+
+    if (path == "/ws")
+    {
+        const auto key = headers.find("sec-websocket-key");
+        if (lower(headers["upgrade"]) != "websocket" || key == headers.end())
+        {
+            respond(connection, 400, "text/plain", "WebSocket upgrade expected\n");
+            return;
+        }
+        const auto digest = sha1(key->second + std::string{ kHandshakeGuid });
+        auto response = std::make_shared<std::string>(
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: " + base64(digest.data(), digest.size()) + "\r\n\r\n");
+        connection.upgraded = true;
+        connection.format = parameters.find("format=binary") != std::string_view::npos ? Format::Binary : Format::Json;
+        ++mClients;
+        queue(connection, std::move(response));
+        // Updates only go out on changes, so start the client with the current state
+        if (const Buffer& latest = mLatest[static_cast<size_t>(connection.format)])
+        {
+            queue(connection, latest);
+        }
+        flush(connection);
+        // Anything the client sent after its handshake
+        handleFrames(connection);
+        return;
+    }
+
+    if (path == "/")
+    {
+        serveFile(connection, mSettings.webRoot / "index.html");
+    }
+    else if (path.starts_with("/images/") && isSafeRelativePath(path.substr(8)))
+    {
+        serveFile(connection, mSettings.imageRoot / std::filesystem::path{ path.substr(8) });
+    }
+    else if (isSafeRelativePath(path.substr(1)))
+    {
+        serveFile(connection, mSettings.webRoot / std::filesystem::path{ path.substr(1) });
+    }
+    else
+    {
+        respond(connection, 404, "text/plain", "not found\n");
+    }
+}
+
+void WebSocketServer::serveFile(Connection& connection, const std::filesystem::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        respond(connection, 404, "text/plain", "not found\n");
+        return;
+    }
+    const std::string body{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    respond(connection, 200, contentType(path), body);
+}
+
+void WebSocketServer::respond(Connection& connection, int status, std::string_view type, std::string_view body)
+{
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << ' ' << statusText(status) << "\r\n"
+             << "Content-Type: " << type << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Cache-Control: no-cache\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    connection.closeAfterFlush = true;
+    queue(connection, std::make_shared<std::string>(response.str()));
+    flush(connection);
+}
+
+void WebSocketServer::handleFrames(Connection& connection)
+{
+    std::string& in = connection.input;
+    while (in.size() >= 2)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(in.data());
+        const uint8_t opcode = bytes[0] & 0x0F;
+        const bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t offset = 2;
+        if (length == 126)
+        {
+            if (in.size() < 4) return;
+            length = (uint64_t{ bytes[2] } << 8) | bytes[3];
+            offset = 4;
+        }
+        else if (length == 127)
+        {
+            if (in.size() < 10) return;
+            length = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                length = (length << 8) | bytes[2 + i];
+            }
+            offset = 10;
+        }
+        // Clients must mask (RFC 6455 5.1), and nothing they send us is big
+        if (!masked || length > kMaxMessageBytes)
+        {
+            drop(connection);
+            return;
+        }
+        if (in.size() < offset + 4 + length)
+        {
+            return;
+        }
+        const uint8_t* mask = bytes + offset;
+        std::string payload(in.data() + offset + 4, static_cast<size_t>(length));
+        for (size_t i = 0; i < payload.size(); ++i)
+        {
+            payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+        }
+        in.erase(0, offset + 4 + static_cast<size_t>(length));
+
+        if (opcode == kOpClose)
+        {
+            // Echo the status code back and hang up once it's out
+            connection.closeAfterFlush = true;
+            queue(connection, std::make_shared<std::string>(frame(kOpClose, payload.substr(0, 2))));
+            flush(connection);
+            return;
+        }
+        if (opcode == kOpPing)
+        {
+            queue(connection, std::make_shared<std::string>(frame(kOpPong, payload)));
+            flush(connection);
+        }
+        // Text/binary/pong from the client: nothing to do with them
+    }
+}
+
+void WebSocketServer::broadcast(std::string_view json, std::string_view binary)
+{
+    mLatest[static_cast<size_t>(Format::Json)] = std::make_shared<const std::string>(frame(kOpText, json));
+    mLatest[static_cast<size_t>(Format::Binary)] = std::make_shared<const std::string>(frame(kOpBinary, binary));
+    for (auto& [fd, connection] : mConnections)
+    {
+        if (connection.upgraded && !connection.closeAfterFlush)
+        {
+            queue(connection, mLatest[static_cast<size_t>(connection.format)]);
+            flush(connection);
+        }
+    }
+}
+
+void WebSocketServer::queue(Connection& connection, Buffer buffer)
+{
+    if (connection.output.size() >= kMaxQueued)
+    {
+        // Keep the one that's partly sent (if any), replace the backlog with the newest
+        const size_t keep = connection.outputOffset > 0 ? 1 : 0;
+        connection.output.erase(connection.output.begin() + static_cast<ptrdiff_t>(keep), connection.output.end());
+    }
+    connection.output.push_back(std::move(buffer));
+}
+
+void WebSocketServer::flush(Connection& connection)
+{
+    while (!connection.output.empty())
+    {
+        const std::string& buffer = *connection.output.front();
+        const ssize_t sent = send(connection.fd, buffer.data() + connection.outputOffset,
+                                  buffer.size() - connection.outputOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                setWriteInterest(connection, true);
+                return;
+            }
+            drop(connection);
+            return;
+        }
+        connection.outputOffset += static_cast<size_t>(sent);
+        if (connection.outputOffset < buffer.size())
+        {
+            setWriteInterest(connection, true);
+            return;
+        }
+        if (connection.upgraded)
+        {
+            ++mSent;
+        }
+        connection.output.pop_front();
+        connection.outputOffset = 0;
+    }
+    setWriteInterest(connection, false);
+    if (connection.closeAfterFlush)
+    {
+        drop(connection);
+    }
+}
+
+void WebSocketServer::setWriteInterest(Connection& connection, bool wanted)
+{
+    if (connection.writeInterest == wanted)
+    {
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | (wanted ? EPOLLOUT : 0u);
+    event.data.fd = connection.fd;
+    epoll_ctl(mEpoll, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.writeInterest = wanted;
+}
+
+void WebSocketServer::drop(Connection& connection)
+{
+    if (std::find(mClosing.begin(), mClosing.end(), connection.fd) == mClosing.end())
+    {
+        epoll_ctl(mEpoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+        connection.output.clear();
+        connection.closeAfterFlush = true;	// no more broadcasts to it
+        mClosing.push_back(connection.fd);
+    }
+}
+
+#else
+
+bool WebSocketServer::start(const Settings& settings, std::string& error)
+{
+    (void)settings;
+    error = "the WebSocket daemon is only supported on Linux";
+    return false;
+}
+
+void WebSocketServer::stop() {}
+void WebSocketServer::poll(int timeoutMs) { (void)timeoutMs; }
+void WebSocketServer::broadcast(std::string_view json, std::string_view binary) { (void)json; (void)binary; }
+
+#endif
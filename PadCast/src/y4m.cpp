@@ -0,0 +1,79 @@
+#include "y4m.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace y4m
+{
+    namespace
+    {
+        constexpr char kFrameTag[]{ "FRAME\n" };
+        constexpr size_t kFrameTagSize{ sizeof(kFrameTag) - 1 };
+    }
+
+    void frameRate(double fps, long long& numerator, long long& denominator)
+    {
+        if (std::abs(fps - std::round(fps)) < 1e-6)
+        {
+            numerator = std::llround(fps);
+            denominator = 1;
+        }
+        else
+        {
+            numerator = std::llround(fps * 1000.0);
+            denominator = 1000;
+        }
+    }
+
+    std::string header(int width, int height, double fps)
+    {
+        long long numerator = 0;
+        long long denominator = 1;
+        frameRate(fps, numerator, denominator);
+        return "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height)
+            + " F" + std::to_string(numerator) + ":" + std::to_string(denominator)
+            + " Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=LIMITED\n";
+    }
+
+    // 8.8 fixed point. Chroma is the average of each 2x2 block.
+    void encodeFrame(const uint8_t* firstRow, ptrdiff_t rowStride, int width, int height,
+                     std::vector<uint8_t>& out)
+    {
+        const size_t lumaSize = static_cast<size_t>(width) * height;
+        const size_t chromaSize = lumaSize / 4;
+        out.resize(kFrameTagSize + lumaSize + 2 * chromaSize);
+        std::memcpy(out.data(), kFrameTag, kFrameTagSize);
+        uint8_t* const lumaPlane = out.data() + kFrameTagSize;
+        uint8_t* const cbPlane = lumaPlane + lumaSize;
+        uint8_t* const crPlane = cbPlane + chromaSize;
+
+        for (int y = 0; y < height; ++y)
+        {
+            const uint8_t* src = firstRow + rowStride * y;
+            uint8_t* dst = lumaPlane + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x, src += 4)
+            {
+                dst[x] = static_cast<uint8_t>((47 * src[0] + 157 * src[1] + 16 * src[2] + (16 << 8) + 128) >> 8);
+            }
+        }
+
+        const int chromaWidth = width / 2;
+        for (int cy = 0; cy < height / 2; ++cy)
+        {
+            const uint8_t* top = firstRow + rowStride * (2 * cy);
+            const uint8_t* bottom = top + rowStride;
+            uint8_t* cb = cbPlane + static_cast<size_t>(cy) * chromaWidth;
+            uint8_t* cr = crPlane + static_cast<size_t>(cy) * chromaWidth;
+            for (int cx = 0; cx < chromaWidth; ++cx, top += 8, bottom += 8)
+            {
+                const int r = top[0] + top[4] + bottom[0] + bottom[4];
+                const int g = top[1] + top[5] + bottom[1] + bottom[5];
+                const int b = top[2] + top[6] + bottom[2] + bottom[6];
+                // Sums of four pixels, so shift by 8 + 2
+                cb[cx] = static_cast<uint8_t>(std::clamp(128 + ((-26 * r - 87 * g + 113 * b + 512) >> 10), 0, 255));
+                cr[cx] = static_cast<uint8_t>(std::clamp(128 + ((112 * r - 102 * g - 10 * b + 512) >> 10), 0, 255));
+            }
+        }
+    }
+}
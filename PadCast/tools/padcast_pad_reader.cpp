@@ -0,0 +1,125 @@
+// padcast_pad_reader: reference consumer for PadCast's shared pad state
+// (--share-pad). Prints a line whenever the buttons or the connection change,
+// the way a chat widget or input-timeline script would follow the pad.
+//
+//     PadCast --share-pad - &
+//     padcast_pad_reader                 # or --json for one object per line
+//
+// Reading is a seqlock-checked copy of 128 bytes, so polling every
+// millisecond (the default) costs nothing measurable.
+
+#include "padshm.h"
+#include "shmframes.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+    constexpr std::array<const char*, 12> kButtonNames{
+        "Up", "Right", "Down", "Left", "X", "A", "B", "Y", "L", "R", "Select", "Start"
+    };
+
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [--name <segment>] [--json] [--poll-ms <n>]\n"
+            "  --name <segment>  Shared pad state to read (default %s).\n"
+            "  --json            One JSON object per change instead of text.\n"
+            "  --poll-ms <n>     How often to check for changes (default 1).\n",
+            program, padshm::kDefaultName);
+    }
+
+    void printText(const padshm::Snapshot& pad, double ageMs)
+    {
+        if (pad.connected == 0)
+        {
+            std::printf("disconnected\n");
+            return;
+        }
+        std::printf("pad %d [%s]:", pad.gamepad, pad.name.data());
+        for (size_t i = 0; i < kButtonNames.size(); ++i)
+        {
+            if ((pad.logicalButtons & (1u << i)) != 0)
+            {
+                std::printf(" %s", kButtonNames[i]);
+            }
+        }
+        std::printf("  (raw 0x%08x, %.3f ms ago)\n", pad.rawButtons, ageMs);
+    }
+
+    void printJson(const padshm::Snapshot& pad, double ageMs)
+    {
+        std::printf("{\"connected\":%s,\"gamepad\":%d,\"buttons\":%u,\"raw\":%u,\"changed_ns\":%" PRIu64
+                    ",\"age_ms\":%.3f,\"axes\":[%.3f,%.3f,%.3f,%.3f,%.3f,%.3f]}\n",
+                    pad.connected != 0 ? "true" : "false", pad.gamepad, pad.logicalButtons, pad.rawButtons,
+                    pad.changedNs, ageMs, pad.axes[0], pad.axes[1], pad.axes[2], pad.axes[3], pad.axes[4],
+                    pad.axes[5]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string name{ padshm::kDefaultName };
+    bool json{ false };
+    int pollMs{ 1 };
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--name" && i + 1 < argc)
+        {
+            name = argv[++i];
+        }
+        else if (arg == "--json")
+        {
+            json = true;
+        }
+        else if (arg == "--poll-ms" && i + 1 < argc)
+        {
+            pollMs = std::max(0, std::atoi(argv[++i]));
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    padshm::Reader reader;
+    std::string error;
+    if (!reader.open(name, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    uint64_t lastSequence{ 0 };
+    uint64_t lastChange{ 0 };
+    while (!reader.writerClosed())
+    {
+        // Most polls see nothing new and stop at this one load
+        const uint64_t sequence = reader.sequence();
+        padshm::Snapshot pad;
+        if (sequence != lastSequence && reader.read(pad))
+        {
+            lastSequence = sequence;
+            if (pad.changedNs != lastChange)
+            {
+                lastChange = pad.changedNs;
+                const double ageMs = (shmframes::monotonicNs() - pad.changedNs) / 1e6;
+                json ? printJson(pad, ageMs) : printText(pad, ageMs);
+                std::fflush(stdout);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollMs));
+    }
+    std::fprintf(stderr, "PadCast closed the pad state\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+// padcast_shm_reader: reference consumer for PadCast's shared-memory frames
+// (--video-format shm). Maps the ring, sleeps until each frame is published,
+// and uses the pixels in place -- the only copy is the optional dump.
+//
+//     PadCast --video-out padcast-frames --video-format shm &
+//     padcast_shm_reader                          # prints fps and latency
+//     padcast_shm_reader --raw | ffplay -f rawvideo -pixel_format rgba
+//         -video_size 960x540 -i -               (size as printed on start)
+//
+// A frame that gets overwritten while it's in use (the reader fell a whole
+// ring behind) is counted as torn.
+
+#include "shmframes.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [--name <ring>] [--raw] [--frames <n>]\n"
+            "  --name <ring>   Shared-memory ring to read (default %s).\n"
+            "  --raw           Write each frame to stdout as top-down RGBA8.\n"
+            "  --frames <n>    Stop after n frames (default: until PadCast exits).\n",
+            program, shmframes::kDefaultName);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string name{ shmframes::kDefaultName };
+    bool raw{ false };
+    uint64_t limit{ 0 };
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--name" && i + 1 < argc)
+        {
+            name = argv[++i];
+        }
+        else if (arg == "--raw")
+        {
+            raw = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    shmframes::Reader reader;
+    std::string error;
+    if (!reader.open(name, error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const shmframes::Header& header = reader.header();
+    std::fprintf(stderr, "%s: %ux%u RGBA, %u/%u FPS, %u slots, writer pid %u\n", name.c_str(),
+                 header.width, header.height, header.fpsNumerator, header.fpsDenominator,
+                 header.slotCount, header.writerPid);
+
+    uint64_t after{ 0 };
+    uint64_t received{ 0 };
+    uint64_t skipped{ 0 };
+    uint64_t torn{ 0 };
+    uint64_t latencySumNs{ 0 };
+    uint64_t reportStart{ shmframes::monotonicNs() };
+    uint64_t reportFrames{ 0 };
+    const size_t rowBytes = static_cast<size_t>(header.width) * 4;
+
+    while ((limit == 0 || received < limit) && reader.waitForFrame(after, 1000))
+    {
+        shmframes::Reader::Frame frame;
+        if (!reader.latest(frame))
+        {
+            continue;
+        }
+        // Frames published since the last one we took, that we never looked at
+        skipped += frame.frame - after;
+        after = frame.frame + 1;
+        const uint64_t latencyNs = shmframes::monotonicNs() - frame.timestampNs;
+
+        if (raw)
+        {
+            for (uint32_t y = 0; y < header.height; ++y)
+            {
+                std::fwrite(frame.pixels + static_cast<size_t>(header.stride) * y, 1, rowBytes, stdout);
+            }
+            std::fflush(stdout);
+        }
+        if (!reader.stillValid(frame))
+        {
+            // The writer lapped us mid-frame. With --raw it's already out (the
+            // stream stays frame-aligned); a client that keeps frames drops it.
+            ++torn;
+            continue;
+        }
+
+        ++received;
+        ++reportFrames;
+        latencySumNs += latencyNs;
+        const uint64_t now = shmframes::monotonicNs();
+        if (now - reportStart >= 1'000'000'000ull)
+        {
+            std::fprintf(stderr, "%.1f FPS, %.3f ms average publish-to-read, %" PRIu64 " skipped, %" PRIu64 " torn\n",
+                         reportFrames * 1e9 / static_cast<double>(now - reportStart),
+                         latencySumNs / 1e6 / static_cast<double>(reportFrames), skipped, torn);
+            reportStart = now;
+            reportFrames = 0;
+            latencySumNs = 0;
+        }
+    }
+
+    std::fprintf(stderr, "%" PRIu64 " frames read, %" PRIu64 " skipped, %" PRIu64 " torn%s\n", received, skipped, torn,
+                 reader.writerClosed() ? " (PadCast closed the ring)" : "");
+    return 0;
+}
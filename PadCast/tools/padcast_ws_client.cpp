@@ -0,0 +1,344 @@
+// padcast_ws_client: stands in for an OBS browser source against
+// PadCast --daemon. Connects one or many WebSockets, prints the events the
+// first one gets, and with --clients reports how long each update took to
+// reach every client (the spread between the first and last to get it).
+//
+//     PadCast --daemon --virtual-pad script.txt &
+//     padcast_ws_client                         # print JSON events
+//     padcast_ws_client --clients 200 --quiet   # fan-out check
+//
+// Plain sockets and poll(), no WebSocket library.
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    volatile std::sig_atomic_t gStop{ 0 };
+
+    struct Client
+    {
+        int fd{ -1 };
+        bool upgraded{ false };
+        std::string input;
+    };
+
+    struct Options
+    {
+        std::string host{ "127.0.0.1" };
+        int port{ 8765 };
+        bool binary{ false };
+        int clients{ 1 };
+        long count{ 0 };	// 0 = until interrupted
+        bool quiet{ false };
+    };
+
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [--host <ip>] [--port <n>] [--binary] [--clients <n>] [--count <n>] [--quiet]\n"
+            "  --host <ip>      Daemon address (default 127.0.0.1).\n"
+            "  --port <n>       Daemon port (default 8765).\n"
+            "  --binary         Ask for binary events instead of JSON.\n"
+            "  --clients <n>    Open this many connections (default 1).\n"
+            "  --count <n>      Exit after the first client has this many events.\n"
+            "  --quiet          Don't print events, only the summary.\n",
+            program);
+    }
+
+    int connectTo(const Options& options)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        if (inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1)
+        {
+            return -1;
+        }
+        const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            return -1;
+        }
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        // The key only has to be base64 of 16 bytes; the server's reply isn't checked
+        const std::string request =
+            "GET /ws" + std::string{ options.binary ? "?format=binary" : "" } + " HTTP/1.1\r\n"
+            "Host: " + options.host + ":" + std::to_string(options.port) + "\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+            "Sec-WebSocket-Version: 13\r\n\r\n";
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()))
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    uint32_t readLE32(const uint8_t* p)
+    {
+        return uint32_t{ p[0] } | (uint32_t{ p[1] } << 8) | (uint32_t{ p[2] } << 16) | (uint32_t{ p[3] } << 24);
+    }
+
+    // Sequence number of an event, 0 if it isn't one
+    uint32_t sequenceOf(std::string_view payload, bool binary)
+    {
+        if (binary)
+        {
+            return payload.size() >= 24 ? readLE32(reinterpret_cast<const uint8_t*>(payload.data()) + 4) : 0;
+        }
+        const size_t at = payload.find("\"seq\":");
+        return at == std::string_view::npos ? 0 : static_cast<uint32_t>(std::strtoul(payload.data() + at + 6, nullptr, 10));
+    }
+
+    void printEvent(std::string_view payload, bool binary)
+    {
+        if (!binary)
+        {
+            std::printf("%.*s\n", static_cast<int>(payload.size()), payload.data());
+            return;
+        }
+        if (payload.size() < 24)
+        {
+            std::printf("(short binary event, %zu bytes)\n", payload.size());
+            return;
+        }
+        const auto* p = reinterpret_cast<const uint8_t*>(payload.data());
+        uint64_t micros = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+            micros = (micros << 8) | p[16 + i];
+        }
+        const int16_t gamepad = static_cast<int16_t>(p[2] | (p[3] << 8));
+        std::printf("v%u seq %u %s pad %d buttons 0x%03x raw 0x%08x t %.3f ms\n",
+                    p[0], readLE32(p + 4), (p[1] & 1) != 0 ? "connected" : "disconnected", gamepad,
+                    readLE32(p + 8), readLE32(p + 12), micros / 1000.0);
+    }
+
+    // Pulls complete server frames (unmasked) out of the client's input
+    template <typename OnMessage>
+    bool takeFrames(Client& client, OnMessage&& onMessage)
+    {
+        std::string& in = client.input;
+        if (!client.upgraded)
+        {
+            const size_t end = in.find("\r\n\r\n");
+            if (end == std::string::npos)
+            {
+                return true;
+            }
+            if (!in.starts_with("HTTP/1.1 101"))
+            {
+                std::fprintf(stderr, "Handshake refused: %s\n", in.substr(0, in.find("\r\n")).c_str());
+                return false;
+            }
+            client.upgraded = true;
+            in.erase(0, end + 4);
+        }
+        while (in.size() >= 2)
+        {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(in.data());
+            uint64_t length = bytes[1] & 0x7F;
+            size_t offset = 2;
+            if (length == 126)
+            {
+                if (in.size() < 4) return true;
+                length = (uint64_t{ bytes[2] } << 8) | bytes[3];
+                offset = 4;
+            }
+            else if (length == 127)
+            {
+                if (in.size() < 10) return true;
+                length = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    length = (length << 8) | bytes[2 + i];
+                }
+                offset = 10;
+            }
+            if (in.size() < offset + length)
+            {
+                return true;
+            }
+            const uint8_t opcode = bytes[0] & 0x0F;
+            if (opcode == 0x8)
+            {
+                return false;
+            }
+            onMessage(std::string_view{ in.data() + offset, static_cast<size_t>(length) });
+            in.erase(0, offset + static_cast<size_t>(length));
+        }
+        return true;
+    }
+
+    void requestStop(int)
+    {
+        gStop = 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--host" && i + 1 < argc)
+        {
+            options.host = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc)
+        {
+            options.port = std::atoi(argv[++i]);
+        }
+        else if (arg == "--binary")
+        {
+            options.binary = true;
+        }
+        else if (arg == "--clients" && i + 1 < argc)
+        {
+            options.clients = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--count" && i + 1 < argc)
+        {
+            options.count = std::max(0L, std::atol(argv[++i]));
+        }
+        else if (arg == "--quiet")
+        {
+            options.quiet = true;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    std::vector<Client> clients(static_cast<size_t>(options.clients));
+    for (Client& client : clients)
+    {
+        client.fd = connectTo(options);
+        if (client.fd < 0)
+        {
+            std::fprintf(stderr, "Can't connect to %s:%d (is PadCast running with --daemon?)\n",
+                         options.host.c_str(), options.port);
+            return 1;
+        }
+    }
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // Per update: when the first client got it and how many have so far
+    struct Arrival
+    {
+        Clock::time_point first;
+        int received{ 0 };
+    };
+    std::map<uint32_t, Arrival> arrivals;
+    std::vector<double> spreadsUs;
+    long events{ 0 };
+
+    std::vector<pollfd> fds(clients.size());
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        fds[i] = { clients[i].fd, POLLIN, 0 };
+    }
+
+    size_t open = clients.size();
+    while (gStop == 0 && open > 0 && (options.count == 0 || events < options.count))
+    {
+        if (poll(fds.data(), fds.size(), 200) < 0)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            if (fds[i].fd < 0 || fds[i].revents == 0)
+            {
+                continue;
+            }
+            char buffer[4096];
+            const ssize_t received = recv(clients[i].fd, buffer, sizeof(buffer), 0);
+            const Clock::time_point now{ Clock::now() };
+            bool keep = received > 0;
+            if (keep)
+            {
+                clients[i].input.append(buffer, static_cast<size_t>(received));
+                keep = takeFrames(clients[i], [&](std::string_view payload) {
+                    const uint32_t sequence = sequenceOf(payload, options.binary);
+                    Arrival& arrival = arrivals[sequence];
+                    if (arrival.received++ == 0)
+                    {
+                        arrival.first = now;
+                    }
+                    if (arrival.received == options.clients)
+                    {
+                        spreadsUs.push_back(std::chrono::duration<double, std::micro>(now - arrival.first).count());
+                        arrivals.erase(sequence);
+                    }
+                    if (i == 0)
+                    {
+                        ++events;
+                        if (!options.quiet)
+                        {
+                            printEvent(payload, options.binary);
+                            std::fflush(stdout);
+                        }
+                    }
+                });
+            }
+            if (!keep)
+            {
+                close(clients[i].fd);
+                fds[i].fd = -1;
+                clients[i].fd = -1;
+                --open;
+            }
+        }
+    }
+
+    if (open < clients.size())
+    {
+        std::fprintf(stderr, "%zu of %zu connections closed by the daemon\n", clients.size() - open, clients.size());
+    }
+    if (options.clients > 1 && !spreadsUs.empty())
+    {
+        std::sort(spreadsUs.begin(), spreadsUs.end());
+        std::fprintf(stderr, "%zu updates reached all %d clients; first-to-last spread median %.1f us, max %.1f us\n",
+                     spreadsUs.size(), options.clients, spreadsUs[spreadsUs.size() / 2], spreadsUs.back());
+    }
+    for (const Client& client : clients)
+    {
+        if (client.fd >= 0)
+        {
+            close(client.fd);
+        }
+    }
+    return 0;
+}